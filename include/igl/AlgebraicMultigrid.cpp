@@ -0,0 +1,334 @@
+// This file is part of libigl, a simple c++ geometry processing library.
+//
+// Copyright (C) 2018 Floor Verhoeven
+//
+// This Source Code Form is subject to the terms of the Mozilla Public License
+// v. 2.0. If a copy of the MPL was not distributed with this file, You can
+// obtain one at http://mozilla.org/MPL/2.0/.
+#include "AlgebraicMultigrid.h"
+#include "parallel_for.h"
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <thread>
+
+namespace igl
+{
+  namespace algebraic_multigrid_helpers
+  {
+    // Group strongly connected unknowns into aggregates (Vanek et al. 1996):
+    // first, unknowns whose strong neighbors are all free start an aggregate
+    // with them; then remaining unknowns join the aggregate of their
+    // strongest aggregated neighbor; finally leftovers form new aggregates
+    // with their free strong neighbors.
+    //
+    // Inputs:
+    //   A  n by n symmetric sparse matrix
+    //   strength  strong connection threshold
+    // Outputs:
+    //   agg  n list of aggregate indices
+    // Returns number of aggregates
+    template <typename Scalar>
+    IGL_INLINE int aggregate(
+      const Eigen::SparseMatrix<Scalar> & A,
+      const Scalar strength,
+      Eigen::VectorXi & agg)
+    {
+      typedef typename Eigen::SparseMatrix<Scalar>::InnerIterator Iter;
+      const int n = A.rows();
+      const Eigen::Matrix<Scalar,Eigen::Dynamic,1> D = A.diagonal();
+      const auto is_strong = [&](const int i,const int j,const Scalar a)
+      {
+        return i != j && a*a >= strength*strength*D(i)*D(j);
+      };
+      agg = Eigen::VectorXi::Constant(n,-1);
+      int nagg = 0;
+      for(int i = 0;i<n;i++)
+      {
+        if(agg(i) >= 0)
+        {
+          continue;
+        }
+        bool free = true;
+        for(Iter it(A,i);it && free;++it)
+        {
+          free = !is_strong(i,it.row(),it.value()) || agg(it.row()) < 0;
+        }
+        if(!free)
+        {
+          continue;
+        }
+        agg(i) = nagg;
+        for(Iter it(A,i);it;++it)
+        {
+          if(is_strong(i,it.row(),it.value()))
+          {
+            agg(it.row()) = nagg;
+          }
+        }
+        nagg++;
+      }
+      const Eigen::VectorXi agg1 = agg;
+      for(int i = 0;i<n;i++)
+      {
+        if(agg(i) >= 0)
+        {
+          continue;
+        }
+        Scalar best = 0;
+        for(Iter it(A,i);it;++it)
+        {
+          if(agg1(it.row()) >= 0 && is_strong(i,it.row(),it.value()) &&
+            std::abs(it.value()) > best)
+          {
+            best = std::abs(it.value());
+            agg(i) = agg1(it.row());
+          }
+        }
+      }
+      for(int i = 0;i<n;i++)
+      {
+        if(agg(i) >= 0)
+        {
+          continue;
+        }
+        agg(i) = nagg;
+        for(Iter it(A,i);it;++it)
+        {
+          if(agg(it.row()) < 0 && is_strong(i,it.row(),it.value()))
+          {
+            agg(it.row()) = nagg;
+          }
+        }
+        nagg++;
+      }
+      return nagg;
+    }
+
+    // Estimate the spectral radius of diag(invdiag)*A by power iteration
+    template <typename Scalar>
+    IGL_INLINE Scalar spectral_radius(
+      const Eigen::SparseMatrix<Scalar> & A,
+      const Eigen::Matrix<Scalar,Eigen::Dynamic,1> & invdiag)
+    {
+      typedef Eigen::Matrix<Scalar,Eigen::Dynamic,1> VectorXS;
+      const int n = A.rows();
+      // Deterministic pseudo-random start: a smooth start would mostly lie in
+      // the near null space and converge far too slowly
+      VectorXS v(n);
+      unsigned int seed = 1;
+      for(int i = 0;i<n;i++)
+      {
+        seed = seed*1664525u + 1013904223u;
+        v(i) = Scalar(seed>>8)/Scalar(1u<<24) - Scalar(0.5);
+      }
+      v.normalize();
+      Scalar rho = 1;
+      for(int iter = 0;iter<15;iter++)
+      {
+        const VectorXS w = invdiag.cwiseProduct(A*v);
+        rho = w.norm();
+        if(rho == 0)
+        {
+          return 1;
+        }
+        v = w/rho;
+      }
+      return rho;
+    }
+  }
+}
+
+template <typename Scalar>
+IGL_INLINE bool igl::AlgebraicMultigrid<Scalar>::precompute(
+  const SparseMatrixS & A0)
+{
+  using namespace Eigen;
+  using namespace std;
+  assert(A0.rows() == A0.cols() && "A must be square");
+  A.clear();
+  P.clear();
+  R.clear();
+  invdiag.clear();
+  A.push_back(A0);
+  A.back().makeCompressed();
+  while(true)
+  {
+    const int l = A.size()-1;
+    const int n = A[l].rows();
+    const VectorXS D = A[l].diagonal();
+    invdiag.push_back(
+      (D.array() != Scalar(0)).select(D.cwiseInverse(),Scalar(0)));
+    if(n <= coarse_size || l+1 >= max_levels)
+    {
+      break;
+    }
+    VectorXi agg;
+    const int nagg =
+      algebraic_multigrid_helpers::aggregate(A[l],strength,agg);
+    if(nagg == 0 || nagg >= n)
+    {
+      break;
+    }
+    // Tentative prolongation: orthonormal piecewise constants on aggregates
+    VectorXi count = VectorXi::Zero(nagg);
+    for(int i = 0;i<n;i++)
+    {
+      count(agg(i))++;
+    }
+    vector<Triplet<Scalar> > IJV;
+    IJV.reserve(n);
+    for(int i = 0;i<n;i++)
+    {
+      IJV.emplace_back(i,agg(i),Scalar(1)/sqrt(Scalar(count(agg(i)))));
+    }
+    SparseMatrixS T(n,nagg);
+    T.setFromTriplets(IJV.begin(),IJV.end());
+    // Smooth with one damped Jacobi step
+    const Scalar omega = Scalar(4)/
+      (Scalar(3)*algebraic_multigrid_helpers::spectral_radius(A[l],invdiag[l]));
+    const SparseMatrixS DAT = invdiag[l].asDiagonal()*(A[l]*T);
+    SparseMatrixS Pl = T - omega*DAT;
+    Pl.makeCompressed();
+    SparseMatrixS Rl = Pl.transpose();
+    SparseMatrixS Ac = (Rl*(A[l]*Pl)).pruned();
+    P.push_back(Pl);
+    R.push_back(Rl);
+    A.push_back(Ac);
+  }
+  coarse.compute(A.back());
+  m_info = coarse.info();
+  if(m_info != Success)
+  {
+    cerr<<"Error: factorization of the coarsest level failed."<<endl;
+    return false;
+  }
+  return true;
+}
+
+template <typename Scalar>
+template <typename DerivedB, typename DerivedX>
+IGL_INLINE bool igl::AlgebraicMultigrid<Scalar>::solve(
+  const Eigen::MatrixBase<DerivedB> & B,
+  Eigen::PlainObjectBase<DerivedX> & X) const
+{
+  using namespace Eigen;
+  typedef Matrix<Scalar,Dynamic,Dynamic> MatrixXS;
+  const int n = rows();
+  const int k = B.cols();
+  assert(B.rows() == n && "B must have a row per unknown");
+  MatrixXS XS = X.rows() == n && X.cols() == k ?
+    MatrixXS(X.template cast<Scalar>()) : MatrixXS::Zero(n,k);
+  std::vector<char> converged(k,0);
+  parallel_for(k,[&](const int c)
+  {
+    const VectorXS b = B.col(c).template cast<Scalar>();
+    VectorXS x = XS.col(c);
+    const Scalar nb = b.norm();
+    if(nb == 0)
+    {
+      XS.col(c).setZero();
+      converged[c] = 1;
+      return;
+    }
+    for(int iter = 0;iter<max_iter;iter++)
+    {
+      vcycle(0,b,x);
+      if((b-A[0]*x).norm() <= tolerance*nb)
+      {
+        converged[c] = 1;
+        break;
+      }
+    }
+    XS.col(c) = x;
+  },2);
+  X = XS.template cast<typename DerivedX::Scalar>();
+  return std::find(converged.begin(),converged.end(),0) == converged.end();
+}
+
+template <typename Scalar>
+IGL_INLINE double igl::AlgebraicMultigrid<Scalar>::operator_complexity() const
+{
+  if(A.empty() || A[0].nonZeros() == 0)
+  {
+    return 0;
+  }
+  double nnz = 0;
+  for(const auto & Al : A)
+  {
+    nnz += Al.nonZeros();
+  }
+  return nnz/A[0].nonZeros();
+}
+
+template <typename Scalar>
+IGL_INLINE void igl::AlgebraicMultigrid<Scalar>::vcycle(
+  const int l,
+  const VectorXS & b,
+  VectorXS & x) const
+{
+  if(l+1 == levels())
+  {
+    x = coarse.solve(b);
+    return;
+  }
+  for(int s = 0;s<smoothing_steps;s++)
+  {
+    smooth(l,b,true,x);
+    smooth(l,b,false,x);
+  }
+  const VectorXS r = b - A[l]*x;
+  VectorXS xc = VectorXS::Zero(A[l+1].rows());
+  vcycle(l+1,R[l]*r,xc);
+  x += P[l]*xc;
+  for(int s = 0;s<smoothing_steps;s++)
+  {
+    smooth(l,b,true,x);
+    smooth(l,b,false,x);
+  }
+}
+
+template <typename Scalar>
+IGL_INLINE void igl::AlgebraicMultigrid<Scalar>::smooth(
+  const int l,
+  const VectorXS & b,
+  const bool forward,
+  VectorXS & x) const
+{
+  const SparseMatrixS & Al = A[l];
+  const VectorXS & d = invdiag[l];
+  const int n = Al.rows();
+  // Rows are split into blocks swept in parallel. Within a block this is
+  // Gauss-Seidel, across blocks Jacobi (reading values from before the
+  // sweep).
+  const int nthreads = std::max(1,(int)std::thread::hardware_concurrency());
+  const int nblocks = std::max(1,std::min(nthreads,n/10000));
+  const VectorXS x0 = nblocks > 1 ? x : VectorXS();
+  parallel_for(nblocks,[&](const int block)
+  {
+    const int i0 = (long)block*n/nblocks;
+    const int i1 = (long)(block+1)*n/nblocks;
+    for(int k = 0;k<i1-i0;k++)
+    {
+      const int i = forward ? i0+k : i1-1-k;
+      Scalar s = b(i);
+      // A is symmetric, so column i holds row i
+      for(typename SparseMatrixS::InnerIterator it(Al,i);it;++it)
+      {
+        const int j = it.row();
+        if(j != i)
+        {
+          s -= it.value()*(j < i0 || j >= i1 ? x0(j) : x(j));
+        }
+      }
+      x(i) = s*d(i);
+    }
+  },2);
+}
+
+#ifdef IGL_STATIC_LIBRARY
+// Explicit template instantiation
+template class igl::AlgebraicMultigrid<double>;
+template bool igl::AlgebraicMultigrid<double>::solve<Eigen::Matrix<double, -1, -1, 0, -1, -1>, Eigen::Matrix<double, -1, -1, 0, -1, -1> >(Eigen::MatrixBase<Eigen::Matrix<double, -1, -1, 0, -1, -1> > const&, Eigen::PlainObjectBase<Eigen::Matrix<double, -1, -1, 0, -1, -1> >&) const;
+template bool igl::AlgebraicMultigrid<double>::solve<Eigen::Matrix<double, -1, 1, 0, -1, 1>, Eigen::Matrix<double, -1, 1, 0, -1, 1> >(Eigen::MatrixBase<Eigen::Matrix<double, -1, 1, 0, -1, 1> > const&, Eigen::PlainObjectBase<Eigen::Matrix<double, -1, 1, 0, -1, 1> >&) const;
+#endif
@@ -0,0 +1,153 @@
+// This file is part of libigl, a simple c++ geometry processing library.
+//
+// Copyright (C) 2018 Floor Verhoeven
+//
+// This Source Code Form is subject to the terms of the Mozilla Public License
+// v. 2.0. If a copy of the MPL was not distributed with this file, You can
+// obtain one at http://mozilla.org/MPL/2.0/.
+#ifndef IGL_ALGEBRAICMULTIGRID_H
+#define IGL_ALGEBRAICMULTIGRID_H
+#include "igl_inline.h"
+#include <Eigen/Core>
+#include <Eigen/Sparse>
+#include <vector>
+
+namespace igl
+{
+  // Smoothed aggregation algebraic multigrid for sparse symmetric positive
+  // definite systems A x = b, such as -L, M - t*L (implicit diffusion) or the
+  // unknown block of min_quad_with_fixed. Memory grows linearly with the
+  // number of nonzeros of A (there is no fill-in), so it scales to meshes
+  // whose Cholesky factorization does not fit in memory.
+  //
+  // The hierarchy is built by aggregating strongly connected unknowns of each
+  // level, smoothing the piecewise constant prolongation with one damped
+  // Jacobi step and forming the Galerkin coarse operator P'*A*P. The coarsest
+  // level is factored directly. A V-cycle smooths with symmetric (a forward
+  // then a backward) Gauss-Seidel sweeps before and after the coarse
+  // correction. Sweeps are hybrid on large levels: row blocks are swept in
+  // parallel, Gauss-Seidel within a block and Jacobi across blocks.
+  //
+  // The object can be used on its own (solve(B,X) iterates V-cycles) or as
+  // the preconditioner of Eigen's ConjugateGradient (solve(b) applies one
+  // V-cycle), which usually converges in far fewer iterations:
+  //
+  //   Eigen::ConjugateGradient<Eigen::SparseMatrix<double>,
+  //     Eigen::Lower|Eigen::Upper,igl::AlgebraicMultigrid<double> > cg;
+  //   cg.compute(M - t*L);
+  //   u = cg.solve(M*u0);
+  //
+  // Templates:
+  //   _Scalar  scalar type of the system
+  template <typename _Scalar>
+  class AlgebraicMultigrid
+  {
+    public:
+      typedef _Scalar Scalar;
+      typedef int StorageIndex;
+      enum
+      {
+        ColsAtCompileTime = Eigen::Dynamic,
+        MaxColsAtCompileTime = Eigen::Dynamic
+      };
+      typedef Eigen::SparseMatrix<Scalar> SparseMatrixS;
+      typedef Eigen::Matrix<Scalar,Eigen::Dynamic,1> VectorXS;
+      // Parameters, set before compute:
+      //   strength  off-diagonal A(i,j) is a strong connection if
+      //     |A(i,j)| >= strength*sqrt(A(i,i)*A(j,j)) {0.08}
+      //   coarse_size  levels with at most this many unknowns are factored
+      //     directly {1000}
+      //   max_levels  maximum number of levels {20}
+      //   smoothing_steps  symmetric Gauss-Seidel sweeps before and after
+      //     each coarse correction {1}
+      // Parameters of solve(B,X):
+      //   tolerance  relative residual |b-A*x|/|b| to reach {1e-8}
+      //   max_iter  maximum number of V-cycles {100}
+      Scalar strength;
+      int coarse_size;
+      int max_levels;
+      int smoothing_steps;
+      Scalar tolerance;
+      int max_iter;
+    private:
+      // Operators, inverse diagonals, prolongations and restrictions
+      // (transposed prolongations) of each level; P[l] maps level l+1 to l
+      std::vector<SparseMatrixS> A,P,R;
+      std::vector<VectorXS> invdiag;
+      // Factorization of the coarsest level
+      Eigen::SimplicialLDLT<SparseMatrixS> coarse;
+      Eigen::ComputationInfo m_info;
+    public:
+      AlgebraicMultigrid():
+        strength(0.08),
+        coarse_size(1000),
+        max_levels(20),
+        smoothing_steps(1),
+        tolerance(1e-8),
+        max_iter(100),
+        m_info(Eigen::Success)
+      {}
+      // Build the hierarchy of a symmetric positive definite matrix
+      //
+      // Inputs:
+      //   A  n by n sparse matrix
+      // Returns true on success, false if the coarsest level could not be
+      // factored
+      IGL_INLINE bool precompute(const SparseMatrixS & A);
+      // Solve A X = B by iterating V-cycles. Columns are solved in parallel.
+      //
+      // Inputs:
+      //   B  n by k right-hand sides
+      //   X  n by k initial guess (or anything else to start from zero)
+      // Outputs:
+      //   X  n by k solutions
+      // Returns true if all columns reached the tolerance within max_iter
+      // V-cycles
+      template <typename DerivedB, typename DerivedX>
+      IGL_INLINE bool solve(
+        const Eigen::MatrixBase<DerivedB> & B,
+        Eigen::PlainObjectBase<DerivedX> & X) const;
+      // Apply one V-cycle to b starting from zero (the preconditioner)
+      template <typename Rhs>
+      VectorXS solve(const Eigen::MatrixBase<Rhs> & b) const
+      {
+        VectorXS x = VectorXS::Zero(b.rows());
+        vcycle(0,VectorXS(b),x);
+        return x;
+      }
+      // Number of levels including the finest
+      int levels() const { return (int)A.size(); }
+      // Total number of nonzeros of all levels divided by the nonzeros of A
+      IGL_INLINE double operator_complexity() const;
+      Eigen::Index rows() const { return A.empty() ? 0 : A[0].rows(); }
+      Eigen::Index cols() const { return rows(); }
+      // Eigen preconditioner interface
+      template <typename MatType>
+      AlgebraicMultigrid & analyzePattern(const MatType &){ return *this; }
+      template <typename MatType>
+      AlgebraicMultigrid & factorize(const MatType & M)
+      {
+        precompute(SparseMatrixS(M));
+        return *this;
+      }
+      template <typename MatType>
+      AlgebraicMultigrid & compute(const MatType & M){ return factorize(M); }
+      Eigen::ComputationInfo info() const { return m_info; }
+    private:
+      // Improve x for A[l] x = b with one V-cycle
+      IGL_INLINE void vcycle(const int l, const VectorXS & b, VectorXS & x)
+        const;
+      // One (hybrid) Gauss-Seidel sweep on level l, forward or backward
+      IGL_INLINE void smooth(
+        const int l,
+        const VectorXS & b,
+        const bool forward,
+        VectorXS & x) const;
+  };
+}
+
+#ifndef IGL_STATIC_LIBRARY
+#  include "AlgebraicMultigrid.cpp"
+#endif
+
+#endif
@@ -0,0 +1,324 @@
+// This file is part of libigl, a simple c++ geometry processing library.
+//
+// Copyright (C) 2018 Floor Verhoeven
+//
+// This Source Code Form is subject to the terms of the Mozilla Public License
+// v. 2.0. If a copy of the MPL was not distributed with this file, You can
+// obtain one at http://mozilla.org/MPL/2.0/.
+#include "CornerTable.h"
+#include "parallel_for.h"
+#include "unique_edge_map.h"
+#include <algorithm>
+#include <cassert>
+#include <iterator>
+
+template <typename DerivedF>
+IGL_INLINE void igl::CornerTable::init(
+  const Eigen::MatrixBase<DerivedF> & F,
+  int n)
+{
+  using namespace Eigen;
+  assert((F.rows() == 0 || F.cols() == 3) && "F must contain triangles");
+  const int m = F.rows();
+  if(n < 0)
+  {
+    n = m == 0 ? 0 : int(F.maxCoeff())+1;
+  }
+  CV.resize(3*m);
+  parallel_for(m,[&](const int f)
+  {
+    for(int i = 0;i<3;i++)
+    {
+      CV(3*f+i) = F(f,i);
+    }
+  },1000);
+  // Directed edge c*m+f of unique_edge_map is the edge of corner 3*f+c
+  O.setConstant(3*m,-1);
+  if(m > 0)
+  {
+    Matrix<int,Dynamic,2> E,uE;
+    VectorXi EMAP,uEC,uEE;
+    unique_edge_map(F.template cast<int>().eval(),E,uE,EMAP,uEC,uEE);
+    parallel_for(uE.rows(),[&](const int u)
+    {
+      if(uEC(u+1)-uEC(u) != 2)
+      {
+        return;
+      }
+      const int e1 = uEE(uEC(u));
+      const int e2 = uEE(uEC(u)+1);
+      // Only link oppositely oriented half-edges
+      if(E(e1,0) != E(e2,1))
+      {
+        return;
+      }
+      const int c1 = 3*(e1%m)+e1/m;
+      const int c2 = 3*(e2%m)+e2/m;
+      O(c1) = c2;
+      O(c2) = c1;
+    },1000);
+  }
+  VC.setConstant(n,-1);
+  VD.setZero(n);
+  for(int c = 3*m-1;c >= 0;c--)
+  {
+    VC(CV(c)) = c;
+    VD(CV(c))++;
+  }
+}
+
+IGL_INLINE bool igl::CornerTable::is_boundary_vertex(const int v) const
+{
+  bool boundary = false;
+  vertex_ring(v,[&](const int c)
+  {
+    boundary = boundary || O(next(c)) < 0 || O(prev(c)) < 0;
+  });
+  return boundary;
+}
+
+IGL_INLINE bool igl::CornerTable::is_manifold_vertex(const int v) const
+{
+  int k = 0;
+  vertex_ring(v,[&](const int){ k++; });
+  return k == VD(v);
+}
+
+IGL_INLINE std::vector<int> igl::CornerTable::vertex_neighbors(
+  const int v) const
+{
+  std::vector<int> N;
+  vertex_ring(v,[&](const int c)
+  {
+    N.push_back(CV(next(c)));
+    N.push_back(CV(prev(c)));
+  });
+  std::sort(N.begin(),N.end());
+  N.erase(std::unique(N.begin(),N.end()),N.end());
+  return N;
+}
+
+IGL_INLINE bool igl::CornerTable::collapse_is_valid(const int c) const
+{
+  if(c < 0 || c >= num_corners() || is_deleted(face(c)))
+  {
+    return false;
+  }
+  const int s = CV(next(c));
+  const int d = CV(prev(c));
+  if(s == d)
+  {
+    return false;
+  }
+  // The rings below (and the corners moved by collapse) only cover one fan
+  if(!is_manifold_vertex(s) || !is_manifold_vertex(d))
+  {
+    return false;
+  }
+  const bool interior = O(c) >= 0;
+  // Collapsing an interior edge between two boundary vertices would pinch
+  // the surface
+  if(interior && is_boundary_vertex(s) && is_boundary_vertex(d))
+  {
+    return false;
+  }
+  // Vertices adjacent to both s and d must be exactly the tips of the faces
+  // incident on the edge
+  const std::vector<int> Ns = vertex_neighbors(s);
+  const std::vector<int> Nd = vertex_neighbors(d);
+  std::vector<int> common;
+  std::set_intersection(
+    Ns.begin(),Ns.end(),Nd.begin(),Nd.end(),std::back_inserter(common));
+  if((int)common.size() != (interior ? 2 : 1))
+  {
+    return false;
+  }
+  // Single tet, don't collapse
+  if(interior && Ns.size() == 3 && Nd.size() == 3)
+  {
+    return false;
+  }
+  return true;
+}
+
+IGL_INLINE bool igl::CornerTable::collapse(const int c)
+{
+  if(!collapse_is_valid(c))
+  {
+    return false;
+  }
+  const int s = CV(next(c));
+  const int d = CV(prev(c));
+  const int o = O(c);
+  // Move corners of d to s
+  std::vector<int> Cd;
+  vertex_ring(d,[&](const int cd){ Cd.push_back(cd); });
+  for(const int cd : Cd)
+  {
+    CV(cd) = s;
+  }
+  VD(s) += VD(d);
+  VD(d) = 0;
+  // Corners that may serve as corners of s and of the tips afterwards
+  std::vector<int> candidates;
+  // Remove the face of corner a: glue the two other edges of the face
+  const auto remove_face = [&](const int a)
+  {
+    const int an = O(next(a));
+    const int ap = O(prev(a));
+    if(an >= 0)
+    {
+      O(an) = ap;
+      candidates.push_back(next(an));
+      candidates.push_back(prev(an));
+    }
+    if(ap >= 0)
+    {
+      O(ap) = an;
+      candidates.push_back(next(ap));
+      candidates.push_back(prev(ap));
+    }
+    const int f = face(a);
+    for(int i = 0;i<3;i++)
+    {
+      VD(CV(3*f+i))--;
+      CV(3*f+i) = -1;
+      O(3*f+i) = -1;
+    }
+  };
+  const int x = CV(c);
+  const int y = o >= 0 ? CV(o) : -1;
+  remove_face(c);
+  if(o >= 0)
+  {
+    remove_face(o);
+  }
+  for(const int cd : Cd)
+  {
+    if(CV(cd) >= 0)
+    {
+      candidates.push_back(cd);
+    }
+  }
+  VC(d) = -1;
+  // Repair corners of vertices that pointed into the deleted faces
+  const auto repair = [&](const int v)
+  {
+    if(v < 0 || (VC(v) >= 0 && CV(VC(v)) == v))
+    {
+      return;
+    }
+    VC(v) = -1;
+    for(const int cc : candidates)
+    {
+      if(CV(cc) == v)
+      {
+        VC(v) = cc;
+        return;
+      }
+    }
+  };
+  repair(s);
+  repair(x);
+  repair(y);
+  return true;
+}
+
+IGL_INLINE bool igl::CornerTable::flip(const int c)
+{
+  if(c < 0 || c >= num_corners() || is_deleted(face(c)))
+  {
+    return false;
+  }
+  const int o = O(c);
+  if(o < 0)
+  {
+    return false;
+  }
+  // Faces (x,s,d) and (y,d,s) become (x,s,y) and (y,d,x)
+  const int n = next(c), p = prev(c);
+  const int on = next(o), op = prev(o);
+  const int x = CV(c), s = CV(n), d = CV(p), y = CV(o);
+  if(x == y || !is_manifold_vertex(x))
+  {
+    return false;
+  }
+  const std::vector<int> Nx = vertex_neighbors(x);
+  if(std::binary_search(Nx.begin(),Nx.end(),y))
+  {
+    return false;
+  }
+  const int A = O(n);
+  const int C = O(on);
+  CV(p) = y;
+  CV(op) = x;
+  VD(s)--;
+  VD(d)--;
+  VD(x)++;
+  VD(y)++;
+  O(c) = C;
+  O(o) = A;
+  O(n) = on;
+  O(on) = n;
+  if(C >= 0)
+  {
+    O(C) = c;
+  }
+  if(A >= 0)
+  {
+    O(A) = o;
+  }
+  if(VC(s) == op)
+  {
+    VC(s) = n;
+  }
+  if(VC(d) == p)
+  {
+    VC(d) = on;
+  }
+  return true;
+}
+
+template <typename DerivedF, typename DerivedJ>
+IGL_INLINE void igl::CornerTable::faces(
+  Eigen::PlainObjectBase<DerivedF> & F,
+  Eigen::PlainObjectBase<DerivedJ> & J) const
+{
+  const int m = num_faces();
+  int k = 0;
+  for(int f = 0;f<m;f++)
+  {
+    k += !is_deleted(f);
+  }
+  F.resize(k,3);
+  J.resize(k,1);
+  k = 0;
+  for(int f = 0;f<m;f++)
+  {
+    if(is_deleted(f))
+    {
+      continue;
+    }
+    for(int i = 0;i<3;i++)
+    {
+      F(k,i) = CV(3*f+i);
+    }
+    J(k++) = f;
+  }
+}
+
+template <typename DerivedF>
+IGL_INLINE void igl::CornerTable::faces(
+  Eigen::PlainObjectBase<DerivedF> & F) const
+{
+  Eigen::VectorXi J;
+  return faces(F,J);
+}
+
+#ifdef IGL_STATIC_LIBRARY
+// Explicit template instantiation
+template void igl::CornerTable::init<Eigen::Matrix<int, -1, -1, 0, -1, -1> >(Eigen::MatrixBase<Eigen::Matrix<int, -1, -1, 0, -1, -1> > const&, int);
+template void igl::CornerTable::init<Eigen::Matrix<int, -1, 3, 0, -1, 3> >(Eigen::MatrixBase<Eigen::Matrix<int, -1, 3, 0, -1, 3> > const&, int);
+template void igl::CornerTable::faces<Eigen::Matrix<int, -1, -1, 0, -1, -1>, Eigen::Matrix<int, -1, 1, 0, -1, 1> >(Eigen::PlainObjectBase<Eigen::Matrix<int, -1, -1, 0, -1, -1> >&, Eigen::PlainObjectBase<Eigen::Matrix<int, -1, 1, 0, -1, 1> >&) const;
+template void igl::CornerTable::faces<Eigen::Matrix<int, -1, -1, 0, -1, -1> >(Eigen::PlainObjectBase<Eigen::Matrix<int, -1, -1, 0, -1, -1> >&) const;
+#endif
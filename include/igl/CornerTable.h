@@ -0,0 +1,146 @@
+// This file is part of libigl, a simple c++ geometry processing library.
+//
+// Copyright (C) 2018 Floor Verhoeven
+//
+// This Source Code Form is subject to the terms of the Mozilla Public License
+// v. 2.0. If a copy of the MPL was not distributed with this file, You can
+// obtain one at http://mozilla.org/MPL/2.0/.
+#ifndef IGL_CORNERTABLE_H
+#define IGL_CORNERTABLE_H
+#include "igl_inline.h"
+#include <Eigen/Core>
+#include <vector>
+
+namespace igl
+{
+  // Compact connectivity of a triangle mesh [Rossignac 2001]: corner c = 3*f+i
+  // is the i-th corner of face f. Two integers per corner and one per vertex
+  // give constant time access to the next/previous corner of a face, the
+  // opposite corner across the edge facing a corner and the corners around a
+  // vertex. The table can be edited in place by edge collapses and flips, so
+  // it is built once and kept up to date instead of rebuilding adjacency
+  // (TT/TTi, vertex_triangle_adjacency, edge_flaps) after every change.
+  //
+  // As everywhere in libigl, the edge "of" corner c is the edge opposite c,
+  // i.e. from vertex(next(c)) to vertex(prev(c)).
+  //
+  // Edges shared by more than two faces or by two inconsistently oriented
+  // faces are treated as boundary edges.
+  //
+  // Example:
+  //   igl::CornerTable ct(F);
+  //   // Neighbors of vertex v in counter-clockwise order
+  //   ct.vertex_ring(v,[&](int c){ N.push_back(ct.vertex(ct.next(c))); });
+  class CornerTable
+  {
+    public:
+      // Vertex of each corner (-1 for deleted faces)
+      Eigen::VectorXi CV;
+      // Opposite corner of each corner (-1 across boundary edges)
+      Eigen::VectorXi O;
+      // Some corner of each vertex (-1 for unreferenced vertices)
+      Eigen::VectorXi VC;
+      // Number of corners of each vertex
+      Eigen::VectorXi VD;
+    public:
+      CornerTable(){}
+      template <typename DerivedF>
+      CornerTable(const Eigen::MatrixBase<DerivedF> & F){ init(F); }
+      // Build the table (in parallel)
+      //
+      // Inputs:
+      //   F  #F by 3 list of triangle indices
+      //   n  number of vertices (at least max(F)+1) {max(F)+1}
+      template <typename DerivedF>
+      IGL_INLINE void init(const Eigen::MatrixBase<DerivedF> & F, int n = -1);
+      int num_corners() const { return (int)CV.size(); }
+      int num_faces() const { return num_corners()/3; }
+      int num_vertices() const { return (int)VC.size(); }
+      static int face(const int c){ return c/3; }
+      static int next(const int c){ return c%3 == 2 ? c-2 : c+1; }
+      static int prev(const int c){ return c%3 == 0 ? c+2 : c-1; }
+      int vertex(const int c) const { return CV(c); }
+      int opposite(const int c) const { return O(c); }
+      // Whether the edge of corner c is on the boundary
+      bool is_boundary(const int c) const { return O(c) < 0; }
+      // Whether face f was removed by a collapse
+      bool is_deleted(const int f) const { return CV(3*f) < 0; }
+      // Next corner counter-clockwise around vertex(c) (-1 at the boundary)
+      int swing(const int c) const
+      {
+        const int o = O(prev(c));
+        return o < 0 ? -1 : prev(o);
+      }
+      // Next corner clockwise around vertex(c) (-1 at the boundary)
+      int unswing(const int c) const
+      {
+        const int o = O(next(c));
+        return o < 0 ? -1 : next(o);
+      }
+      // Call func(c) for every corner c around vertex v in counter-clockwise
+      // order. For boundary vertices the first corner follows the boundary
+      // edge entering v, vertex(prev(first)) --> v, and the last precedes the
+      // boundary edge leaving v, v --> vertex(next(last)). Only the fan of
+      // VC(v) is visited around non-manifold vertices.
+      template <typename Func>
+      void vertex_ring(const int v, const Func & func) const
+      {
+        const int c0 = VC(v);
+        if(c0 < 0)
+        {
+          return;
+        }
+        int start = c0;
+        for(int c = unswing(c0);c >= 0 && c != c0;c = unswing(c))
+        {
+          start = c;
+        }
+        int c = start;
+        do
+        {
+          func(c);
+          c = swing(c);
+        }while(c >= 0 && c != start);
+      }
+      // Whether vertex v is on the boundary
+      IGL_INLINE bool is_boundary_vertex(const int v) const;
+      // Whether all corners of vertex v form a single fan, i.e. vertex_ring
+      // visits all of them
+      IGL_INLINE bool is_manifold_vertex(const int v) const;
+      // Sorted list of vertices sharing an edge with vertex v
+      IGL_INLINE std::vector<int> vertex_neighbors(const int v) const;
+      // Whether collapsing the edge of corner c keeps the mesh manifold (link
+      // condition). Edges with a non-manifold endpoint are never collapsed.
+      IGL_INLINE bool collapse_is_valid(const int c) const;
+      // Collapse the edge of corner c: vertex(prev(c)) is merged into
+      // vertex(next(c)), which is kept, and the (one or two) faces incident on
+      // the edge are deleted. Deleted faces keep their slots (see is_deleted
+      // and faces).
+      //
+      // Returns true if the edge was collapsed, false if not valid
+      IGL_INLINE bool collapse(const int c);
+      // Flip the (interior) edge of corner c to connect vertex(c) and
+      // vertex(opposite(c)). The two faces keep their indices.
+      //
+      // Returns true if the edge was flipped, false if it is on the boundary,
+      // the flipped edge already exists or vertex(c) is non-manifold
+      IGL_INLINE bool flip(const int c);
+      // Output the faces of the table, skipping deleted ones
+      //
+      // Outputs:
+      //   F  #F by 3 list of triangle indices
+      //   J  #F list of indices into the faces of the table
+      template <typename DerivedF, typename DerivedJ>
+      IGL_INLINE void faces(
+        Eigen::PlainObjectBase<DerivedF> & F,
+        Eigen::PlainObjectBase<DerivedJ> & J) const;
+      template <typename DerivedF>
+      IGL_INLINE void faces(Eigen::PlainObjectBase<DerivedF> & F) const;
+  };
+}
+
+#ifndef IGL_STATIC_LIBRARY
+#  include "CornerTable.cpp"
+#endif
+
+#endif
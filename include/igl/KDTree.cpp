@@ -0,0 +1,414 @@
+// This file is part of libigl, a simple c++ geometry processing library.
+//
+// Copyright (C) 2018 Floor Verhoeven
+//
+// This Source Code Form is subject to the terms of the Mozilla Public License
+// v. 2.0. If a copy of the MPL was not distributed with this file, You can
+// obtain one at http://mozilla.org/MPL/2.0/.
+#include "KDTree.h"
+#include "parallel_for.h"
+#include <algorithm>
+#include <cassert>
+#include <limits>
+
+template <typename Scalar, int DIM>
+template <typename DerivedP>
+IGL_INLINE void igl::KDTree<Scalar,DIM>::init(
+  const Eigen::MatrixBase<DerivedP> & _P,
+  const int leaf_size)
+{
+  assert(_P.cols() == DIM && "P must have DIM columns");
+  assert(leaf_size > 0 && "leaf_size must be positive");
+  const int n = _P.rows();
+  // Smallest depth such that every leaf has at most leaf_size points
+  depth = 0;
+  while(((long)n + (1l<<depth) - 1)/(1l<<depth) > leaf_size)
+  {
+    depth++;
+  }
+  // Points are partitioned together with their index so that nth_element
+  // moves contiguous records rather than chasing indices
+  struct Entry
+  {
+    Scalar p[DIM];
+    int i;
+  };
+  std::vector<Entry> E(n);
+  parallel_for(n,[&](const int i)
+  {
+    for(int d = 0;d<DIM;d++)
+    {
+      E[i].p[d] = Scalar(_P(i,d));
+    }
+    E[i].i = i;
+  },10000);
+  const int num_internal = (1<<depth)-1;
+  split.resize(num_internal);
+  split_dim.resize(num_internal);
+  // Point ranges of the nodes of the current level: node k of the level holds
+  // E[B[k]] ... E[B[k+1]-1]
+  std::vector<int> B = {0,n};
+  for(int level = 0;level<depth;level++)
+  {
+    const int num_level = 1<<level;
+    std::vector<int> NB(2*num_level+1);
+    NB[2*num_level] = n;
+    parallel_for(num_level,[&](const int k)
+    {
+      const int begin = B[k];
+      const int end = B[k+1];
+      const int mid = begin + (end-begin)/2;
+      const int node = num_level-1+k;
+      // Split the longest side of the bounding box at the median
+      Scalar lo[DIM],hi[DIM];
+      for(int d = 0;d<DIM;d++)
+      {
+        lo[d] = hi[d] = E[begin].p[d];
+      }
+      for(int j = begin+1;j<end;j++)
+      {
+        for(int d = 0;d<DIM;d++)
+        {
+          lo[d] = std::min(lo[d],E[j].p[d]);
+          hi[d] = std::max(hi[d],E[j].p[d]);
+        }
+      }
+      int dim = 0;
+      for(int d = 1;d<DIM;d++)
+      {
+        if(hi[d]-lo[d] > hi[dim]-lo[dim])
+        {
+          dim = d;
+        }
+      }
+      std::nth_element(
+        E.begin()+begin,E.begin()+mid,E.begin()+end,
+        [dim](const Entry & a, const Entry & b){ return a.p[dim] < b.p[dim]; });
+      split[node] = E[mid].p[dim];
+      split_dim[node] = (unsigned char)dim;
+      NB[2*k] = begin;
+      NB[2*k+1] = mid;
+    },2);
+    B.swap(NB);
+  }
+  P.resize(n,DIM);
+  I.resize(n);
+  parallel_for(n,[&](const int j)
+  {
+    for(int d = 0;d<DIM;d++)
+    {
+      P(j,d) = E[j].p[d];
+    }
+    I(j) = E[j].i;
+  },10000);
+}
+
+template <typename Scalar, int DIM>
+IGL_INLINE Scalar igl::KDTree<Scalar,DIM>::squared_radius(const Scalar r)
+{
+  typedef std::numeric_limits<Scalar> Limits;
+  if(r > 0 && r > Limits::max()/r)
+  {
+    return Limits::has_infinity ? Limits::infinity() : Limits::max();
+  }
+  return r*r;
+}
+
+template <typename Scalar, int DIM>
+IGL_INLINE void igl::KDTree<Scalar,DIM>::knn_helper(
+  const RowVectorDIMS & q,
+  const int k,
+  const Scalar r2,
+  const int node,
+  const int level,
+  const int begin,
+  const int end,
+  Scalar * off,
+  const Scalar rd,
+  std::vector<std::pair<Scalar,int> > & best) const
+{
+  if(level == depth)
+  {
+    for(int j = begin;j<end;j++)
+    {
+      const Scalar d = (P.row(j)-q).squaredNorm();
+      if(d > r2)
+      {
+        continue;
+      }
+      const std::pair<Scalar,int> c(d,I(j));
+      if((int)best.size() == k)
+      {
+        if(!(c < best.back()))
+        {
+          continue;
+        }
+        best.pop_back();
+      }
+      best.insert(std::upper_bound(best.begin(),best.end(),c),c);
+    }
+    return;
+  }
+  const int dim = split_dim[node];
+  const Scalar diff = q(dim) - split[node];
+  const int mid = begin + (end-begin)/2;
+  // Visit the child containing q first
+  if(diff < 0)
+  {
+    knn_helper(q,k,r2,2*node+1,level+1,begin,mid,off,rd,best);
+  }else
+  {
+    knn_helper(q,k,r2,2*node+2,level+1,mid,end,off,rd,best);
+  }
+  const Scalar old = off[dim];
+  const Scalar far_rd = rd - old*old + diff*diff;
+  if(far_rd > r2 || ((int)best.size() == k && far_rd > best.back().first))
+  {
+    return;
+  }
+  off[dim] = diff;
+  if(diff < 0)
+  {
+    knn_helper(q,k,r2,2*node+2,level+1,mid,end,off,far_rd,best);
+  }else
+  {
+    knn_helper(q,k,r2,2*node+1,level+1,begin,mid,off,far_rd,best);
+  }
+  off[dim] = old;
+}
+
+template <typename Scalar, int DIM>
+IGL_INLINE void igl::KDTree<Scalar,DIM>::radius_helper(
+  const RowVectorDIMS & q,
+  const Scalar r2,
+  const int node,
+  const int level,
+  const int begin,
+  const int end,
+  Scalar * off,
+  const Scalar rd,
+  std::vector<std::pair<Scalar,int> > & found) const
+{
+  if(level == depth)
+  {
+    for(int j = begin;j<end;j++)
+    {
+      const Scalar d = (P.row(j)-q).squaredNorm();
+      if(d <= r2)
+      {
+        found.emplace_back(d,I(j));
+      }
+    }
+    return;
+  }
+  const int dim = split_dim[node];
+  const Scalar diff = q(dim) - split[node];
+  const int mid = begin + (end-begin)/2;
+  const Scalar old = off[dim];
+  const Scalar far_rd = rd - old*old + diff*diff;
+  if(diff < 0)
+  {
+    radius_helper(q,r2,2*node+1,level+1,begin,mid,off,rd,found);
+  }else
+  {
+    radius_helper(q,r2,2*node+2,level+1,mid,end,off,rd,found);
+  }
+  if(far_rd > r2)
+  {
+    return;
+  }
+  off[dim] = diff;
+  if(diff < 0)
+  {
+    radius_helper(q,r2,2*node+2,level+1,mid,end,off,far_rd,found);
+  }else
+  {
+    radius_helper(q,r2,2*node+1,level+1,begin,mid,off,far_rd,found);
+  }
+  off[dim] = old;
+}
+
+template <typename Scalar, int DIM>
+IGL_INLINE void igl::KDTree<Scalar,DIM>::knn(
+  const RowVectorDIMS & q,
+  const int k,
+  const Scalar r,
+  std::vector<int> & NI,
+  std::vector<Scalar> & sqrD) const
+{
+  std::vector<std::pair<Scalar,int> > best;
+  best.reserve(k+1);
+  if(k > 0 && num_points() > 0)
+  {
+    Scalar off[DIM] = {0};
+    knn_helper(q,k,squared_radius(r),0,0,0,num_points(),off,0,best);
+  }
+  NI.resize(best.size());
+  sqrD.resize(best.size());
+  for(int i = 0;i<(int)best.size();i++)
+  {
+    sqrD[i] = best[i].first;
+    NI[i] = best[i].second;
+  }
+}
+
+template <typename Scalar, int DIM>
+IGL_INLINE void igl::KDTree<Scalar,DIM>::radius(
+  const RowVectorDIMS & q,
+  const Scalar r,
+  std::vector<int> & NI,
+  std::vector<Scalar> & sqrD) const
+{
+  std::vector<std::pair<Scalar,int> > found;
+  if(num_points() > 0)
+  {
+    Scalar off[DIM] = {0};
+    radius_helper(q,squared_radius(r),0,0,0,num_points(),off,0,found);
+  }
+  std::sort(found.begin(),found.end());
+  NI.resize(found.size());
+  sqrD.resize(found.size());
+  for(int i = 0;i<(int)found.size();i++)
+  {
+    sqrD[i] = found[i].first;
+    NI[i] = found[i].second;
+  }
+}
+
+template <typename Scalar, int DIM>
+template <typename DerivedQ, typename DerivedNI, typename DerivedsqrD>
+IGL_INLINE void igl::KDTree<Scalar,DIM>::knn(
+  const Eigen::MatrixBase<DerivedQ> & Q,
+  const int k,
+  Eigen::PlainObjectBase<DerivedNI> & NI,
+  Eigen::PlainObjectBase<DerivedsqrD> & sqrD) const
+{
+  return ball(Q,std::numeric_limits<Scalar>::max(),k,NI,sqrD);
+}
+
+template <typename Scalar, int DIM>
+template <typename DerivedQ, typename DerivedNI, typename DerivedsqrD>
+IGL_INLINE void igl::KDTree<Scalar,DIM>::ball(
+  const Eigen::MatrixBase<DerivedQ> & Q,
+  const Scalar r,
+  const int k,
+  Eigen::PlainObjectBase<DerivedNI> & NI,
+  Eigen::PlainObjectBase<DerivedsqrD> & sqrD) const
+{
+  typedef typename DerivedsqrD::Scalar ScalarD;
+  assert(Q.cols() == DIM && "Q must have DIM columns");
+  const int m = Q.rows();
+  NI.setConstant(m,k,-1);
+  sqrD.setConstant(m,k,
+    std::numeric_limits<ScalarD>::has_infinity ?
+      std::numeric_limits<ScalarD>::infinity() :
+      std::numeric_limits<ScalarD>::max());
+  if(k <= 0 || num_points() == 0)
+  {
+    return;
+  }
+  const Scalar r2 = squared_radius(r);
+  // Candidate lists of each thread
+  std::vector<std::vector<std::pair<Scalar,int> > > S;
+  parallel_for(
+    m,
+    [&](const size_t nt)
+    {
+      S.resize(nt);
+      for(auto & best : S)
+      {
+        best.reserve(k+1);
+      }
+    },
+    [&](const int i, const size_t t)
+    {
+      std::vector<std::pair<Scalar,int> > & best = S[t];
+      best.clear();
+      const RowVectorDIMS q = Q.row(i).template cast<Scalar>();
+      Scalar off[DIM] = {0};
+      knn_helper(q,k,r2,0,0,0,num_points(),off,0,best);
+      for(int c = 0;c<(int)best.size();c++)
+      {
+        sqrD(i,c) = ScalarD(best[c].first);
+        NI(i,c) = best[c].second;
+      }
+    },
+    [](const size_t){},
+    1000);
+}
+
+template <typename Scalar, int DIM>
+template <
+  typename DerivedQ,
+  typename DerivedNI,
+  typename DerivedsqrD,
+  typename DerivedNS>
+IGL_INLINE void igl::KDTree<Scalar,DIM>::radius(
+  const Eigen::MatrixBase<DerivedQ> & Q,
+  const Scalar r,
+  Eigen::PlainObjectBase<DerivedNI> & NI,
+  Eigen::PlainObjectBase<DerivedsqrD> & sqrD,
+  Eigen::PlainObjectBase<DerivedNS> & NS) const
+{
+  assert(Q.cols() == DIM && "Q must have DIM columns");
+  const int m = Q.rows();
+  const Scalar r2 = squared_radius(r);
+  // Each thread appends the (sorted) neighbours of its queries to its own
+  // list; T and O record the thread and the offset of each query's
+  // neighbours, NS their count
+  std::vector<std::vector<std::pair<Scalar,int> > > S;
+  std::vector<int> T(m),O(m);
+  NS.resize(m+1);
+  parallel_for(
+    m,
+    [&](const size_t nt){ S.resize(nt); },
+    [&](const int i, const size_t t)
+    {
+      std::vector<std::pair<Scalar,int> > & found = S[t];
+      const int o = found.size();
+      if(num_points() > 0)
+      {
+        const RowVectorDIMS q = Q.row(i).template cast<Scalar>();
+        Scalar off[DIM] = {0};
+        radius_helper(q,r2,0,0,0,num_points(),off,0,found);
+      }
+      std::sort(found.begin()+o,found.end());
+      T[i] = t;
+      O[i] = o;
+      NS(i+1) = found.size()-o;
+    },
+    [](const size_t){},
+    1000);
+  NS(0) = 0;
+  for(int i = 0;i<m;i++)
+  {
+    NS(i+1) += NS(i);
+  }
+  NI.resize(NS(m),1);
+  sqrD.resize(NS(m),1);
+  parallel_for(m,[&](const int i)
+  {
+    const std::vector<std::pair<Scalar,int> > & found = S[T[i]];
+    for(int c = 0;c<NS(i+1)-NS(i);c++)
+    {
+      sqrD(NS(i)+c) = found[O[i]+c].first;
+      NI(NS(i)+c) = found[O[i]+c].second;
+    }
+  },1000);
+}
+
+#ifdef IGL_STATIC_LIBRARY
+// Explicit template instantiation
+template class igl::KDTree<double, 3>;
+template class igl::KDTree<double, 2>;
+template class igl::KDTree<float, 3>;
+template void igl::KDTree<double, 3>::init<Eigen::Matrix<double, -1, -1, 0, -1, -1> >(Eigen::MatrixBase<Eigen::Matrix<double, -1, -1, 0, -1, -1> > const&, int);
+template void igl::KDTree<double, 3>::init<Eigen::Matrix<double, -1, 3, 0, -1, 3> >(Eigen::MatrixBase<Eigen::Matrix<double, -1, 3, 0, -1, 3> > const&, int);
+template void igl::KDTree<double, 2>::init<Eigen::Matrix<double, -1, -1, 0, -1, -1> >(Eigen::MatrixBase<Eigen::Matrix<double, -1, -1, 0, -1, -1> > const&, int);
+template void igl::KDTree<float, 3>::init<Eigen::Matrix<float, -1, -1, 0, -1, -1> >(Eigen::MatrixBase<Eigen::Matrix<float, -1, -1, 0, -1, -1> > const&, int);
+template void igl::KDTree<double, 3>::knn<Eigen::Matrix<double, -1, -1, 0, -1, -1>, Eigen::Matrix<int, -1, -1, 0, -1, -1>, Eigen::Matrix<double, -1, -1, 0, -1, -1> >(Eigen::MatrixBase<Eigen::Matrix<double, -1, -1, 0, -1, -1> > const&, int, Eigen::PlainObjectBase<Eigen::Matrix<int, -1, -1, 0, -1, -1> >&, Eigen::PlainObjectBase<Eigen::Matrix<double, -1, -1, 0, -1, -1> >&) const;
+template void igl::KDTree<double, 2>::knn<Eigen::Matrix<double, -1, -1, 0, -1, -1>, Eigen::Matrix<int, -1, -1, 0, -1, -1>, Eigen::Matrix<double, -1, -1, 0, -1, -1> >(Eigen::MatrixBase<Eigen::Matrix<double, -1, -1, 0, -1, -1> > const&, int, Eigen::PlainObjectBase<Eigen::Matrix<int, -1, -1, 0, -1, -1> >&, Eigen::PlainObjectBase<Eigen::Matrix<double, -1, -1, 0, -1, -1> >&) const;
+template void igl::KDTree<float, 3>::knn<Eigen::Matrix<float, -1, -1, 0, -1, -1>, Eigen::Matrix<int, -1, -1, 0, -1, -1>, Eigen::Matrix<float, -1, -1, 0, -1, -1> >(Eigen::MatrixBase<Eigen::Matrix<float, -1, -1, 0, -1, -1> > const&, int, Eigen::PlainObjectBase<Eigen::Matrix<int, -1, -1, 0, -1, -1> >&, Eigen::PlainObjectBase<Eigen::Matrix<float, -1, -1, 0, -1, -1> >&) const;
+template void igl::KDTree<double, 3>::ball<Eigen::Matrix<double, -1, -1, 0, -1, -1>, Eigen::Matrix<int, -1, -1, 0, -1, -1>, Eigen::Matrix<double, -1, -1, 0, -1, -1> >(Eigen::MatrixBase<Eigen::Matrix<double, -1, -1, 0, -1, -1> > const&, double, int, Eigen::PlainObjectBase<Eigen::Matrix<int, -1, -1, 0, -1, -1> >&, Eigen::PlainObjectBase<Eigen::Matrix<double, -1, -1, 0, -1, -1> >&) const;
+template void igl::KDTree<double, 3>::radius<Eigen::Matrix<double, -1, -1, 0, -1, -1>, Eigen::Matrix<int, -1, 1, 0, -1, 1>, Eigen::Matrix<double, -1, 1, 0, -1, 1>, Eigen::Matrix<int, -1, 1, 0, -1, 1> >(Eigen::MatrixBase<Eigen::Matrix<double, -1, -1, 0, -1, -1> > const&, double, Eigen::PlainObjectBase<Eigen::Matrix<int, -1, 1, 0, -1, 1> >&, Eigen::PlainObjectBase<Eigen::Matrix<double, -1, 1, 0, -1, 1> >&, Eigen::PlainObjectBase<Eigen::Matrix<int, -1, 1, 0, -1, 1> >&) const;
+#endif
@@ -0,0 +1,192 @@
+// This file is part of libigl, a simple c++ geometry processing library.
+//
+// Copyright (C) 2018 Floor Verhoeven
+//
+// This Source Code Form is subject to the terms of the Mozilla Public License
+// v. 2.0. If a copy of the MPL was not distributed with this file, You can
+// obtain one at http://mozilla.org/MPL/2.0/.
+#ifndef IGL_KDTREE_H
+#define IGL_KDTREE_H
+#include "igl_inline.h"
+#include <Eigen/Core>
+#include <utility>
+#include <vector>
+
+namespace igl
+{
+  // Balanced kd-tree over a set of points for k-nearest-neighbour, ball and
+  // radius queries (e.g. point clouds, snapping, normal estimation).
+  //
+  // Unlike AABB the tree keeps its own copy of the points, reordered so that
+  // the points of each leaf are contiguous, and stores no pointers: the tree
+  // is implicit (node i has children 2i+1 and 2i+2, the point range of each
+  // node is halved at each level) and only the split dimension and value of
+  // each internal node are stored. The levels are built in parallel and the
+  // batch queries are answered in parallel.
+  //
+  // Distances are squared Euclidean distances. Neighbours are sorted by
+  // increasing distance, ties by increasing index, so the nearest neighbour
+  // is the same as found by brute force (see snap_points).
+  //
+  // Example:
+  //   igl::KDTree<double,3> tree(P);
+  //   Eigen::MatrixXi I;
+  //   Eigen::MatrixXd sqrD;
+  //   // 8 nearest neighbours of each point (including itself)
+  //   tree.knn(P,8,I,sqrD);
+  template <typename Scalar, int DIM>
+  class KDTree
+  {
+    public:
+      typedef Eigen::Matrix<Scalar,1,DIM> RowVectorDIMS;
+      // #P by DIM list of points in leaf order
+      Eigen::Matrix<Scalar,Eigen::Dynamic,DIM,Eigen::RowMajor> P;
+      // #P list of indices into the input points: P.row(j) is input point I(j)
+      Eigen::VectorXi I;
+      // Split value and dimension of each internal node: points of the left
+      // child have P(j,split_dim[i]) <= split[i], those of the right child >=
+      std::vector<Scalar> split;
+      std::vector<unsigned char> split_dim;
+      // Number of levels of internal nodes (the leaves are at this depth)
+      int depth;
+    public:
+      KDTree():depth(0){}
+      template <typename DerivedP>
+      KDTree(const Eigen::MatrixBase<DerivedP> & P, const int leaf_size = 16)
+      {
+        init(P,leaf_size);
+      }
+      // Build the tree (in parallel)
+      //
+      // Inputs:
+      //   P  #P by DIM list of points
+      //   leaf_size  maximum number of points per leaf {16}
+      template <typename DerivedP>
+      IGL_INLINE void init(
+        const Eigen::MatrixBase<DerivedP> & P,
+        const int leaf_size = 16);
+      int num_points() const { return (int)P.rows(); }
+      // Nearest neighbours of a single query point
+      //
+      // Inputs:
+      //   q  query point
+      //   k  maximum number of neighbours
+      //   r  only consider points within distance r (not squared) of q
+      //     (std::numeric_limits<Scalar>::max() for no limit)
+      // Outputs:
+      //   NI  list of up to k indices into the input points, by increasing
+      //     distance
+      //   sqrD  list of squared distances of NI to q
+      IGL_INLINE void knn(
+        const RowVectorDIMS & q,
+        const int k,
+        const Scalar r,
+        std::vector<int> & NI,
+        std::vector<Scalar> & sqrD) const;
+      // All points within distance r (not squared) of a single query point
+      //
+      // Inputs:
+      //   q  query point
+      //   r  radius
+      // Outputs:
+      //   NI  list of indices into the input points, by increasing distance
+      //   sqrD  list of squared distances of NI to q
+      IGL_INLINE void radius(
+        const RowVectorDIMS & q,
+        const Scalar r,
+        std::vector<int> & NI,
+        std::vector<Scalar> & sqrD) const;
+      // k nearest neighbours of each query point (in parallel)
+      //
+      // Inputs:
+      //   Q  #Q by DIM list of query points
+      //   k  number of neighbours
+      // Outputs:
+      //   NI  #Q by k list of indices into the input points, by increasing
+      //     distance (-1 if there are less than k points)
+      //   sqrD  #Q by k list of squared distances (infinity, or the largest
+      //     value for integer types, where NI is -1)
+      template <typename DerivedQ, typename DerivedNI, typename DerivedsqrD>
+      IGL_INLINE void knn(
+        const Eigen::MatrixBase<DerivedQ> & Q,
+        const int k,
+        Eigen::PlainObjectBase<DerivedNI> & NI,
+        Eigen::PlainObjectBase<DerivedsqrD> & sqrD) const;
+      // Up to k nearest neighbours within distance r of each query point (in
+      // parallel), i.e. knn limited to a ball
+      //
+      // Inputs:
+      //   Q  #Q by DIM list of query points
+      //   r  radius of the ball (not squared)
+      //   k  maximum number of neighbours
+      // Outputs:
+      //   NI  #Q by k list of indices into the input points, by increasing
+      //     distance (-1 past the last point in the ball)
+      //   sqrD  #Q by k list of squared distances (infinity, or the largest
+      //     value for integer types, where NI is -1)
+      template <typename DerivedQ, typename DerivedNI, typename DerivedsqrD>
+      IGL_INLINE void ball(
+        const Eigen::MatrixBase<DerivedQ> & Q,
+        const Scalar r,
+        const int k,
+        Eigen::PlainObjectBase<DerivedNI> & NI,
+        Eigen::PlainObjectBase<DerivedsqrD> & sqrD) const;
+      // All points within distance r of each query point (in parallel)
+      //
+      // Inputs:
+      //   Q  #Q by DIM list of query points
+      //   r  radius (not squared)
+      // Outputs:
+      //   NI  list of indices into the input points: those within r of query
+      //     q are NI(NS(q)) ... NI(NS(q+1)-1), by increasing distance
+      //   sqrD  list of squared distances of NI to their query point
+      //   NS  #Q+1 list of offsets into NI
+      template <
+        typename DerivedQ,
+        typename DerivedNI,
+        typename DerivedsqrD,
+        typename DerivedNS>
+      IGL_INLINE void radius(
+        const Eigen::MatrixBase<DerivedQ> & Q,
+        const Scalar r,
+        Eigen::PlainObjectBase<DerivedNI> & NI,
+        Eigen::PlainObjectBase<DerivedsqrD> & sqrD,
+        Eigen::PlainObjectBase<DerivedNS> & NS) const;
+    private:
+      // r*r, saturated at infinity (or the largest value for integer types)
+      // so that huge radii, e.g. std::numeric_limits<Scalar>::max(), mean no
+      // limit instead of overflowing
+      IGL_INLINE static Scalar squared_radius(const Scalar r);
+      // Neighbours are (squared distance, input index) pairs, compared
+      // lexicographically. off holds the offset of q from the cell of node
+      // in each dimension and rd is the squared norm of off, a lower bound
+      // on the distance to any point of node.
+      IGL_INLINE void knn_helper(
+        const RowVectorDIMS & q,
+        const int k,
+        const Scalar r2,
+        const int node,
+        const int level,
+        const int begin,
+        const int end,
+        Scalar * off,
+        const Scalar rd,
+        std::vector<std::pair<Scalar,int> > & best) const;
+      IGL_INLINE void radius_helper(
+        const RowVectorDIMS & q,
+        const Scalar r2,
+        const int node,
+        const int level,
+        const int begin,
+        const int end,
+        Scalar * off,
+        const Scalar rd,
+        std::vector<std::pair<Scalar,int> > & found) const;
+  };
+}
+
+#ifndef IGL_STATIC_LIBRARY
+#  include "KDTree.cpp"
+#endif
+
+#endif
@@ -0,0 +1,329 @@
+// This file is part of libigl, a simple c++ geometry processing library.
+//
+// Copyright (C) 2018 Floor Verhoeven
+//
+// This Source Code Form is subject to the terms of the Mozilla Public License
+// v. 2.0. If a copy of the MPL was not distributed with this file, You can
+// obtain one at http://mozilla.org/MPL/2.0/.
+#include "MatrixFreeLaplacian.h"
+#include "cotmatrix_entries.h"
+#include "massmatrix_entries.h"
+#include "parallel_for.h"
+#include <Eigen/Geometry>
+#include <algorithm>
+#include <cstdint>
+#include <thread>
+
+namespace igl
+{
+  namespace matrix_free_laplacian_helpers
+  {
+    // Local edges of each element type, in the order of cotmatrix_entries
+    static const int tri_edges[3][2] = {{1,2},{2,0},{0,1}};
+    static const int tet_edges[6][2] = {{1,2},{2,0},{0,1},{3,0},{3,1},{3,2}};
+    inline const int (*edges(const int simplex_size))[2]
+    {
+      return simplex_size == 3 ? tri_edges : tet_edges;
+    }
+  }
+}
+
+template <typename Scalar>
+template <typename DerivedV, typename DerivedF>
+IGL_INLINE void igl::MatrixFreeLaplacian<Scalar>::init(
+  const Eigen::MatrixBase<DerivedV> & V,
+  const Eigen::MatrixBase<DerivedF> & _F,
+  const MassMatrixType type)
+{
+  using namespace Eigen;
+  using namespace std;
+  assert((_F.cols() == 3 || _F.cols() == 4) && "F must be triangles or tets");
+  n = V.rows();
+  const int m = _F.rows();
+  const int ss = _F.cols();
+  F = _F.template cast<int>();
+
+  // Sum the cotangents of each element edge into unique undirected edges
+  Matrix<Scalar,Dynamic,Dynamic> C;
+  cotmatrix_entries(V,F,C);
+  const int ne = C.cols();
+  const auto edges = matrix_free_laplacian_helpers::edges(ss);
+  struct WeightedEdge
+  {
+    int s,d;
+    Scalar w;
+    bool operator<(const WeightedEdge & that) const
+    {
+      return s < that.s || (s == that.s && d < that.d);
+    }
+  };
+  vector<WeightedEdge> all(ne*m);
+  parallel_for(m,[&](const int f)
+  {
+    for(int e = 0;e<ne;e++)
+    {
+      const int s = F(f,edges[e][0]);
+      const int d = F(f,edges[e][1]);
+      all[f*ne+e] = {min(s,d),max(s,d),C(f,e)};
+    }
+  },1000);
+  Matrix<Scalar,Dynamic,Dynamic>().swap(C);
+  sort(all.begin(),all.end());
+  int num_edges = 0;
+  for(int i = 0;i<(int)all.size();i++)
+  {
+    if(num_edges > 0 &&
+      all[num_edges-1].s == all[i].s && all[num_edges-1].d == all[i].d)
+    {
+      all[num_edges-1].w += all[i].w;
+    }else
+    {
+      all[num_edges++] = all[i];
+    }
+  }
+  all.resize(num_edges);
+
+  // Cut the sorted edges (which share vertices with their neighbors) into
+  // blocks and greedily color the blocks: each vertex remembers the colors of
+  // the blocks touching it so far. Fewer, larger blocks need fewer colors
+  // (i.e. fewer parallel passes), so aim for a few blocks per thread.
+  const int nthreads = max((int)thread::hardware_concurrency(),1);
+  const int block_size = max(4096,num_edges/(16*nthreads)+1);
+  const int num_blocks = (num_edges+block_size-1)/block_size;
+  const int max_colors = 64;
+  vector<uint64_t> used(n,0);
+  VectorXi color(num_blocks);
+  vector<int> count(max_colors+1,0);
+  for(int b = 0;b<num_blocks;b++)
+  {
+    const int end = min(num_edges,(b+1)*block_size);
+    uint64_t taken = 0;
+    for(int e = b*block_size;e<end;e++)
+    {
+      taken |= used[all[e].s] | used[all[e].d];
+    }
+    int k = 0;
+    while(k<max_colors && (taken>>k)&1)
+    {
+      k++;
+    }
+    if(k<max_colors)
+    {
+      for(int e = b*block_size;e<end;e++)
+      {
+        used[all[e].s] |= uint64_t(1)<<k;
+        used[all[e].d] |= uint64_t(1)<<k;
+      }
+    }
+    color(b) = k;
+    count[k]++;
+  }
+  vector<uint64_t>().swap(used);
+  // Drop unused colors (keeping the serial remainder last)
+  color_offsets.assign(1,0);
+  vector<int> slot(max_colors+1,-1);
+  for(int k = 0;k<=max_colors;k++)
+  {
+    if(count[k] > 0 || k == max_colors)
+    {
+      slot[k] = color_offsets.size()-1;
+      color_offsets.push_back(color_offsets.back()+count[k]);
+    }
+  }
+  // Stable sort of the blocks by color
+  vector<int> fill(color_offsets.begin(),color_offsets.end()-1);
+  vector<int> order(num_blocks);
+  for(int b = 0;b<num_blocks;b++)
+  {
+    order[fill[slot[color(b)]]++] = b;
+  }
+  block_offsets.resize(num_blocks+1);
+  block_offsets[0] = 0;
+  E.resize(num_edges,2);
+  W.resize(num_edges);
+  for(int i = 0;i<num_blocks;i++)
+  {
+    const int b = order[i];
+    const int end = min(num_edges,(b+1)*block_size);
+    block_offsets[i+1] = block_offsets[i]+end-b*block_size;
+    for(int e = b*block_size;e<end;e++)
+    {
+      const int j = block_offsets[i]+e-b*block_size;
+      E(j,0) = all[e].s;
+      E(j,1) = all[e].d;
+      W(j) = all[e].w;
+    }
+  }
+
+  // Diagonals, for preconditioning
+  Matrix<Scalar,Dynamic,Dynamic> MV;
+  massmatrix_entries(V,F,type,MV);
+  M_diag.setZero(n);
+  for(int f = 0;f<m;f++)
+  {
+    for(int c = 0;c<ss;c++)
+    {
+      M_diag(F(f,c)) += MV(f,c);
+    }
+  }
+  L_diag.setZero(n);
+  for(int e = 0;e<num_edges;e++)
+  {
+    L_diag(E(e,0)) -= W(e);
+    L_diag(E(e,1)) -= W(e);
+  }
+}
+
+template <typename Scalar>
+template <typename DerivedX, typename DerivedY>
+IGL_INLINE void igl::MatrixFreeLaplacian<Scalar>::laplacian(
+  const Eigen::MatrixBase<DerivedX> & X,
+  Eigen::PlainObjectBase<DerivedY> & Y) const
+{
+  assert(X.rows() == n);
+  // Work on raw column-major storage: the scatter is memory bound. Row-major
+  // arguments go through column-major copies.
+  if(DerivedY::IsRowMajor)
+  {
+    Eigen::Matrix<Scalar,Eigen::Dynamic,Eigen::Dynamic> Yc;
+    laplacian(X,Yc);
+    Y = Yc;
+    return;
+  }
+  const Eigen::Ref<const Eigen::Matrix<Scalar,Eigen::Dynamic,Eigen::Dynamic> >
+    XP(X);
+  const int k = X.cols();
+  const int num_edges = E.rows();
+  const Eigen::Index xs = XP.outerStride();
+  Y.setZero(n,k);
+  const Scalar * x = XP.data();
+  Scalar * y = Y.data();
+  const int * Es = E.data();
+  const int * Ed = E.data()+num_edges;
+  const Scalar * w = W.data();
+  const auto scatter_block = [&](const int b)
+  {
+    for(int e = block_offsets[b];e<block_offsets[b+1];e++)
+    {
+      const int s = Es[e];
+      const int d = Ed[e];
+      for(int j = 0;j<k;j++)
+      {
+        const Scalar diff = w[e]*(x[j*xs+d]-x[j*xs+s]);
+        y[j*n+s] += diff;
+        y[j*n+d] -= diff;
+      }
+    }
+  };
+  const int num_parallel = num_colors()-1;
+  for(int c = 0;c<num_parallel;c++)
+  {
+    const int begin = color_offsets[c];
+    // Blocks of one color do not share vertices
+    parallel_for(
+      color_offsets[c+1]-begin,
+      [&](const int i){ scatter_block(begin+i); },
+      2);
+  }
+  for(int b = color_offsets[num_parallel];b<color_offsets.back();b++)
+  {
+    scatter_block(b);
+  }
+}
+
+template <typename Scalar>
+template <typename DerivedX, typename DerivedY>
+IGL_INLINE void igl::MatrixFreeLaplacian<Scalar>::mass(
+  const Eigen::MatrixBase<DerivedX> & X,
+  Eigen::PlainObjectBase<DerivedY> & Y) const
+{
+  assert(X.rows() == n);
+  Y.resize(n,X.cols());
+  parallel_for(n,[&](const int i)
+  {
+    Y.row(i) = M_diag(i)*X.row(i);
+  },10000);
+}
+
+template <typename Scalar>
+template <typename DerivedX, typename DerivedY>
+IGL_INLINE void igl::MatrixFreeLaplacian<Scalar>::apply(
+  const Eigen::MatrixBase<DerivedX> & X,
+  Eigen::PlainObjectBase<DerivedY> & Y) const
+{
+  if(beta == Scalar(0))
+  {
+    mass(X,Y);
+    Y *= alpha;
+    return;
+  }
+  laplacian(X,Y);
+  if(alpha != Scalar(0) || beta != Scalar(1))
+  {
+    parallel_for(n,[&](const int i)
+    {
+      Y.row(i) = beta*Y.row(i) + (alpha*M_diag(i))*X.row(i);
+    },10000);
+  }
+}
+
+template <typename Scalar>
+template <typename DerivedV, typename DerivedX, typename DerivedGX>
+IGL_INLINE void igl::MatrixFreeLaplacian<Scalar>::grad(
+  const Eigen::MatrixBase<DerivedV> & V,
+  const Eigen::MatrixBase<DerivedX> & X,
+  Eigen::PlainObjectBase<DerivedGX> & GX) const
+{
+  using namespace Eigen;
+  assert(F.cols() == 3 && "grad is only implemented for triangles");
+  assert(V.cols() == 3);
+  assert(X.rows() == n);
+  const int m = F.rows();
+  const int k = X.cols();
+  GX.resize(3*m,k);
+  parallel_for(m,[&](const int f)
+  {
+    // Same as the non-uniform gradient of grad_tri
+    const Matrix<Scalar,1,3> v0 = V.row(F(f,0)).template cast<Scalar>();
+    const Matrix<Scalar,1,3> v1 = V.row(F(f,1)).template cast<Scalar>();
+    const Matrix<Scalar,1,3> v2 = V.row(F(f,2)).template cast<Scalar>();
+    const Matrix<Scalar,1,3> v13 = v0-v2;
+    const Matrix<Scalar,1,3> v21 = v1-v0;
+    const Matrix<Scalar,1,3> nrm = (v2-v1).cross(v13);
+    const Scalar dblA = nrm.norm();
+    const Matrix<Scalar,1,3> u = nrm/dblA;
+    // rotate each edge 90 degrees around the normal, scaled by 1/dblA
+    const Matrix<Scalar,1,3> eperp13 = u.cross(v13)/dblA;
+    const Matrix<Scalar,1,3> eperp21 = u.cross(v21)/dblA;
+    for(int j = 0;j<k;j++)
+    {
+      const Scalar x0 = X(F(f,0),j);
+      const Matrix<Scalar,1,3> g =
+        eperp13*(X(F(f,1),j)-x0) + eperp21*(X(F(f,2),j)-x0);
+      for(int d = 0;d<3;d++)
+      {
+        GX(d*m+f,j) = g(d);
+      }
+    }
+  },1000);
+}
+
+template <typename Scalar>
+IGL_INLINE typename igl::MatrixFreeLaplacian<Scalar>::VectorXS
+  igl::MatrixFreeLaplacian<Scalar>::diagonal() const
+{
+  return alpha*M_diag + beta*L_diag;
+}
+
+#ifdef IGL_STATIC_LIBRARY
+// Explicit template instantiation
+template class igl::MatrixFreeLaplacian<double>;
+template void igl::MatrixFreeLaplacian<double>::init<Eigen::Matrix<double, -1, -1, 0, -1, -1>, Eigen::Matrix<int, -1, -1, 0, -1, -1> >(Eigen::MatrixBase<Eigen::Matrix<double, -1, -1, 0, -1, -1> > const&, Eigen::MatrixBase<Eigen::Matrix<int, -1, -1, 0, -1, -1> > const&, igl::MassMatrixType);
+template void igl::MatrixFreeLaplacian<double>::laplacian<Eigen::Matrix<double, -1, -1, 0, -1, -1>, Eigen::Matrix<double, -1, -1, 0, -1, -1> >(Eigen::MatrixBase<Eigen::Matrix<double, -1, -1, 0, -1, -1> > const&, Eigen::PlainObjectBase<Eigen::Matrix<double, -1, -1, 0, -1, -1> >&) const;
+template void igl::MatrixFreeLaplacian<double>::laplacian<Eigen::Matrix<double, -1, 1, 0, -1, 1>, Eigen::Matrix<double, -1, 1, 0, -1, 1> >(Eigen::MatrixBase<Eigen::Matrix<double, -1, 1, 0, -1, 1> > const&, Eigen::PlainObjectBase<Eigen::Matrix<double, -1, 1, 0, -1, 1> >&) const;
+template void igl::MatrixFreeLaplacian<double>::mass<Eigen::Matrix<double, -1, -1, 0, -1, -1>, Eigen::Matrix<double, -1, -1, 0, -1, -1> >(Eigen::MatrixBase<Eigen::Matrix<double, -1, -1, 0, -1, -1> > const&, Eigen::PlainObjectBase<Eigen::Matrix<double, -1, -1, 0, -1, -1> >&) const;
+template void igl::MatrixFreeLaplacian<double>::mass<Eigen::Matrix<double, -1, 1, 0, -1, 1>, Eigen::Matrix<double, -1, 1, 0, -1, 1> >(Eigen::MatrixBase<Eigen::Matrix<double, -1, 1, 0, -1, 1> > const&, Eigen::PlainObjectBase<Eigen::Matrix<double, -1, 1, 0, -1, 1> >&) const;
+template void igl::MatrixFreeLaplacian<double>::apply<Eigen::Matrix<double, -1, -1, 0, -1, -1>, Eigen::Matrix<double, -1, -1, 0, -1, -1> >(Eigen::MatrixBase<Eigen::Matrix<double, -1, -1, 0, -1, -1> > const&, Eigen::PlainObjectBase<Eigen::Matrix<double, -1, -1, 0, -1, -1> >&) const;
+template void igl::MatrixFreeLaplacian<double>::apply<Eigen::Matrix<double, -1, 1, 0, -1, 1>, Eigen::Matrix<double, -1, 1, 0, -1, 1> >(Eigen::MatrixBase<Eigen::Matrix<double, -1, 1, 0, -1, 1> > const&, Eigen::PlainObjectBase<Eigen::Matrix<double, -1, 1, 0, -1, 1> >&) const;
+template void igl::MatrixFreeLaplacian<double>::grad<Eigen::Matrix<double, -1, -1, 0, -1, -1>, Eigen::Matrix<double, -1, -1, 0, -1, -1>, Eigen::Matrix<double, -1, -1, 0, -1, -1> >(Eigen::MatrixBase<Eigen::Matrix<double, -1, -1, 0, -1, -1> > const&, Eigen::MatrixBase<Eigen::Matrix<double, -1, -1, 0, -1, -1> > const&, Eigen::PlainObjectBase<Eigen::Matrix<double, -1, -1, 0, -1, -1> >&) const;
+#endif
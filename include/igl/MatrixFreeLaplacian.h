@@ -0,0 +1,221 @@
+// This file is part of libigl, a simple c++ geometry processing library.
+//
+// Copyright (C) 2018 Floor Verhoeven
+//
+// This Source Code Form is subject to the terms of the Mozilla Public License
+// v. 2.0. If a copy of the MPL was not distributed with this file, You can
+// obtain one at http://mozilla.org/MPL/2.0/.
+#ifndef IGL_MATRIXFREELAPLACIAN_H
+#define IGL_MATRIXFREELAPLACIAN_H
+#include "igl_inline.h"
+#include "massmatrix.h"
+#include <Eigen/Core>
+#include <Eigen/Sparse>
+#include <Eigen/IterativeLinearSolvers>
+#include <vector>
+
+namespace igl
+{
+  template <typename Scalar> class MatrixFreeLaplacian;
+}
+
+namespace Eigen
+{
+  namespace internal
+  {
+    // MatrixFreeLaplacian behaves like a sparse matrix for Eigen's iterative
+    // solvers
+    template <typename Scalar>
+    struct traits<igl::MatrixFreeLaplacian<Scalar> > :
+      public traits<Eigen::SparseMatrix<Scalar> >
+    {};
+  }
+}
+
+namespace igl
+{
+  // Matrix-free versions of the cotangent Laplacian (igl::cotmatrix), the
+  // lumped mass matrix (igl::massmatrix) and the gradient (igl::grad) of a
+  // mesh. Only the mesh, the cotangent weight of each (unique) edge and the
+  // per-vertex masses are stored. The Laplacian is applied with a
+  // multithreaded loop over blocks of consecutive (sorted) edges. The blocks
+  // are greedily colored so that no two blocks of the same color share a
+  // vertex and can be scattered into the output without races, while each
+  // block keeps the memory locality of the sorted edge order.
+  //
+  // The object can be used as the matrix of Eigen's iterative solvers, in
+  // which case it applies alpha*M + beta*L (by default L). For example, one
+  // implicit smoothing step (M - delta*L) U = M U:
+  //
+  //   igl::MatrixFreeLaplacian<double> A;
+  //   A.init(V,F,igl::MASSMATRIX_TYPE_BARYCENTRIC);
+  //   A.alpha = 1; A.beta = -delta;
+  //   Eigen::ConjugateGradient<igl::MatrixFreeLaplacian<double>,
+  //     Eigen::Lower|Eigen::Upper,
+  //     igl::MatrixFreeLaplacian<double>::Preconditioner> cg;
+  //   cg.compute(A);
+  //   Eigen::MatrixXd MU;
+  //   A.mass(U,MU);
+  //   U = cg.solve(MU);
+  //
+  // Templates:
+  //   _Scalar  scalar type of the operators
+  template <typename _Scalar>
+  class MatrixFreeLaplacian :
+    public Eigen::EigenBase<MatrixFreeLaplacian<_Scalar> >
+  {
+    public:
+      typedef _Scalar Scalar;
+      typedef _Scalar RealScalar;
+      typedef int StorageIndex;
+      enum
+      {
+        ColsAtCompileTime = Eigen::Dynamic,
+        MaxColsAtCompileTime = Eigen::Dynamic,
+        IsRowMajor = false
+      };
+      typedef Eigen::Matrix<Scalar,Eigen::Dynamic,1> VectorXS;
+      // Coefficients of the operator alpha*M + beta*L applied by operator*
+      Scalar alpha,beta;
+    private:
+      // Number of vertices
+      int n;
+      // Mesh elements
+      Eigen::Matrix<int,Eigen::Dynamic,Eigen::Dynamic> F;
+      // Unique undirected edges sorted by block color and their cotangent
+      // weights: L(s,d) = L(d,s) = W(e) for E.row(e) = [s d]
+      Eigen::Matrix<int,Eigen::Dynamic,2> E;
+      VectorXS W;
+      // Block b holds edges block_offsets[b] to block_offsets[b+1]-1
+      std::vector<int> block_offsets;
+      // Blocks color_offsets[c] to color_offsets[c+1]-1 have color c. The
+      // last "color" holds blocks that could not be colored and is processed
+      // serially.
+      std::vector<int> color_offsets;
+      // Diagonals of M and L
+      VectorXS M_diag,L_diag;
+    public:
+      MatrixFreeLaplacian():alpha(0),beta(1),n(0){}
+      // Precompute the edge weights, masses and coloring of a mesh
+      //
+      // Inputs:
+      //   V  #V by dim list of mesh vertex positions
+      //   F  #F by {3|4} list of {triangle|tetrahedra} indices into V
+      //   type  mass matrix type (see massmatrix)
+      template <typename DerivedV, typename DerivedF>
+      IGL_INLINE void init(
+        const Eigen::MatrixBase<DerivedV> & V,
+        const Eigen::MatrixBase<DerivedF> & F,
+        const MassMatrixType type = MASSMATRIX_TYPE_DEFAULT);
+      Eigen::Index rows() const { return n; }
+      Eigen::Index cols() const { return n; }
+      // Number of colors used to schedule the blocks (including the serial
+      // remainder)
+      int num_colors() const { return (int)color_offsets.size()-1; }
+      // Y = L*X
+      //
+      // Inputs:
+      //   X  #V by k matrix
+      // Outputs:
+      //   Y  #V by k matrix
+      template <typename DerivedX, typename DerivedY>
+      IGL_INLINE void laplacian(
+        const Eigen::MatrixBase<DerivedX> & X,
+        Eigen::PlainObjectBase<DerivedY> & Y) const;
+      // Y = M*X
+      template <typename DerivedX, typename DerivedY>
+      IGL_INLINE void mass(
+        const Eigen::MatrixBase<DerivedX> & X,
+        Eigen::PlainObjectBase<DerivedY> & Y) const;
+      // Y = (alpha*M + beta*L)*X
+      template <typename DerivedX, typename DerivedY>
+      IGL_INLINE void apply(
+        const Eigen::MatrixBase<DerivedX> & X,
+        Eigen::PlainObjectBase<DerivedY> & Y) const;
+      // G*X for the (non-uniform) gradient of igl::grad on a triangle mesh
+      //
+      // Inputs:
+      //   V  #V by 3 list of mesh vertex positions (as passed to init)
+      //   X  #V by k matrix of per-vertex values
+      // Outputs:
+      //   GX  #F*3 by k matrix of per-face gradients, with x components in
+      //     rows 0 to #F-1, y components in rows #F to 2*#F-1, etc.
+      template <typename DerivedV, typename DerivedX, typename DerivedGX>
+      IGL_INLINE void grad(
+        const Eigen::MatrixBase<DerivedV> & V,
+        const Eigen::MatrixBase<DerivedX> & X,
+        Eigen::PlainObjectBase<DerivedGX> & GX) const;
+      // Diagonal of alpha*M + beta*L
+      IGL_INLINE VectorXS diagonal() const;
+      const VectorXS & mass_diagonal() const { return M_diag; }
+
+      template <typename Rhs>
+      Eigen::Product<MatrixFreeLaplacian,Rhs,Eigen::AliasFreeProduct>
+        operator*(const Eigen::MatrixBase<Rhs> & x) const
+      {
+        return
+          Eigen::Product<MatrixFreeLaplacian,Rhs,Eigen::AliasFreeProduct>(
+            *this,x.derived());
+      }
+
+      // Jacobi preconditioner for Eigen's iterative solvers (Eigen's
+      // DiagonalPreconditioner needs access to the matrix entries)
+      class Preconditioner : public Eigen::DiagonalPreconditioner<Scalar>
+      {
+        public:
+          Preconditioner(){}
+          template <typename MatType>
+          explicit Preconditioner(const MatType & A){ compute(A); }
+          template <typename MatType>
+          Preconditioner & analyzePattern(const MatType &){ return *this; }
+          template <typename MatType>
+          Preconditioner & factorize(const MatType & A)
+          {
+            const VectorXS D = A.diagonal();
+            this->m_invdiag =
+              (D.array() != Scalar(0)).select(D.cwiseInverse(),Scalar(1));
+            this->m_isInitialized = true;
+            return *this;
+          }
+          template <typename MatType>
+          Preconditioner & compute(const MatType & A){ return factorize(A); }
+      };
+  };
+}
+
+namespace Eigen
+{
+  namespace internal
+  {
+    template <typename Scalar, typename Rhs, int ProductType>
+    struct generic_product_impl<
+      igl::MatrixFreeLaplacian<Scalar>,
+      Rhs,
+      SparseShape,
+      DenseShape,
+      ProductType> :
+      generic_product_impl_base<
+        igl::MatrixFreeLaplacian<Scalar>,
+        Rhs,
+        generic_product_impl<igl::MatrixFreeLaplacian<Scalar>,Rhs> >
+    {
+      template <typename Dest>
+      static void scaleAndAddTo(
+        Dest & dst,
+        const igl::MatrixFreeLaplacian<Scalar> & lhs,
+        const Rhs & rhs,
+        const Scalar & alpha)
+      {
+        typename Dest::PlainObject Y;
+        lhs.apply(rhs,Y);
+        dst += alpha*Y;
+      }
+    };
+  }
+}
+
+#ifndef IGL_STATIC_LIBRARY
+#  include "MatrixFreeLaplacian.cpp"
+#endif
+
+#endif
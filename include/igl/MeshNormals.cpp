@@ -0,0 +1,109 @@
+// This file is part of libigl, a simple c++ geometry processing library.
+//
+// Copyright (C) 2018 Floor Verhoeven
+//
+// This Source Code Form is subject to the terms of the Mozilla Public License
+// v. 2.0. If a copy of the MPL was not distributed with this file, You can
+// obtain one at http://mozilla.org/MPL/2.0/.
+#include "MeshNormals.h"
+#include "parallel_for.h"
+#include "vertex_triangle_adjacency.h"
+#include <cassert>
+#include <cmath>
+
+template <typename DerivedF>
+IGL_INLINE void igl::MeshNormals::init(
+  const Eigen::MatrixBase<DerivedF> & _F,
+  int n)
+{
+  assert((_F.rows() == 0 || _F.cols() == 3) && "F must contain triangles");
+  if(n < 0)
+  {
+    n = _F.rows() == 0 ? 0 : int(_F.maxCoeff())+1;
+  }
+  F = _F.template cast<int>();
+  vertex_triangle_adjacency(F,n,VF,VFi,NI);
+}
+
+template <typename DerivedV>
+IGL_INLINE void igl::MeshNormals::update(
+  const Eigen::MatrixBase<DerivedV> & V,
+  const PerVertexNormalsWeightingType weighting,
+  const bool angles)
+{
+  typedef Eigen::Matrix<double,1,3> RowVector3d;
+  assert(V.cols() == 3 && "V must be 3D");
+  assert(V.rows() == num_vertices() && "V must match init");
+  const int m = F.rows();
+  const int n = num_vertices();
+  const bool with_angles =
+    angles || weighting == PER_VERTEX_NORMALS_WEIGHTING_TYPE_ANGLE;
+  FN.resize(m,3);
+  dblA.resize(m);
+  K.resize(with_angles ? m : 0,3);
+  parallel_for(m,[&](const int f)
+  {
+    const RowVector3d p0 = V.row(F(f,0)).template cast<double>();
+    const RowVector3d p1 = V.row(F(f,1)).template cast<double>();
+    const RowVector3d p2 = V.row(F(f,2)).template cast<double>();
+    const RowVector3d v1 = p1 - p0;
+    const RowVector3d v2 = p2 - p0;
+    const RowVector3d c = v1.cross(v2);
+    const double r = c.norm();
+    dblA(f) = r;
+    if(r == 0)
+    {
+      FN.row(f).setZero();
+    }else
+    {
+      FN.row(f) = c/r;
+    }
+    if(with_angles)
+    {
+      // Squared lengths of the edges opposite each corner (as
+      // internal_angles)
+      const double l[3] = {
+        (p1-p2).squaredNorm(),(p2-p0).squaredNorm(),(p0-p1).squaredNorm()};
+      for(int d = 0;d<3;d++)
+      {
+        const double s1 = l[d];
+        const double s2 = l[(d+1)%3];
+        const double s3 = l[(d+2)%3];
+        K(f,d) = std::acos((s3 + s2 - s1)/(2.*std::sqrt(s3*s2)));
+      }
+    }
+  },1000);
+  VN.resize(n,3);
+  parallel_for(n,[&](const int v)
+  {
+    RowVector3d s(0,0,0);
+    for(int i = NI(v);i<NI(v+1);i++)
+    {
+      const int f = VF(i);
+      double w;
+      switch(weighting)
+      {
+        case PER_VERTEX_NORMALS_WEIGHTING_TYPE_UNIFORM:
+          w = 1;
+          break;
+        case PER_VERTEX_NORMALS_WEIGHTING_TYPE_ANGLE:
+          w = K(f,VFi(i));
+          break;
+        default:
+          w = dblA(f);
+          break;
+      }
+      s += w*FN.row(f);
+    }
+    VN.row(v) = s.normalized();
+  },1000);
+}
+
+#ifdef IGL_STATIC_LIBRARY
+// Explicit template instantiation
+template void igl::MeshNormals::init<Eigen::Matrix<int, -1, -1, 0, -1, -1> >(Eigen::MatrixBase<Eigen::Matrix<int, -1, -1, 0, -1, -1> > const&, int);
+template void igl::MeshNormals::init<Eigen::Matrix<int, -1, 3, 0, -1, 3> >(Eigen::MatrixBase<Eigen::Matrix<int, -1, 3, 0, -1, 3> > const&, int);
+template void igl::MeshNormals::update<Eigen::Matrix<double, -1, -1, 0, -1, -1> >(Eigen::MatrixBase<Eigen::Matrix<double, -1, -1, 0, -1, -1> > const&, igl::PerVertexNormalsWeightingType, bool);
+template void igl::MeshNormals::update<Eigen::Matrix<double, -1, 3, 0, -1, 3> >(Eigen::MatrixBase<Eigen::Matrix<double, -1, 3, 0, -1, 3> > const&, igl::PerVertexNormalsWeightingType, bool);
+template void igl::MeshNormals::update<Eigen::Matrix<float, -1, -1, 0, -1, -1> >(Eigen::MatrixBase<Eigen::Matrix<float, -1, -1, 0, -1, -1> > const&, igl::PerVertexNormalsWeightingType, bool);
+#endif
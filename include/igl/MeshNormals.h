@@ -0,0 +1,90 @@
+// This file is part of libigl, a simple c++ geometry processing library.
+//
+// Copyright (C) 2018 Floor Verhoeven
+//
+// This Source Code Form is subject to the terms of the Mozilla Public License
+// v. 2.0. If a copy of the MPL was not distributed with this file, You can
+// obtain one at http://mozilla.org/MPL/2.0/.
+#ifndef IGL_MESHNORMALS_H
+#define IGL_MESHNORMALS_H
+#include "igl_inline.h"
+#include "per_vertex_normals.h"
+#include <Eigen/Core>
+
+namespace igl
+{
+  // Face normals, areas, internal angles and vertex normals of a triangle
+  // mesh whose vertices move while its connectivity stays fixed (e.g.
+  // animation or simulation displayed every frame).
+  //
+  // The incident corners of each vertex are gathered once by init. update
+  // then makes one parallel pass over the faces to compute their normals,
+  // areas and (if needed) angles together, and one parallel pass over the
+  // vertices to sum the weighted normals of their incident corners. Each
+  // vertex is written by one thread only, so the second pass needs no
+  // atomics or per-thread copies. The sums are in ascending face order, as
+  // in per_vertex_normals.
+  //
+  // Example:
+  //   igl::MeshNormals normals(F,V.rows());
+  //   while(animating)
+  //   {
+  //     // ... move V
+  //     normals.update(V);
+  //     // use normals.FN and normals.VN
+  //   }
+  class MeshNormals
+  {
+    public:
+      // #F by 3 list of unit face normals (zero for degenerate faces)
+      Eigen::MatrixXd FN;
+      // #F list of face areas times two
+      Eigen::VectorXd dblA;
+      // #F by 3 list of internal angles of each corner (only computed for
+      // angle weighting or if requested, see update)
+      Eigen::MatrixXd K;
+      // #V by 3 list of unit vertex normals
+      Eigen::MatrixXd VN;
+    private:
+      // Triangles and incident corners of each vertex: those of v are
+      // corners VFi(i) of faces VF(i) for i in NI(v):NI(v+1)-1
+      Eigen::Matrix<int,Eigen::Dynamic,3> F;
+      Eigen::VectorXi VF,VFi,NI;
+    public:
+      MeshNormals(){}
+      template <typename DerivedF>
+      MeshNormals(const Eigen::MatrixBase<DerivedF> & F, const int n = -1)
+      {
+        init(F,n);
+      }
+      // Gather the incident corners of each vertex (in parallel)
+      //
+      // Inputs:
+      //   F  #F by 3 list of triangle indices
+      //   n  number of vertices (at least max(F)+1) {max(F)+1}
+      template <typename DerivedF>
+      IGL_INLINE void init(const Eigen::MatrixBase<DerivedF> & F, int n = -1);
+      // Compute FN, dblA, VN and (if needed) K for new vertex positions
+      //
+      // Inputs:
+      //   V  #V by 3 list of vertex positions
+      //   weighting  weighting of the incident face normals of each vertex
+      //   angles  whether to compute K even if not needed by the weighting
+      template <typename DerivedV>
+      IGL_INLINE void update(
+        const Eigen::MatrixBase<DerivedV> & V,
+        const PerVertexNormalsWeightingType weighting =
+          PER_VERTEX_NORMALS_WEIGHTING_TYPE_DEFAULT,
+        const bool angles = false);
+      int num_faces() const { return (int)F.rows(); }
+      // Faces passed to init
+      const Eigen::Matrix<int,Eigen::Dynamic,3> & faces() const { return F; }
+      int num_vertices() const { return NI.size() == 0 ? 0 : NI.size()-1; }
+  };
+}
+
+#ifndef IGL_STATIC_LIBRARY
+#  include "MeshNormals.cpp"
+#endif
+
+#endif
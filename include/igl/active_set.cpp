@@ -12,9 +12,12 @@
 #include "cat.h"
 //#include "matlab_format.h"
 
+#include <Eigen/OrderingMethods>
+#include <Eigen/SparseCholesky>
 #include <iostream>
 #include <limits>
 #include <algorithm>
+#include <vector>
 
 template <
   typename AT,
@@ -108,6 +111,32 @@ IGL_INLINE igl::SolverStatus igl::active_set(
   Matrix<BOOL,Dynamic,1> as_ux = Matrix<BOOL,Dynamic,1>::Constant(n,1,FALSE);
   Matrix<BOOL,Dynamic,1> as_ieq = Matrix<BOOL,Dynamic,1>::Constant(Aieq.rows(),1,FALSE);
 
+  Matrix<BOOL,Dynamic,1> is_known = Matrix<BOOL,Dynamic,1>::Constant(n,1,FALSE);
+  for(int k = 0;k<nk;k++)
+  {
+    is_known(known(k)) = TRUE;
+  }
+
+  // Without linear constraints and with positive definite A, the free
+  // variables are factored directly in the order induced by a fill-reducing
+  // ordering of A: the filled graph of a principal submatrix is contained in
+  // that of A, so a single ordering serves every active set.
+  const bool box_only = params.Auu_pd && Aeq.rows() == 0 && Aieq.rows() == 0;
+  VectorXi ordering;
+  if(box_only)
+  {
+    if(params.ordering.size() == n)
+    {
+      ordering = params.ordering;
+    }else
+    {
+      AMDOrdering<int> amd;
+      PermutationMatrix<Dynamic,Dynamic,int> P;
+      amd(A,P);
+      ordering = P.indices();
+    }
+  }
+
   // Keep track of previous Z for comparison
   DerivedZ old_Z;
   old_Z = DerivedZ::Constant(
@@ -128,13 +157,16 @@ IGL_INLINE igl::SolverStatus igl::active_set(
     {
       for(int z = 0;z < n;z++)
       {
-        if(Z(z) < lx(z))
+        // An initial guess on a bound (e.g. a previous solution) warm starts
+        // the active set
+        const bool warm = iter == 0 && !is_known(z);
+        if(Z(z) < lx(z) || (warm && Z(z) == lx(z)))
         {
           new_as_lx += (as_lx(z)?0:1);
           //new_as_lx++;
           as_lx(z) = TRUE;
         }
-        if(Z(z) > ux(z))
+        if(Z(z) > ux(z) || (warm && Z(z) == ux(z)))
         {
           new_as_ux += (as_ux(z)?0:1);
           //new_as_ux++;
@@ -273,6 +305,79 @@ IGL_INLINE igl::SolverStatus igl::active_set(
       slice_into(Y_i,known_i,1,Z);
       sol.resize(0,Y_i.cols());
       assert(Aeq_i.rows() == 0 && "All fixed but linearly constrained");
+    }else if(box_only)
+    {
+      // Free variables in elimination order
+      const int nu = n-known_i.size();
+      VectorXi unknown(nu);
+      VectorXi pos = VectorXi::Constant(n,1,-1);
+      DerivedZ Zk = DerivedZ::Zero(n,1);
+      for(int k = 0;k<known_i.size();k++)
+      {
+        Zk(known_i(k)) = Y_i(k);
+      }
+      {
+        for(int k = 0;k<known_i.size();k++)
+        {
+          pos(known_i(k)) = -2;
+        }
+        int u = 0;
+        for(int k = 0;k<n;k++)
+        {
+          const int z = ordering(k);
+          if(pos(z) == -1)
+          {
+            pos(z) = u;
+            unknown(u++) = z;
+          }
+        }
+        assert(u == nu);
+      }
+      // Lower triangle of A(unknown,unknown) and -B(unknown)-A(unknown,known)*Y
+      std::vector<Triplet<AT> > IJV;
+      IJV.reserve(A.nonZeros()/2+n);
+      Matrix<AT,Dynamic,1> rhs(nu);
+      for(int u = 0;u<nu;u++)
+      {
+        rhs(u) = -B(unknown(u));
+      }
+      for(int j = 0;j<A.outerSize();j++)
+      {
+        for(typename SparseMatrix<AT>::InnerIterator it(A,j);it;++it)
+        {
+          const int pi = pos(it.row());
+          if(pi < 0)
+          {
+            continue;
+          }
+          if(pos(j) >= 0)
+          {
+            if(pi >= pos(j))
+            {
+              IJV.emplace_back(pi,pos(j),it.value());
+            }
+          }else
+          {
+            rhs(pi) -= it.value()*Zk(j);
+          }
+        }
+      }
+      SparseMatrix<AT> Auu(nu,nu);
+      Auu.setFromTriplets(IJV.begin(),IJV.end());
+      SimplicialLLT<SparseMatrix<AT>,Lower,NaturalOrdering<int> > llt(Auu);
+      if(llt.info() != Success)
+      {
+        cerr<<"Error: factorization of free variables failed."<<endl;
+        ret = SOLVER_STATUS_ERROR;
+        break;
+      }
+      const Matrix<AT,Dynamic,1> Zu = llt.solve(rhs);
+      Z = Zk;
+      for(int u = 0;u<nu;u++)
+      {
+        Z(unknown(u)) = Zu(u);
+      }
+      sol.resize(0,1);
     }else
     {
 #ifdef ACTIVE_SET_CPP_DEBUG
@@ -307,13 +412,14 @@ IGL_INLINE igl::SolverStatus igl::active_set(
       assert(data.Auu_sym);
     }
 
-    // Compute Lagrange multiplier values for known_i
-    SparseMatrix<AT> Ak;
-    // Slow
-    slice(A,known_i,1,Ak);
-    DerivedB Bk;
-    slice(B,known_i,Bk);
-    MatrixXd Lambda_known_i = -(0.5*Ak*Z + 0.5*Bk);
+    // Compute Lagrange multiplier values for known_i: gather rows of A*Z
+    // rather than slicing A
+    const Matrix<AT,Dynamic,1> AZ = A*Z;
+    MatrixXd Lambda_known_i(known_i.size(),1);
+    for(int k = 0;k<known_i.size();k++)
+    {
+      Lambda_known_i(k) = -(0.5*AZ(known_i(k)) + 0.5*B(known_i(k)));
+    }
     // reverse the lambda values for lx
     Lambda_known_i.block(nk,0,as_lx_count,1) =
       (-1*Lambda_known_i.block(nk,0,as_lx_count,1)).eval();
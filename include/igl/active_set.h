@@ -41,7 +41,7 @@ namespace igl
   //   ux  n by 1 list of upper bounds [] implies Inf
   //   params  struct of additional parameters (see below)
   //   Z  if not empty, is taken to be an n by 1 list of initial guess values
-  //     (see output)
+  //     (see output); entries on or beyond a bound start in the active set
   // Outputs:
   //   Z  n by 1 list of solution values
   // Returns true on success, false on error
@@ -90,17 +90,24 @@ struct igl::active_set_params
   //     is perfect) {EPS}
   //   solution_diff_threshold  Threshold on the squared norm of the difference
   //     between two consecutive solutions {EPS}
+  //   ordering  n list of indices into A in a fill-reducing elimination order
+  //     (e.g. from Eigen::AMDOrdering), used to factor the free variables when
+  //     A is positive definite and there are no linear (in)equality
+  //     constraints. Can be shared by solves with the same A. ([] = compute
+  //     for each call) {[]}
   bool Auu_pd;
   int max_iter;
   double inactive_threshold;
   double constraint_threshold;
   double solution_diff_threshold;
+  Eigen::VectorXi ordering;
   active_set_params():
     Auu_pd(false),
     max_iter(100),
     inactive_threshold(igl::DOUBLE_EPS),
     constraint_threshold(igl::DOUBLE_EPS),
-    solution_diff_threshold(igl::DOUBLE_EPS)
+    solution_diff_threshold(igl::DOUBLE_EPS),
+    ordering()
     {};
 };
 
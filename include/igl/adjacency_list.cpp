@@ -8,6 +8,8 @@
 #include "adjacency_list.h"
 
 #include "verbose.h"
+#include "parallel_for.h"
+#include "vertex_triangle_adjacency.h"
 #include <algorithm>
 
 template <typename Index, typename IndexVector>
@@ -158,6 +160,49 @@ IGL_INLINE void igl::adjacency_list(
   
 }
 
+template <typename DerivedF, typename DerivedA, typename DerivedNA>
+IGL_INLINE void igl::adjacency_list(
+  const Eigen::MatrixBase<DerivedF> & F,
+  Eigen::PlainObjectBase<DerivedA> & A,
+  Eigen::PlainObjectBase<DerivedNA> & NA)
+{
+  using namespace std;
+  const int n = F.size() == 0 ? 0 : int(F.maxCoeff())+1;
+  const int dim = F.cols();
+  Eigen::VectorXi VF,VFi,NI;
+  vertex_triangle_adjacency(F,n,VF,VFi,NI);
+  // Each corner contributes its two neighbors along the face: gather them in
+  // place, then sort and remove duplicates per vertex
+  vector<int> N(2*NI(n));
+  vector<int> degree(n+1,0);
+  parallel_for(n,[&](const int v)
+  {
+    const auto begin = N.begin()+2*NI(v);
+    auto end = begin;
+    for(int i = NI(v);i<NI(v+1);i++)
+    {
+      *(end++) = F(VF(i),(VFi(i)+1)%dim);
+      *(end++) = F(VF(i),(VFi(i)+dim-1)%dim);
+    }
+    sort(begin,end);
+    degree[v+1] = unique(begin,end)-begin;
+  },1000);
+  NA.resize(n+1,1);
+  NA(0) = 0;
+  for(int v = 0;v<n;v++)
+  {
+    NA(v+1) = NA(v) + degree[v+1];
+  }
+  A.resize(NA(n),1);
+  parallel_for(n,[&](const int v)
+  {
+    for(int j = 0;j<NA(v+1)-NA(v);j++)
+    {
+      A(NA(v)+j) = N[2*NI(v)+j];
+    }
+  },1000);
+}
+
 #ifdef IGL_STATIC_LIBRARY
 // Explicit template instantiation
 // generated by autoexplicit.sh
@@ -165,4 +210,5 @@ template void igl::adjacency_list<Eigen::Matrix<int, -1, 2, 0, -1, 2>, int>(Eige
 // generated by autoexplicit.sh
 template void igl::adjacency_list<Eigen::Matrix<int, -1, -1, 0, -1, -1>, int>(Eigen::PlainObjectBase<Eigen::Matrix<int, -1, -1, 0, -1, -1> > const&, std::vector<std::vector<int, std::allocator<int> >, std::allocator<std::vector<int, std::allocator<int> > > >&, bool);
 template void igl::adjacency_list<Eigen::Matrix<int, -1, 3, 0, -1, 3>, int>(Eigen::PlainObjectBase<Eigen::Matrix<int, -1, 3, 0, -1, 3> > const&, std::vector<std::vector<int, std::allocator<int> >, std::allocator<std::vector<int, std::allocator<int> > > >&, bool);
+template void igl::adjacency_list<Eigen::Matrix<int, -1, -1, 0, -1, -1>, Eigen::Matrix<int, -1, 1, 0, -1, 1>, Eigen::Matrix<int, -1, 1, 0, -1, 1> >(Eigen::MatrixBase<Eigen::Matrix<int, -1, -1, 0, -1, -1> > const&, Eigen::PlainObjectBase<Eigen::Matrix<int, -1, 1, 0, -1, 1> >&, Eigen::PlainObjectBase<Eigen::Matrix<int, -1, 1, 0, -1, 1> >&);
 #endif
@@ -42,6 +42,19 @@ namespace igl
     const std::vector<std::vector<Index> > & F,
     std::vector<std::vector<Index> >& A);
 
+  // Compressed variant avoiding a list per vertex, built in parallel
+  //
+  // Inputs:
+  //   F  #F by dim list of mesh faces
+  // Outputs:
+  //   A  #A list of adjacent vertices, so that A(NA(i)):A(NA(i+1)-1) are the
+  //     adjacent vertices of vertex i in ascending order
+  //   NA  #V+1 list of cumulative vertex degrees with a preceding zero
+  template <typename DerivedF, typename DerivedA, typename DerivedNA>
+  IGL_INLINE void adjacency_list(
+    const Eigen::MatrixBase<DerivedF> & F,
+    Eigen::PlainObjectBase<DerivedA> & A,
+    Eigen::PlainObjectBase<DerivedNA> & NA);
 }
 
 #ifndef IGL_STATIC_LIBRARY
@@ -225,12 +225,7 @@ IGL_INLINE bool igl::arap_solve(
       fit_rotations_planar(S,R);
     }else
     {
-      fit_rotations(S,true,R);
-//#ifdef __SSE__ // fit_rotations_SSE will convert to float if necessary
-//      fit_rotations_SSE(S,R);
-//#else
-//      fit_rotations(S,true,R);
-//#endif
+      fit_rotations_fast(S,R);
     }
     //for(int k = 0;k<(data.CSM.rows()/dim);k++)
     //{
@@ -276,24 +271,16 @@ IGL_INLINE bool igl::arap_solve(
     columnize(eff_R,num_rots,2,Rcol);
     VectorXd Bcol = -data.K * Rcol;
     assert(Bcol.size() == data.n*data.dim);
-    for(int c = 0;c<data.dim;c++)
+    // Solve for all coordinates at once
+    MatrixXd B = Map<const MatrixXd>(Bcol.data(),n,data.dim);
+    if(data.with_dynamics)
     {
-      VectorXd Uc,Bc,bcc,Beq;
-      Bc = Bcol.block(c*n,0,n,1);
-      if(data.with_dynamics)
-      {
-        Bc += Dl.col(c);
-      }
-      if(bc.size()>0)
-      {
-        bcc = bc.col(c);
-      }
-      min_quad_with_fixed_solve(
-        data.solver_data,
-        Bc,bcc,Beq,
-        Uc);
-      U.col(c) = Uc;
+      B += Dl;
     }
+    MatrixXd bcd = bc.size()>0 ? MatrixXd(bc) : MatrixXd(0,data.dim);
+    MatrixXd Beq,Ud;
+    min_quad_with_fixed_solve(data.solver_data,B,bcd,Beq,Ud);
+    U = Ud;
 
     iter++;
   }
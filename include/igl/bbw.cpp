@@ -10,6 +10,7 @@
 #include "harmonic.h"
 #include "parallel_for.h"
 #include <Eigen/Sparse>
+#include <Eigen/OrderingMethods>
 #include <iostream>
 #include <mutex>
 #include <cstdio>
@@ -77,11 +78,25 @@ IGL_INLINE bool igl::bbw(
     cout<<"BBW: Computing initial weights for "<<m<<" handle"<<
       (m!=1?"s":"")<<"."<<endl;
   }
-  min_quad_with_fixed_data<typename DerivedW::Scalar > mqwf;
-  min_quad_with_fixed_precompute(Q,b,Aeq,true,mqwf);
-  min_quad_with_fixed_solve(mqwf,c,bc,Beq,W);
-  // decrement
-  eff_params.max_iter--;
+  // All handles share Q, so compute its fill-reducing ordering once
+  if(eff_params.ordering.size() != n)
+  {
+    AMDOrdering<int> amd;
+    PermutationMatrix<Dynamic,Dynamic,int> P;
+    amd(Q,P);
+    eff_params.ordering = P.indices();
+  }
+  if(data.W0.rows() == n && data.W0.cols() == m)
+  {
+    W = data.W0.template cast<typename DerivedW::Scalar>();
+  }else
+  {
+    min_quad_with_fixed_data<typename DerivedW::Scalar > mqwf;
+    min_quad_with_fixed_precompute(Q,b,Aeq,true,mqwf);
+    min_quad_with_fixed_solve(mqwf,c,bc,Beq,W);
+    // decrement
+    eff_params.max_iter--;
+  }
   bool error = false;
   // Loop over handles
   std::mutex critical;
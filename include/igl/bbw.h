@@ -21,7 +21,9 @@ namespace igl
       // Enforce partition of unity during optimization (optimize all weight
       // simultaneously)
       bool partition_unity;
-      // Initial guess
+      // Initial guess: #V by #handles weights (e.g. of a previous solve with
+      // slightly changed handles) used to warm start the active set ([] =
+      // solution without bound constraints)
       Eigen::MatrixXd W0;
       igl::active_set_params active_set_params;
       // Verbosity level
@@ -0,0 +1,102 @@
+// This file is part of libigl, a simple c++ geometry processing library.
+//
+// Copyright (C) 2018 Floor Verhoeven
+//
+// This Source Code Form is subject to the terms of the Mozilla Public License
+// v. 2.0. If a copy of the MPL was not distributed with this file, You can
+// obtain one at http://mozilla.org/MPL/2.0/.
+#include "cotmatrix_cached.h"
+#include "cotmatrix_entries.h"
+#include <vector>
+
+namespace igl
+{
+  namespace cotmatrix_cached_helpers
+  {
+    // Local edges of each element type, in the order of cotmatrix_entries
+    inline Eigen::Matrix<int,Eigen::Dynamic,2> edges(const int simplex_size)
+    {
+      Eigen::Matrix<int,Eigen::Dynamic,2> E;
+      if(simplex_size == 3)
+      {
+        E.resize(3,2);
+        E<<1,2, 2,0, 0,1;
+      }else
+      {
+        assert(simplex_size == 4);
+        E.resize(6,2);
+        E<<1,2, 2,0, 0,1, 3,0, 3,1, 3,2;
+      }
+      return E;
+    }
+
+    // Per-element contributions: column 4*e+k of LV holds the contributions
+    // of local edge e to (s,d), (d,s), (s,s) and (d,d) for k = 0,1,2,3
+    template <typename DerivedV, typename DerivedF, typename Scalar>
+    IGL_INLINE void values(
+      const Eigen::MatrixBase<DerivedV> & V,
+      const Eigen::MatrixBase<DerivedF> & F,
+      Eigen::Matrix<Scalar,Eigen::Dynamic,Eigen::Dynamic> & LV)
+    {
+      Eigen::Matrix<Scalar,Eigen::Dynamic,Eigen::Dynamic> C;
+      cotmatrix_entries(V,F,C);
+      LV.resize(C.rows(),4*C.cols());
+      for(int e = 0;e<C.cols();e++)
+      {
+        LV.col(4*e+0) = C.col(e);
+        LV.col(4*e+1) = C.col(e);
+        LV.col(4*e+2) = -C.col(e);
+        LV.col(4*e+3) = -C.col(e);
+      }
+    }
+  }
+}
+
+template <typename DerivedV, typename DerivedF, typename Scalar>
+IGL_INLINE void igl::cotmatrix_cached_precompute(
+  const Eigen::MatrixBase<DerivedV> & V,
+  const Eigen::MatrixBase<DerivedF> & F,
+  sparse_cached_data & data,
+  Eigen::SparseMatrix<Scalar>& L)
+{
+  using namespace Eigen;
+  using namespace std;
+  const int m = F.rows();
+  const Matrix<int,Dynamic,2> edges = cotmatrix_cached_helpers::edges(F.cols());
+  // Triplets in the (column major) order of the values of
+  // cotmatrix_cached_helpers::values
+  vector<Triplet<Scalar> > IJV(4*edges.rows()*m);
+  for(int e = 0;e<edges.rows();e++)
+  {
+    for(int i = 0;i<m;i++)
+    {
+      const int source = F(i,edges(e,0));
+      const int dest = F(i,edges(e,1));
+      IJV[(4*e+0)*m+i] = Triplet<Scalar>(source,dest,0);
+      IJV[(4*e+1)*m+i] = Triplet<Scalar>(dest,source,0);
+      IJV[(4*e+2)*m+i] = Triplet<Scalar>(source,source,0);
+      IJV[(4*e+3)*m+i] = Triplet<Scalar>(dest,dest,0);
+    }
+  }
+  L.resize(V.rows(),V.rows());
+  sparse_cached_precompute(IJV,data,L);
+  cotmatrix_cached(V,F,data,L);
+}
+
+template <typename DerivedV, typename DerivedF, typename Scalar>
+IGL_INLINE void igl::cotmatrix_cached(
+  const Eigen::MatrixBase<DerivedV> & V,
+  const Eigen::MatrixBase<DerivedF> & F,
+  const sparse_cached_data & data,
+  Eigen::SparseMatrix<Scalar>& L)
+{
+  Eigen::Matrix<Scalar,Eigen::Dynamic,Eigen::Dynamic> LV;
+  cotmatrix_cached_helpers::values(V,F,LV);
+  sparse_cached(LV,data,L);
+}
+
+#ifdef IGL_STATIC_LIBRARY
+// Explicit template instantiation
+template void igl::cotmatrix_cached_precompute<Eigen::Matrix<double, -1, -1, 0, -1, -1>, Eigen::Matrix<int, -1, -1, 0, -1, -1>, double>(Eigen::MatrixBase<Eigen::Matrix<double, -1, -1, 0, -1, -1> > const&, Eigen::MatrixBase<Eigen::Matrix<int, -1, -1, 0, -1, -1> > const&, igl::sparse_cached_data&, Eigen::SparseMatrix<double, 0, int>&);
+template void igl::cotmatrix_cached<Eigen::Matrix<double, -1, -1, 0, -1, -1>, Eigen::Matrix<int, -1, -1, 0, -1, -1>, double>(Eigen::MatrixBase<Eigen::Matrix<double, -1, -1, 0, -1, -1> > const&, Eigen::MatrixBase<Eigen::Matrix<int, -1, -1, 0, -1, -1> > const&, igl::sparse_cached_data const&, Eigen::SparseMatrix<double, 0, int>&);
+#endif
@@ -0,0 +1,57 @@
+// This file is part of libigl, a simple c++ geometry processing library.
+//
+// Copyright (C) 2018 Floor Verhoeven
+//
+// This Source Code Form is subject to the terms of the Mozilla Public License
+// v. 2.0. If a copy of the MPL was not distributed with this file, You can
+// obtain one at http://mozilla.org/MPL/2.0/.
+#ifndef IGL_COTMATRIX_CACHED_H
+#define IGL_COTMATRIX_CACHED_H
+#include "igl_inline.h"
+#include "sparse_cached.h"
+#include <Eigen/Dense>
+#include <Eigen/Sparse>
+
+namespace igl
+{
+  // Constructs the cotangent stiffness matrix (discrete laplacian) like
+  // igl::cotmatrix, in two phases: the sparsity pattern is fixed once for a
+  // given F, and subsequent evaluations (e.g. on a deforming mesh) only
+  // compute the per-element cotangents and sum them directly into the
+  // non-zeros of L, in parallel.
+  //
+  // Inputs:
+  //   V  #V by dim list of mesh vertex positions
+  //   F  #F by simplex_size list of mesh elements (triangles or tetrahedra)
+  //   data  pattern from cotmatrix_cached_precompute (with the same F)
+  // Outputs:
+  //   data  cached pattern (precompute only)
+  //   L  #V by #V cotangent matrix, each row i corresponding to V(i,:)
+  //
+  // Example:
+  //   igl::sparse_cached_data L_data;
+  //   if (L.rows() == 0)
+  //     igl::cotmatrix_cached_precompute(V,F,L_data,L);
+  //   else
+  //     igl::cotmatrix_cached(V,F,L_data,L);
+  //
+  // See also: cotmatrix, sparse_cached
+  template <typename DerivedV, typename DerivedF, typename Scalar>
+  IGL_INLINE void cotmatrix_cached_precompute(
+    const Eigen::MatrixBase<DerivedV> & V,
+    const Eigen::MatrixBase<DerivedF> & F,
+    sparse_cached_data & data,
+    Eigen::SparseMatrix<Scalar>& L);
+  template <typename DerivedV, typename DerivedF, typename Scalar>
+  IGL_INLINE void cotmatrix_cached(
+    const Eigen::MatrixBase<DerivedV> & V,
+    const Eigen::MatrixBase<DerivedF> & F,
+    const sparse_cached_data & data,
+    Eigen::SparseMatrix<Scalar>& L);
+}
+
+#ifndef IGL_STATIC_LIBRARY
+#  include "cotmatrix_cached.cpp"
+#endif
+
+#endif
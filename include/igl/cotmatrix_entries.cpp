@@ -12,6 +12,7 @@
 #include "face_areas.h"
 #include "volume.h"
 #include "dihedral_angles.h"
+#include "parallel_for.h"
 
 #include "verbose.h"
 
@@ -39,8 +40,11 @@ IGL_INLINE void igl::cotmatrix_entries(
       Matrix<typename DerivedC::Scalar,Dynamic,3> l2;
       igl::squared_edge_lengths(V,F,l2);
       //Compute Edge lengths 
-      Matrix<typename DerivedC::Scalar,Dynamic,3> l;
-      l = l2.array().sqrt();
+      Matrix<typename DerivedC::Scalar,Dynamic,3> l(m,3);
+      parallel_for(m,[&](const int i)
+      {
+        l.row(i) = l2.row(i).array().sqrt();
+      },1000);
       
       // double area
       Matrix<typename DerivedC::Scalar,Dynamic,1> dblA;
@@ -48,12 +52,12 @@ IGL_INLINE void igl::cotmatrix_entries(
       // cotangents and diagonal entries for element matrices
       // correctly divided by 4 (alec 2010)
       C.resize(m,3);
-      for(int i = 0;i<m;i++)
+      parallel_for(m,[&](const int i)
       {
         C(i,0) = (l2(i,1) + l2(i,2) - l2(i,0))/dblA(i)/4.0;
         C(i,1) = (l2(i,2) + l2(i,0) - l2(i,1))/dblA(i)/4.0;
         C(i,2) = (l2(i,0) + l2(i,1) - l2(i,2))/dblA(i)/4.0;
-      }
+      },1000);
       break;
     }
     case 4:
@@ -51,8 +51,8 @@ IGL_INLINE void igl::edge_flaps(
   Eigen::MatrixXi & EI)
 {
   Eigen::MatrixXi allE;
-  std::vector<std::vector<int> > uE2E;
-  igl::unique_edge_map(F,allE,E,EMAP,uE2E);
+  Eigen::VectorXi uEC,uEE;
+  igl::unique_edge_map(F,allE,E,EMAP,uEC,uEE);
   // Const-ify to call overload
   const auto & cE = E;
   const auto & cEMAP = EMAP;
@@ -7,6 +7,8 @@
 // obtain one at http://mozilla.org/MPL/2.0/.
 #include "edge_topology.h"
 #include "is_edge_manifold.h"
+#include "parallel_for.h"
+#include "unique_edge_map.h"
 #include <algorithm>
 
 template<typename DerivedV, typename DerivedF>
@@ -26,81 +28,50 @@ IGL_INLINE void igl::edge_topology(
     return;
   }
   assert(igl::is_edge_manifold(F));
-  std::vector<std::vector<int> > ETT;
-  for(int f=0;f<F.rows();++f)
-    for (int i=0;i<3;++i)
-    {
-      // v1 v2 f vi
-      int v1 = F(f,i);
-      int v2 = F(f,(i+1)%3);
-      if (v1 > v2) std::swap(v1,v2);
-      std::vector<int> r(4);
-      r[0] = v1; r[1] = v2;
-      r[2] = f;  r[3] = i;
-      ETT.push_back(r);
-    }
-  std::sort(ETT.begin(),ETT.end());
-
-  // count the number of edges (assume manifoldness)
-  int En = 1; // the last is always counted
-  for(int i=0;i<int(ETT.size())-1;++i)
-    if (!((ETT[i][0] == ETT[i+1][0]) && (ETT[i][1] == ETT[i+1][1])))
-      ++En;
-
-  EV = Eigen::MatrixXi::Constant((int)(En),2,-1);
-  FE = Eigen::MatrixXi::Constant((int)(F.rows()),3,-1);
-  EF = Eigen::MatrixXi::Constant((int)(En),2,-1);
-  En = 0;
-
-  for(unsigned i=0;i<ETT.size();++i)
+  typedef Eigen::Matrix<typename DerivedF::Scalar,Eigen::Dynamic,2> MatrixX2I;
+  MatrixX2I E,uE;
+  Eigen::VectorXi EMAP,uEC,uEE;
+  unique_edge_map(F,E,uE,EMAP,uEC,uEE);
+  const int m = F.rows();
+  const int En = uE.rows();
+  EV.resize(En,2);
+  FE.resize(m,3);
+  EF.resize(En,2);
+  // Directed edge c*m+f is opposite corner c of face f, i.e. edge (c+1)%3
+  const auto face = [&m](const int e){ return e%m; };
+  const auto order = [&m](const int e){ return 3*(e%m) + (e/m+1)%3; };
+  parallel_for(En,[&](const int u)
   {
-    if (i == ETT.size()-1 ||
-        !((ETT[i][0] == ETT[i+1][0]) && (ETT[i][1] == ETT[i+1][1]))
-        )
+    EV(u,0) = std::min(uE(u,0),uE(u,1));
+    EV(u,1) = std::max(uE(u,0),uE(u,1));
+    // Sharing faces in (face,corner) order, the first one is the face on the
+    // left of the edge
+    int a = uEE(uEC(u));
+    int b = uEC(u+1)-uEC(u) > 1 ? uEE(uEC(u)+1) : -1;
+    if(b >= 0 && order(b) < order(a))
     {
-      // Border edge
-      std::vector<int>& r1 = ETT[i];
-      EV(En,0)     = r1[0];
-      EV(En,1)     = r1[1];
-      EF(En,0)    = r1[2];
-      FE(r1[2],r1[3]) = En;
+      std::swap(a,b);
     }
-    else
+    const int fa = face(a);
+    const int fb = b >= 0 ? face(b) : -1;
+    if(E(a,0) == EV(u,0))
     {
-      std::vector<int>& r1 = ETT[i];
-      std::vector<int>& r2 = ETT[i+1];
-      EV(En,0)     = r1[0];
-      EV(En,1)     = r1[1];
-      EF(En,0)    = r1[2];
-      EF(En,1)    = r2[2];
-      FE(r1[2],r1[3]) = En;
-      FE(r2[2],r2[3]) = En;
-      ++i; // skip the next one
-    }
-    ++En;
-  }
-
-  // Sort the relation EF, accordingly to EV
-  // the first one is the face on the left of the edge
-  for(unsigned i=0; i<EF.rows(); ++i)
-  {
-    int fid = EF(i,0);
-    bool flip = true;
-    // search for edge EV.row(i)
-    for (unsigned j=0; j<3; ++j)
+      EF(u,0) = fa;
+      EF(u,1) = fb;
+    }else
     {
-      if ((F(fid,j) == EV(i,0)) && (F(fid,(j+1)%3) == EV(i,1)))
-        flip = false;
+      EF(u,0) = fb;
+      EF(u,1) = fa;
     }
-
-    if (flip)
+  },1000);
+  // FE(f,i) is the edge from corner i to corner i+1, opposite corner i+2
+  parallel_for(m,[&](const int f)
+  {
+    for(int i = 0;i<3;i++)
     {
-      int tmp = EF(i,0);
-      EF(i,0) = EF(i,1);
-      EF(i,1) = tmp;
+      FE(f,i) = EMAP(((i+2)%3)*m+f);
     }
-  }
-
+  },1000);
 }
 
 #ifdef IGL_STATIC_LIBRARY
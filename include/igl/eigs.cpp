@@ -7,11 +7,136 @@
 // obtain one at http://mozilla.org/MPL/2.0/.
 #include "eigs.h"
 
-#include "cotmatrix.h"
+#include "parallel_for.h"
 #include "sort.h"
 #include "slice.h"
-#include "massmatrix.h"
+#include <Eigen/Eigenvalues>
+#include <algorithm>
+#include <cmath>
 #include <iostream>
+#include <vector>
+
+namespace igl
+{
+  namespace eigs_helpers
+  {
+    // Rows of tall matrices are processed in chunks of this size
+    const int chunk_size = 2048;
+
+    // H = Q' * W, accumulated over chunks of rows in parallel
+    template <typename DerivedQ, typename DerivedW, typename Scalar>
+    IGL_INLINE void inner(
+      const Eigen::MatrixBase<DerivedQ> & Q,
+      const Eigen::MatrixBase<DerivedW> & W,
+      Eigen::Matrix<Scalar,Eigen::Dynamic,Eigen::Dynamic> & H)
+    {
+      typedef Eigen::Matrix<Scalar,Eigen::Dynamic,Eigen::Dynamic> MatrixXS;
+      const int n = Q.rows();
+      const int nc = (n+chunk_size-1)/chunk_size;
+      H.setZero(Q.cols(),W.cols());
+      std::vector<MatrixXS> Hs;
+      parallel_for(
+        nc,
+        [&](const int nt)
+        {
+          Hs.assign(nt,MatrixXS::Zero(Q.cols(),W.cols()));
+        },
+        [&](const int c,const int t)
+        {
+          const int r = std::min(chunk_size,n-c*chunk_size);
+          Hs[t].noalias() +=
+            Q.middleRows(c*chunk_size,r).transpose()*
+            W.middleRows(c*chunk_size,r);
+        },
+        [&](const int t)
+        {
+          H += Hs[t];
+        },
+        2);
+    }
+
+    // X = Q * Y, by chunks of rows in parallel
+    template <typename DerivedQ, typename DerivedY, typename Scalar>
+    IGL_INLINE void times(
+      const Eigen::MatrixBase<DerivedQ> & Q,
+      const Eigen::MatrixBase<DerivedY> & Y,
+      Eigen::Matrix<Scalar,Eigen::Dynamic,Eigen::Dynamic> & X)
+    {
+      const int n = Q.rows();
+      X.resize(n,Y.cols());
+      parallel_for((n+chunk_size-1)/chunk_size,[&](const int c)
+      {
+        const int r = std::min(chunk_size,n-c*chunk_size);
+        X.middleRows(c*chunk_size,r).noalias() =
+          Q.middleRows(c*chunk_size,r)*Y;
+      },2);
+    }
+
+    // B-orthonormalize the columns of W against the (B-orthonormal) columns
+    // of Q and against each other, dropping numerically dependent columns
+    template <typename DerivedQ, typename Scalar>
+    IGL_INLINE void orthonormalize(
+      const Eigen::SparseMatrix<Scalar> & B,
+      const Eigen::MatrixBase<DerivedQ> & Q,
+      Eigen::Matrix<Scalar,Eigen::Dynamic,Eigen::Dynamic> & W)
+    {
+      typedef Eigen::Matrix<Scalar,Eigen::Dynamic,Eigen::Dynamic> MatrixXS;
+      const int n = W.rows();
+      MatrixXS BW,H;
+      // Classical Gram-Schmidt, twice is enough
+      for(int pass = 0;pass<2 && Q.cols()>0;pass++)
+      {
+        BW = B*W;
+        inner(Q,BW,H);
+        parallel_for((n+chunk_size-1)/chunk_size,[&](const int c)
+        {
+          const int r = std::min(chunk_size,n-c*chunk_size);
+          W.middleRows(c*chunk_size,r).noalias() -=
+            Q.middleRows(c*chunk_size,r)*H;
+        },2);
+      }
+      // W := W V D^-1/2 where W' B W = V D V'
+      BW = B*W;
+      inner(W,BW,H);
+      Eigen::SelfAdjointEigenSolver<MatrixXS> es(H);
+      const Scalar dmax = es.eigenvalues().cwiseAbs().maxCoeff();
+      std::vector<int> keep;
+      for(int i = 0;i<H.rows();i++)
+      {
+        if(es.eigenvalues()(i) > 1e-12*dmax && dmax > 0)
+        {
+          keep.push_back(i);
+        }
+      }
+      MatrixXS Y(H.rows(),keep.size());
+      for(int i = 0;i<(int)keep.size();i++)
+      {
+        Y.col(i) =
+          es.eigenvectors().col(keep[i])/std::sqrt(es.eigenvalues()(keep[i]));
+      }
+      MatrixXS WY;
+      times(W,Y,WY);
+      W.swap(WY);
+    }
+
+    // Maximum absolute column sum
+    template <typename Scalar>
+    IGL_INLINE Scalar norm1(const Eigen::SparseMatrix<Scalar> & A)
+    {
+      Scalar norm = 0;
+      for(int j = 0;j<A.outerSize();j++)
+      {
+        Scalar sum = 0;
+        for(typename Eigen::SparseMatrix<Scalar>::InnerIterator it(A,j);it;++it)
+        {
+          sum += std::abs(it.value());
+        }
+        norm = std::max(norm,sum);
+      }
+      return norm;
+    }
+  }
+}
 
 template <
   typename Atype,
@@ -23,152 +148,230 @@ IGL_INLINE bool igl::eigs(
   const Eigen::SparseMatrix<Btype> & iB,
   const size_t k,
   const EigsType type,
+  const eigs_params & params,
   Eigen::PlainObjectBase<DerivedU> & sU,
-  Eigen::PlainObjectBase<DerivedS> & sS)
+  Eigen::PlainObjectBase<DerivedS> & sS,
+  eigs_report & report)
 {
   using namespace Eigen;
   using namespace std;
-  const size_t n = A.rows();
+  using namespace igl::eigs_helpers;
+  typedef Atype Scalar;
+  typedef Matrix<Scalar,Dynamic,Dynamic> MatrixXS;
+  typedef Matrix<Scalar,Dynamic,1> VectorXS;
+  const int n = A.rows();
   assert(A.cols() == n && "A should be square.");
   assert(iB.rows() == n && "B should be match A's dims.");
   assert(iB.cols() == n && "B should be square.");
-  assert(type == EIGS_TYPE_SM && "Only low frequencies are supported");
-  DerivedU U(n,k);
-  DerivedS S(k,1);
-  typedef Atype Scalar;
-  typedef Eigen::Matrix<typename DerivedU::Scalar,DerivedU::RowsAtCompileTime,1> VectorXS;
-  // Rescale B for better numerics
-  const Scalar rescale = std::abs(iB.diagonal().maxCoeff());
-  const Eigen::SparseMatrix<Btype> B = iB/rescale;
+  assert((int)k <= n && "k should be at most #A.");
+  const SparseMatrix<Scalar> B = iB.template cast<Scalar>();
+  report = eigs_report();
+  report.residuals.setZero(k);
+  if(k == 0)
+  {
+    sU.resize(n,0);
+    sS.resize(0,1);
+    return true;
+  }
 
-  Scalar tol = 1e-4;
-  Scalar conv = 1e-14;
-  int max_iter = 100;
-  int i = 0;
-  //std::cout<<"start"<<std::endl;
-  while(true)
+  const Scalar normA = norm1(A);
+  const Scalar normB = norm1(B);
+  // Operator whose dominant eigen vectors are the wanted ones
+  SimplicialLDLT<SparseMatrix<Scalar> > solver;
+  switch(type)
   {
-    //std::cout<<i<<std::endl;
-    // Random initial guess
-    VectorXS y = VectorXS::Random(n,1);
-    Scalar eff_sigma = 0;
-    if(i>0)
+    default:
+      assert(false && "Not supported");
+      return false;
+    case EIGS_TYPE_SM:
     {
-      eff_sigma = 1e-8+std::abs(S(i-1));
+      // Small shift so that A - sigma B is not singular for (semi-)definite
+      // A. It should not be much closer to a (zero) eigen value than the
+      // spread of the wanted spectrum, otherwise that mode swamps every
+      // Krylov block and the others are lost in the orthogonalization.
+      const Scalar sigma = -params.shift*normA/normB;
+      solver.compute(A-sigma*B);
+      break;
     }
-    // whether to use rayleigh quotient method
-    bool ray = false;
-    Scalar err = std::numeric_limits<Scalar>::infinity();
-    int iter;
-    Scalar sigma = std::numeric_limits<Scalar>::infinity();
-    VectorXS x;
-    for(iter = 0;iter<max_iter;iter++)
+    case EIGS_TYPE_LM:
+      solver.compute(B);
+      break;
+  }
+  switch(solver.info())
+  {
+    case Eigen::Success:
+      break;
+    case Eigen::NumericalIssue:
+      cerr<<"Error: Numerical issue."<<endl;
+      return false;
+    default:
+      cerr<<"Error: Other."<<endl;
+      return false;
+  }
+  const auto apply = [&](const MatrixXS & X,MatrixXS & Y)
+  {
+    const MatrixXS R = type == EIGS_TYPE_SM ? MatrixXS(B*X) : MatrixXS(A*X);
+    Y.resize(n,X.cols());
+    parallel_for(X.cols(),[&](const int c)
     {
-      if(i>0 && !ray)
-      {
-        // project-out existing modes
-        for(int j = 0;j<i;j++)
-        {
-          const VectorXS u = U.col(j);
-          y = (y - u*u.dot(B*y)/u.dot(B * u)).eval();
-        }
-      }
-      // normalize
-      x = y/sqrt(y.dot(B*y));
+      Y.col(c) = solver.solve(R.col(c));
+    },2);
+    report.solves += X.cols();
+  };
 
-      // current guess at eigen value
-      sigma = x.dot(A*x)/x.dot(B*x);
-      //x *= sigma>0?1.:-1.;
+  const int b = min(n,
+    params.block_size > 0 ? params.block_size : min((int)k,16));
+  const int ncv = min(n,
+    max((int)k+2*b,
+      params.subspace_size > 0 ? params.subspace_size : 2*(int)k+2*b));
+  // Number of Ritz vectors kept at each restart
+  const int nkeep = min((int)k+b,ncv-b);
 
-      Scalar err_prev = err;
-      err = (A*x-sigma*B*x).array().abs().maxCoeff();
-      if(err<conv)
+  // B-orthonormal basis Q of the current subspace and its projection
+  // G = Q' A Q
+  MatrixXS Q(n,ncv),G(ncv,ncv);
+  int j = 0;
+  // Block the subspace is grown from
+  MatrixXS S = MatrixXS::Random(n,b);
+  orthonormalize(B,Q.leftCols(0),S);
+  bool first = true;
+  VectorXS theta;
+  MatrixXS Y;
+  vector<int> order;
+  for(report.restarts = 0;;report.restarts++)
+  {
+    // Grow the subspace
+    while(j < ncv && S.cols() > 0)
+    {
+      MatrixXS W;
+      if(first)
       {
-        break;
+        W = S;
+        first = false;
+      }else
+      {
+        apply(S,W);
+        orthonormalize(B,Q.leftCols(j),W);
       }
-      if(ray || err<tol)
+      if(W.cols() > ncv-j)
       {
-        eff_sigma = sigma;
-        ray = true;
+        W.conservativeResize(n,ncv-j);
       }
-
-      Scalar tikhonov = std::abs(eff_sigma)<1e-12?1e-10:0;
-      switch(type)
+      const int w = W.cols();
+      if(w == 0)
       {
-        default:
-          assert(false && "Not supported");
-          break;
-        case EIGS_TYPE_SM:
-        {
-          SimplicialLDLT<SparseMatrix<Scalar> > solver;
-          const SparseMatrix<Scalar> C = A-eff_sigma*B+tikhonov*B;
-          //mw.save(C,"C");
-          //mw.save(eff_sigma,"eff_sigma");
-          //mw.save(tikhonov,"tikhonov");
-          solver.compute(C);
-          switch(solver.info())
-          {
-            case Eigen::Success:
-              break;
-            case Eigen::NumericalIssue:
-              cerr<<"Error: Numerical issue."<<endl;
-              return false;
-            default:
-              cerr<<"Error: Other."<<endl;
-              return false;
-          }
-          const VectorXS rhs = B*x;
-          y = solver.solve(rhs);
-          //mw.save(rhs,"rhs");
-          //mw.save(y,"y");
-          //mw.save(x,"x");
-          //mw.write("eigs.mat");
-          //if(i == 1)
-          //return false;
-          break;
-        }
+        break;
       }
+      Q.middleCols(j,w) = W;
+      const MatrixXS AW = A*W;
+      MatrixXS H;
+      inner(Q.leftCols(j+w),AW,H);
+      G.block(0,j,j+w,w) = H;
+      G.block(j,0,w,j) = H.topRows(j).transpose();
+      j += w;
+      S.swap(W);
     }
-    if(iter == max_iter)
+
+    // Rayleigh-Ritz
+    SelfAdjointEigenSolver<MatrixXS> es(G.topLeftCorner(j,j));
+    theta = es.eigenvalues();
+    Y = es.eigenvectors();
+    order.resize(j);
+    for(int i = 0;i<j;i++)
     {
-      cerr<<"Failed to converge."<<endl;
-      return false;
+      order[i] = i;
     }
-    if(
-      i==0 || 
-      (S.head(i).array()-sigma).abs().maxCoeff()>1e-14 ||
-      ((U.leftCols(i).transpose()*B*x).array().abs()<=1e-7).all()
-      )
+    sort(order.begin(),order.end(),[&](const int x,const int y)
+    {
+      return type == EIGS_TYPE_SM ?
+        abs(theta(x)) < abs(theta(y)) : abs(theta(x)) > abs(theta(y));
+    });
+    const int nk = min((int)k,j);
+    const int nr = min(max(nkeep,nk),j);
+    MatrixXS Yr(j,nr);
+    VectorXS theta_r(nr);
+    for(int i = 0;i<nr;i++)
     {
-      //cout<<"Found "<<i<<"th mode"<<endl;
-      U.col(i) = x;
-      S(i) = sigma;
-      i++;
-      if(i == k)
+      Yr.col(i) = Y.col(order[i]);
+      theta_r(i) = theta(order[i]);
+    }
+    MatrixXS U;
+    times(Q.leftCols(j),Yr,U);
+
+    // Residuals of the wanted pairs
+    const MatrixXS AU = A*U.leftCols(nk);
+    const MatrixXS BU = B*U.leftCols(nk);
+    vector<int> unconverged;
+    report.num_converged = 0;
+    for(int i = 0;i<nk;i++)
+    {
+      report.residuals(i) =
+        (AU.col(i)-theta_r(i)*BU.col(i)).norm()/
+        ((abs(theta_r(i))*normB+normA)*U.col(i).norm());
+      if(report.residuals(i) <= params.tol || j == n)
       {
-        break;
+        report.num_converged++;
+      }else
+      {
+        unconverged.push_back(i);
       }
-    }else
+    }
+    const bool done = report.num_converged == (int)k;
+    if(done || report.restarts >= params.max_restarts || j == n ||
+      (j < ncv && S.cols() == 0))
     {
-      //std::cout<<"i: "<<i<<std::endl;
-      //std::cout<<"  "<<S.head(i).transpose()<<" << "<<sigma<<std::endl;
-      //std::cout<<"  "<<(S.head(i).array()-sigma).abs().maxCoeff()<<std::endl;
-      //std::cout<<"  "<<(U.leftCols(i).transpose()*B*x).array().abs().transpose()<<std::endl;
-      // restart with new random guess.
-      cout<<"igl::eigs RESTART"<<endl;
+      // finally sort
+      VectorXi I;
+      igl::sort(theta_r.head(nk).eval(),1,false,sS,I);
+      MatrixXS Uk = U.leftCols(nk);
+      igl::slice(Uk,I,2,sU);
+      VectorXd residuals = report.residuals;
+      for(int i = 0;i<nk;i++)
+      {
+        report.residuals(i) = residuals(I(i));
+      }
+      if(!done)
+      {
+        cerr<<"Failed to converge ("<<report.num_converged<<"/"<<k<<
+          " eigen pairs)."<<endl;
+      }
+      return done;
+    }
+
+    // Thick restart: keep the best Ritz pairs and grow the subspace from the
+    // unconverged wanted Ritz vectors
+    j = nr;
+    Q.leftCols(j) = U;
+    G.topLeftCorner(j,j) = theta_r.asDiagonal();
+    S.resize(n,min(b,(int)unconverged.size()));
+    for(int i = 0;i<S.cols();i++)
+    {
+      S.col(i) = U.col(unconverged[i]);
     }
   }
-  // finally sort
-  VectorXi I;
-  igl::sort(S,1,false,sS,I);
-  igl::slice(U,I,2,sU);
-  sS /= rescale;
-  sU /= sqrt(rescale);
-  return true;
+}
+
+template <
+  typename Atype,
+  typename Btype,
+  typename DerivedU,
+  typename DerivedS>
+IGL_INLINE bool igl::eigs(
+  const Eigen::SparseMatrix<Atype> & A,
+  const Eigen::SparseMatrix<Btype> & B,
+  const size_t k,
+  const EigsType type,
+  Eigen::PlainObjectBase<DerivedU> & sU,
+  Eigen::PlainObjectBase<DerivedS> & sS)
+{
+  eigs_params params;
+  eigs_report report;
+  return eigs(A,B,k,type,params,sU,sS,report);
 }
 
 #ifdef IGL_STATIC_LIBRARY
 // Explicit template instantiation
+template bool igl::eigs<double, double, Eigen::Matrix<double, -1, -1, 0, -1, -1>, Eigen::Matrix<double, -1, 1, 0, -1, 1> >(Eigen::SparseMatrix<double, 0, int> const&, Eigen::SparseMatrix<double, 0, int> const&, const size_t, igl::EigsType, igl::eigs_params const&, Eigen::PlainObjectBase<Eigen::Matrix<double, -1, -1, 0, -1, -1> >&, Eigen::PlainObjectBase<Eigen::Matrix<double, -1, 1, 0, -1, 1> >&, igl::eigs_report&);
 template bool igl::eigs<double, double, Eigen::Matrix<double, -1, -1, 0, -1, -1>, Eigen::Matrix<double, -1, 1, 0, -1, 1> >(Eigen::SparseMatrix<double, 0, int> const&, Eigen::SparseMatrix<double, 0, int> const&, const size_t, igl::EigsType, Eigen::PlainObjectBase<Eigen::Matrix<double, -1, -1, 0, -1, -1> >&, Eigen::PlainObjectBase<Eigen::Matrix<double, -1, 1, 0, -1, 1> >&);
 #ifdef WIN32
 template bool igl::eigs<double, double, Eigen::Matrix<double,-1,-1,0,-1,-1>, Eigen::Matrix<double,-1,1,0,-1,1> >(Eigen::SparseMatrix<double,0,int> const &,Eigen::SparseMatrix<double,0,int> const &, const size_t, igl::EigsType, Eigen::PlainObjectBase< Eigen::Matrix<double,-1,-1,0,-1,-1> > &, Eigen::PlainObjectBase<Eigen::Matrix<double,-1,1,0,-1,1> > &);
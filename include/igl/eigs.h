@@ -20,27 +20,47 @@ namespace igl
   //
   // Solutions are approximate and sorted. 
   //
-  // Ideally one should use ARPACK and the Eigen unsupported ARPACK module.
-  // This implementation does simple, naive power iterations.
+  // The eigen pairs are found with a thick-restarted block Krylov (block
+  // Lanczos) method with full B-orthogonalization and Rayleigh-Ritz
+  // extraction. For the small magnitude end the Krylov subspaces are built
+  // with the shift-invert operator (A - sigma B)^-1 B for sigma ~ 0, so
+  // A - sigma B is factored only once; the blocks of right-hand sides are
+  // solved and orthogonalized in parallel.
   //
   // Inputs:
   //   A  #A by #A symmetric matrix
   //   B  #A by #A symmetric positive-definite matrix
   //   k  number of eigen pairs to compute
   //   type  whether to extract from the high or low end
+  //   params  struct of additional parameters (see below)
   // Outputs:
   //   sU  #A by k list of sorted eigen vectors (descending)
   //   sS  k list of sorted eigen values (descending)
+  //   report  convergence report (see below)
+  // Returns true iff all k eigen pairs converged
   //
-  // Known issues:
-  //   - only the 'sm' small magnitude eigen values are well supported
-  //   
   enum EigsType
   {
     EIGS_TYPE_SM = 0,
     EIGS_TYPE_LM = 1,
     NUM_EIGS_TYPES = 2
   };
+  struct eigs_params;
+  struct eigs_report;
+  template <
+    typename Atype,
+    typename Btype,
+    typename DerivedU,
+    typename DerivedS>
+  IGL_INLINE bool eigs(
+    const Eigen::SparseMatrix<Atype> & A,
+    const Eigen::SparseMatrix<Btype> & B,
+    const size_t k,
+    const EigsType type,
+    const eigs_params & params,
+    Eigen::PlainObjectBase<DerivedU> & sU,
+    Eigen::PlainObjectBase<DerivedS> & sS,
+    eigs_report & report);
   template <
     typename Atype,
     typename Btype,
@@ -55,6 +75,47 @@ namespace igl
     Eigen::PlainObjectBase<DerivedS> & sS);
 }
 
+struct igl::eigs_params
+{
+  // Input parameters for eigs:
+  //   tol  Threshold on the relative residual
+  //     |A u - s B u| / ((|s| |B|_1 + |A|_1) |u|) of each eigen pair {1e-10}
+  //   max_restarts  Maximum number of restarts of the Krylov subspace {100}
+  //   block_size  Number of vectors the Krylov subspace is grown by at a time
+  //     (0 = min(k,16)) {0}
+  //   subspace_size  Maximum dimension of the Krylov subspace (0 = 2k+2
+  //     block_size) {0}
+  //   shift  Relative shift of the small magnitude end: eigs factors
+  //     A + shift*|A|_1/|B|_1*B {1e-8}
+  double tol;
+  int max_restarts;
+  int block_size;
+  int subspace_size;
+  double shift;
+  eigs_params():
+    tol(1e-10),
+    max_restarts(100),
+    block_size(0),
+    subspace_size(0),
+    shift(1e-8)
+    {};
+};
+
+struct igl::eigs_report
+{
+  // Output of eigs:
+  //   restarts  number of restarts used
+  //   solves  number of applications of the (shift-inverted) operator to a
+  //     vector
+  //   num_converged  number of converged eigen pairs
+  //   residuals  k list of relative residuals, in the order of sS
+  int restarts;
+  int solves;
+  int num_converged;
+  Eigen::VectorXd residuals;
+  eigs_report():restarts(0),solves(0),num_converged(0){};
+};
+
 #ifndef IGL_STATIC_LIBRARY
 #include "eigs.cpp"
 #endif
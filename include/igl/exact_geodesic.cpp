@@ -13,6 +13,7 @@
 // Compiled into a single file by Zhongshi Jiang
 
 #include <igl/PI.h>
+#include <igl/parallel_for.h>
 #include <algorithm>
 #include <cassert>
 #include <cmath>
@@ -20,6 +21,7 @@
 #include <ctime>
 #include <fstream>
 #include <iostream>
+#include <limits>
 #include <set>
 #include <vector>
 #include <memory>
@@ -2457,12 +2459,16 @@ inline void GeodesicAlgorithmExact::propagate(std::vector<SurfacePoint>& sources
 inline bool GeodesicAlgorithmExact::check_stop_conditions(unsigned& index)
 {
 	double queue_distance = (*m_queue.begin())->min();
-	if(queue_distance < stop_distance())
+	if(queue_distance >= stop_distance())		//the front passed the maximum distance
+	{
+		return true;
+	}
+	if(m_stop_vertices.empty())
 	{
 		return false;
 	}
 
-	while(index < m_stop_vertices.size())
+	while(index < m_stop_vertices.size())		//or all stop points are settled
 	{
 		vertex_pointer v = m_stop_vertices[index].first;
 		edge_pointer edge = v->adjacent_edges()[0];				//take any edge
@@ -3155,6 +3161,50 @@ inline void GeodesicAlgorithmExact::print_statistics()
 }		//geodesic
 }
 
+namespace igl
+{
+  namespace exact_geodesic_helpers
+  {
+    template <typename DerivedV, typename DerivedF>
+    IGL_INLINE void initialize_mesh(
+      const Eigen::MatrixBase<DerivedV> &V,
+      const Eigen::MatrixBase<DerivedF> &F,
+      igl::geodesic::Mesh & mesh)
+    {
+      assert(V.cols() == 3 && F.cols() == 3 && "Only support 3D triangle mesh");
+      std::vector<typename DerivedV::Scalar> points(V.rows() * V.cols());
+      std::vector<typename DerivedF::Scalar> faces(F.rows() * F.cols());
+      for (int i = 0; i < points.size(); i++)
+      {
+        points[i] = V(i / 3, i % 3);
+      }
+      for (int i = 0; i < faces.size(); i++)
+      {
+        faces[i] = F(i / 3, i % 3);
+      }
+      mesh.initialize_mesh_data(points, faces);
+    }
+
+    // Propagate from source until all targets are covered or max_distance
+    // is reached, and read off the distance of each target (GEODESIC_INF if
+    // it was not reached)
+    IGL_INLINE void distances(
+      igl::geodesic::GeodesicAlgorithmExact & algorithm,
+      std::vector<igl::geodesic::SurfacePoint> & source,
+      std::vector<igl::geodesic::SurfacePoint> & target,
+      const double max_distance,
+      std::vector<double> & D)
+    {
+      algorithm.propagate(source, max_distance, &target);
+      D.resize(target.size());
+      for (size_t i = 0; i < target.size(); i++)
+      {
+        algorithm.best_source(target[i], D[i]);
+      }
+    }
+  }
+}
+
 template <
   typename DerivedV,
   typename DerivedF,
@@ -3170,23 +3220,12 @@ IGL_INLINE void igl::exact_geodesic(
   const Eigen::MatrixBase<DerivedFS> &FS,
   const Eigen::MatrixBase<DerivedVT> &VT,
   const Eigen::MatrixBase<DerivedFT> &FT,
+  const typename DerivedD::Scalar max_distance,
   Eigen::PlainObjectBase<DerivedD> &D)
 {
-  assert(V.cols() == 3 && F.cols() == 3 && "Only support 3D triangle mesh");
   assert(VS.cols() ==1 && FS.cols() == 1 && VT.cols() == 1 && FT.cols() ==1 && "Only support one dimensional inputs");
-  std::vector<typename DerivedV::Scalar> points(V.rows() * V.cols());
-  std::vector<typename DerivedF::Scalar> faces(F.rows() * F.cols());
-  for (int i = 0; i < points.size(); i++)
-  {
-    points[i] = V(i / 3, i % 3);
-  }
-  for (int i = 0; i < faces.size(); i++)
-  {
-    faces[i] = F(i / 3, i % 3);
-  }
-
   igl::geodesic::Mesh mesh;
-  mesh.initialize_mesh_data(points, faces);
+  exact_geodesic_helpers::initialize_mesh(V, F, mesh);
   igl::geodesic::GeodesicAlgorithmExact exact_algorithm(&mesh);
 
   std::vector<igl::geodesic::SurfacePoint> source(VS.rows() + FS.rows());
@@ -3197,7 +3236,7 @@ IGL_INLINE void igl::exact_geodesic(
   }
   for (int i = 0; i < FS.rows(); i++)
   {
-    source[i] = (igl::geodesic::SurfacePoint(&mesh.faces()[FS(i)]));
+    source[VS.rows() + i] = (igl::geodesic::SurfacePoint(&mesh.faces()[FS(i)]));
   }
 
   for (int i = 0; i < VT.rows(); i++)
@@ -3206,19 +3245,104 @@ IGL_INLINE void igl::exact_geodesic(
   }
   for (int i = 0; i < FT.rows(); i++)
   {
-    target[i] = (igl::geodesic::SurfacePoint(&mesh.faces()[FT(i)]));
+    target[VT.rows() + i] = (igl::geodesic::SurfacePoint(&mesh.faces()[FT(i)]));
   }
 
-  exact_algorithm.propagate(source);
-  std::vector<igl::geodesic::SurfacePoint> path;
+  std::vector<double> dist;
+  exact_geodesic_helpers::distances(
+    exact_algorithm, source, target,
+    std::min<double>(max_distance, igl::geodesic::GEODESIC_INF), dist);
   D.resize(target.size(), 1);
   for (int i = 0; i < target.size(); i++)
   {
-    exact_algorithm.trace_back(target[i], path);
-    D(i) = igl::geodesic::length(path);
+    // A truncated propagation can leave overestimates beyond max_distance
+    D(i) = dist[i] < igl::geodesic::GEODESIC_INF && dist[i] <= max_distance ?
+      dist[i] : std::numeric_limits<typename DerivedD::Scalar>::infinity();
   }
 }
 
+template <
+  typename DerivedV,
+  typename DerivedF,
+  typename DerivedVS,
+  typename DerivedFS,
+  typename DerivedVT,
+  typename DerivedFT,
+  typename DerivedD>
+IGL_INLINE void igl::exact_geodesic(
+  const Eigen::MatrixBase<DerivedV> &V,
+  const Eigen::MatrixBase<DerivedF> &F,
+  const Eigen::MatrixBase<DerivedVS> &VS,
+  const Eigen::MatrixBase<DerivedFS> &FS,
+  const Eigen::MatrixBase<DerivedVT> &VT,
+  const Eigen::MatrixBase<DerivedFT> &FT,
+  Eigen::PlainObjectBase<DerivedD> &D)
+{
+  return exact_geodesic(V, F, VS, FS, VT, FT,
+    std::numeric_limits<typename DerivedD::Scalar>::infinity(), D);
+}
+
+template <
+  typename DerivedV,
+  typename DerivedF,
+  typename DerivedVT,
+  typename DerivedD>
+IGL_INLINE void igl::exact_geodesic(
+  const Eigen::MatrixBase<DerivedV> &V,
+  const Eigen::MatrixBase<DerivedF> &F,
+  const std::vector<Eigen::VectorXi> &VS,
+  const Eigen::MatrixBase<DerivedVT> &VT,
+  const typename DerivedD::Scalar max_distance,
+  Eigen::PlainObjectBase<DerivedD> &D)
+{
+  assert(VT.cols() == 1 && "Only support one dimensional inputs");
+  // The mesh is only read during propagation, so all threads share it
+  igl::geodesic::Mesh mesh;
+  exact_geodesic_helpers::initialize_mesh(V, F, mesh);
+  const int num_sets = VS.size();
+  D.resize(VT.rows(), num_sets);
+  // Interval lists are allocated once per thread and reset by each propagation
+  std::vector<std::unique_ptr<igl::geodesic::GeodesicAlgorithmExact> >
+    algorithms;
+  igl::parallel_for(
+    num_sets,
+    [&](const size_t nt)
+    {
+      algorithms.resize(nt);
+    },
+    [&](const int s, const size_t t)
+    {
+      if (!algorithms[t])
+      {
+        algorithms[t].reset(new igl::geodesic::GeodesicAlgorithmExact(&mesh));
+      }
+      std::vector<igl::geodesic::SurfacePoint> source(VS[s].size());
+      std::vector<igl::geodesic::SurfacePoint> target(VT.rows());
+      for (int i = 0; i < VS[s].size(); i++)
+      {
+        source[i] = igl::geodesic::SurfacePoint(&mesh.vertices()[VS[s](i)]);
+      }
+      for (int i = 0; i < VT.rows(); i++)
+      {
+        target[i] = igl::geodesic::SurfacePoint(&mesh.vertices()[VT(i)]);
+      }
+      std::vector<double> dist;
+      exact_geodesic_helpers::distances(
+        *algorithms[t], source, target,
+        std::min<double>(max_distance, igl::geodesic::GEODESIC_INF), dist);
+      for (int i = 0; i < VT.rows(); i++)
+      {
+        D(i, s) =
+          dist[i] < igl::geodesic::GEODESIC_INF && dist[i] <= max_distance ?
+          dist[i] : std::numeric_limits<typename DerivedD::Scalar>::infinity();
+      }
+    },
+    [](const size_t){},
+    2);
+}
+
 #ifdef IGL_STATIC_LIBRARY
 template void igl::exact_geodesic<Eigen::Matrix<double, -1, -1, 0, -1, -1>, Eigen::Matrix<int, -1, -1, 0, -1, -1>, Eigen::Matrix<int, -1, 1, 0, -1, 1>, Eigen::Matrix<int, -1, 1, 0, -1, 1>, Eigen::Matrix<int, -1, 1, 0, -1, 1>, Eigen::Matrix<int, -1, 1, 0, -1, 1>, Eigen::Matrix<double, -1, 1, 0, -1, 1>>(Eigen::MatrixBase<Eigen::Matrix<double, -1, -1, 0, -1, -1>> const &, Eigen::MatrixBase<Eigen::Matrix<int, -1, -1, 0, -1, -1>> const &, Eigen::MatrixBase<Eigen::Matrix<int, -1, 1, 0, -1, 1>> const &, Eigen::MatrixBase<Eigen::Matrix<int, -1, 1, 0, -1, 1>> const &, Eigen::MatrixBase<Eigen::Matrix<int, -1, 1, 0, -1, 1>> const &, Eigen::MatrixBase<Eigen::Matrix<int, -1, 1, 0, -1, 1>> const &, Eigen::PlainObjectBase<Eigen::Matrix<double, -1, 1, 0, -1, 1>> &);
+template void igl::exact_geodesic<Eigen::Matrix<double, -1, -1, 0, -1, -1>, Eigen::Matrix<int, -1, -1, 0, -1, -1>, Eigen::Matrix<int, -1, 1, 0, -1, 1>, Eigen::Matrix<int, -1, 1, 0, -1, 1>, Eigen::Matrix<int, -1, 1, 0, -1, 1>, Eigen::Matrix<int, -1, 1, 0, -1, 1>, Eigen::Matrix<double, -1, 1, 0, -1, 1>>(Eigen::MatrixBase<Eigen::Matrix<double, -1, -1, 0, -1, -1>> const &, Eigen::MatrixBase<Eigen::Matrix<int, -1, -1, 0, -1, -1>> const &, Eigen::MatrixBase<Eigen::Matrix<int, -1, 1, 0, -1, 1>> const &, Eigen::MatrixBase<Eigen::Matrix<int, -1, 1, 0, -1, 1>> const &, Eigen::MatrixBase<Eigen::Matrix<int, -1, 1, 0, -1, 1>> const &, Eigen::MatrixBase<Eigen::Matrix<int, -1, 1, 0, -1, 1>> const &, double, Eigen::PlainObjectBase<Eigen::Matrix<double, -1, 1, 0, -1, 1>> &);
+template void igl::exact_geodesic<Eigen::Matrix<double, -1, -1, 0, -1, -1>, Eigen::Matrix<int, -1, -1, 0, -1, -1>, Eigen::Matrix<int, -1, 1, 0, -1, 1>, Eigen::Matrix<double, -1, -1, 0, -1, -1>>(Eigen::MatrixBase<Eigen::Matrix<double, -1, -1, 0, -1, -1>> const &, Eigen::MatrixBase<Eigen::Matrix<int, -1, -1, 0, -1, -1>> const &, std::vector<Eigen::Matrix<int, -1, 1, 0, -1, 1>, std::allocator<Eigen::Matrix<int, -1, 1, 0, -1, 1> > > const &, Eigen::MatrixBase<Eigen::Matrix<int, -1, 1, 0, -1, 1>> const &, double, Eigen::PlainObjectBase<Eigen::Matrix<double, -1, -1, 0, -1, -1>> &);
 #endif
@@ -11,6 +11,7 @@
 
 #include "igl_inline.h"
 #include <Eigen/Core>
+#include <vector>
 
 namespace igl 
 {
@@ -29,6 +30,8 @@ namespace igl
   //
   // Note: 
   //      Specifying a face as target/source means its center. 
+  //      Propagation stops as soon as all targets are covered, so few nearby
+  //      targets are much cheaper than all vertices.
   //
     template <
     typename DerivedV,
@@ -46,6 +49,57 @@ namespace igl
       const Eigen::MatrixBase<DerivedVT> &VT,
       const Eigen::MatrixBase<DerivedFT> &FT,
       Eigen::PlainObjectBase<DerivedD> &D);
+  // Same as above, but propagation also stops once the front passes
+  // max_distance from the sources
+  //
+  // Inputs:
+  //   max_distance  largest distance of interest
+  // Output:
+  //   D  #VT+#FT by 1 vector of geodesic distances, infinity for targets
+  //     farther than max_distance
+    template <
+    typename DerivedV,
+    typename DerivedF,
+    typename DerivedVS,
+    typename DerivedFS,
+    typename DerivedVT,
+    typename DerivedFT,
+    typename DerivedD>
+    IGL_INLINE void exact_geodesic(
+      const Eigen::MatrixBase<DerivedV> &V,
+      const Eigen::MatrixBase<DerivedF> &F,
+      const Eigen::MatrixBase<DerivedVS> &VS,
+      const Eigen::MatrixBase<DerivedFS> &FS,
+      const Eigen::MatrixBase<DerivedVT> &VT,
+      const Eigen::MatrixBase<DerivedFT> &FT,
+      const typename DerivedD::Scalar max_distance,
+      Eigen::PlainObjectBase<DerivedD> &D);
+  // Distances from several independent sets of source vertices, propagated
+  // in parallel over a single shared mesh structure. For example, all-pairs
+  // geodesics between feature points P are given by VS = {[P(0)],[P(1)],...}
+  // and VT = P.
+  //
+  // Inputs:
+  //   V  #V by 3 list of 3D vertex positions
+  //   F  #F by 3 list of mesh faces
+  //   VS  #sets list of lists of source vertex indices
+  //   VT  #VT by 1 vector specifying indices of target vertices
+  //   max_distance  largest distance of interest (infinity for no limit)
+  // Output:
+  //   D  #VT by #sets matrix of geodesic distances of each target to the
+  //     nearest source of each set, infinity beyond max_distance
+    template <
+    typename DerivedV,
+    typename DerivedF,
+    typename DerivedVT,
+    typename DerivedD>
+    IGL_INLINE void exact_geodesic(
+      const Eigen::MatrixBase<DerivedV> &V,
+      const Eigen::MatrixBase<DerivedF> &F,
+      const std::vector<Eigen::VectorXi> &VS,
+      const Eigen::MatrixBase<DerivedVT> &VT,
+      const typename DerivedD::Scalar max_distance,
+      Eigen::PlainObjectBase<DerivedD> &D);
 }
 
 #ifndef IGL_STATIC_LIBRARY
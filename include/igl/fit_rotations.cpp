@@ -12,7 +12,15 @@
 #include "polar_dec.h"
 #include "polar_svd.h"
 #include "C_STR.h"
+#include "parallel_for.h"
+#include <Eigen/Cholesky>
+#include <Eigen/Geometry>
+#include <algorithm>
+#include <cmath>
 #include <iostream>
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#  include <intrin.h>
+#endif
 
 template <typename DerivedS, typename DerivedD>
 IGL_INLINE void igl::fit_rotations(
@@ -110,6 +118,185 @@ IGL_INLINE void igl::fit_rotations_planar(
 }
 
 
+IGL_INLINE igl::FitRotationsKernel igl::fit_rotations_kernel()
+{
+  static const FitRotationsKernel kernel = []()->FitRotationsKernel
+  {
+    bool sse = false, avx = false;
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+    int info[4];
+    __cpuid(info, 1);
+    sse = (info[3] & (1 << 25)) != 0;
+    // AVX needs the OS to save the ymm registers (OSXSAVE and XCR0)
+    avx = (info[2] & (1 << 28)) && (info[2] & (1 << 27)) &&
+      (_xgetbv(0) & 6) == 6;
+#elif (defined(__GNUC__) || defined(__clang__)) && \
+  (defined(__x86_64__) || defined(__i386__))
+    __builtin_cpu_init();
+    sse = __builtin_cpu_supports("sse");
+    avx = __builtin_cpu_supports("avx");
+#endif
+#ifdef __AVX__
+    if(avx)
+    {
+      return FIT_ROTATIONS_KERNEL_AVX;
+    }
+#endif
+#ifdef __SSE__
+    if(sse)
+    {
+      return FIT_ROTATIONS_KERNEL_SSE;
+    }
+#endif
+    (void)sse;
+    (void)avx;
+    return FIT_ROTATIONS_KERNEL_SCALAR;
+  }();
+  return kernel;
+}
+
+template <typename DerivedS, typename DerivedD>
+IGL_INLINE void igl::fit_rotations_fast(
+  const Eigen::PlainObjectBase<DerivedS> & S,
+  const FitRotationsKernel kernel,
+  Eigen::PlainObjectBase<DerivedD> & R)
+{
+  typedef typename DerivedS::Scalar SScalar;
+  typedef typename DerivedD::Scalar DScalar;
+  typedef Eigen::Matrix<double,3,3> Mat3d;
+  typedef Eigen::Matrix<double,3,1> Vec3d;
+  const int dim = 3;
+  assert(S.cols() == dim);
+  const int nr = S.rows()/dim;
+  assert(nr * dim == S.rows());
+  R.resize(dim,dim*nr);
+
+  const FitRotationsKernel k = std::min(kernel,fit_rotations_kernel());
+  const int width =
+    k == FIT_ROTATIONS_KERNEL_AVX ? 8 : (k == FIT_ROTATIONS_KERNEL_SSE ? 4 : 1);
+  const bool refine = sizeof(SScalar) > sizeof(float);
+
+  // Polish a rotation close to the optimum of max tr(Rᵀ A) with Newton steps
+  // R ← R exp([ω]) on SO(3), falling back to the robust step of [Müller et
+  // al. 2016] where the Hessian is not definite (A close to singular)
+  const auto refine_rotation = [](const Mat3d & A, Mat3d & Ri)
+  {
+    const double tol = 1e-15*A.norm();
+    for(int iter = 0;iter<6;iter++)
+    {
+      const Mat3d M = Ri.transpose()*A;
+      const Vec3d g(M(2,1)-M(1,2), M(0,2)-M(2,0), M(1,0)-M(0,1));
+      if(g.norm() <= tol)
+      {
+        break;
+      }
+      const Mat3d H =
+        M.trace()*Mat3d::Identity() - 0.5*(M+M.transpose());
+      const Eigen::LLT<Mat3d> llt(H);
+      Vec3d omega;
+      if(llt.info() == Eigen::Success && H.diagonal().minCoeff() > tol)
+      {
+        omega = llt.solve(g);
+      }else
+      {
+        omega = g/(std::abs(M.trace()) + 1e-9);
+      }
+      const double w = omega.norm();
+      if(!(w > 0))
+      {
+        break;
+      }
+      Ri = Ri * Eigen::AngleAxisd(w,omega/w).toRotationMatrix();
+    }
+    // Re-orthonormalize the accumulated product
+    Ri.col(2) = Ri.col(0).cross(Ri.col(1)).normalized();
+    Ri.col(0).normalize();
+    Ri.col(1) = Ri.col(2).cross(Ri.col(0));
+  };
+
+  // Decompose the matrices r*width,...,r*width+width-1 of the stack
+  const auto fit_block = [&](const int b)
+  {
+    const int r0 = b*width;
+    const int numMats = std::min(width,nr-r0);
+    Eigen::Matrix<float,3*8,3> siBig, riBig;
+    if(numMats < width)
+    {
+      // Keep the unused lanes finite
+      siBig.setZero();
+    }
+    for(int m = 0;m<numMats;m++)
+    {
+      for(int i = 0;i<dim;i++)
+      {
+        for(int j = 0;j<dim;j++)
+        {
+          siBig(i + 3*m, j) = S(i*nr + r0 + m, j);
+        }
+      }
+    }
+    switch(k)
+    {
+#ifdef __AVX__
+      case FIT_ROTATIONS_KERNEL_AVX:
+      {
+        polar_svd3x3_avx(siBig, riBig);
+        break;
+      }
+#endif
+#ifdef __SSE__
+      case FIT_ROTATIONS_KERNEL_SSE:
+      {
+        Eigen::Matrix<float,3*4,3> si4 = siBig.topRows(3*4), ri4;
+        polar_svd3x3_sse(si4, ri4);
+        riBig.topRows(3*4) = ri4;
+        break;
+      }
+#endif
+      default:
+      {
+        Eigen::Matrix3f si1 = siBig.topRows(3), ri1;
+        polar_svd3x3(si1, ri1);
+        riBig.topRows(3) = ri1;
+        break;
+      }
+    }
+    for(int m = 0;m<numMats;m++)
+    {
+      const int r = r0 + m;
+      if(refine)
+      {
+        Mat3d A;
+        for(int i = 0;i<dim;i++)
+        {
+          for(int j = 0;j<dim;j++)
+          {
+            A(i,j) = S(i*nr + r, j);
+          }
+        }
+        Mat3d Ri = riBig.block(3*m,0,3,3).template cast<double>();
+        refine_rotation(A,Ri);
+        R.block(0,r*dim,dim,dim) = Ri.transpose().template cast<DScalar>();
+      }else
+      {
+        // Not sure why polar_dec computes transpose...
+        R.block(0,r*dim,dim,dim) =
+          riBig.block(3*m,0,3,3).transpose().template cast<DScalar>();
+      }
+      assert(R.block(0,r*dim,dim,dim).determinant() >= 0);
+    }
+  };
+  igl::parallel_for((nr+width-1)/width,fit_block,1000/width);
+}
+
+template <typename DerivedS, typename DerivedD>
+IGL_INLINE void igl::fit_rotations_fast(
+  const Eigen::PlainObjectBase<DerivedS> & S,
+  Eigen::PlainObjectBase<DerivedD> & R)
+{
+  return fit_rotations_fast(S,FIT_ROTATIONS_KERNEL_AVX,R);
+}
+
 #ifdef __SSE__
 IGL_INLINE void igl::fit_rotations_SSE(
   const Eigen::MatrixXf & S, 
@@ -222,4 +409,8 @@ template void igl::fit_rotations<Eigen::Matrix<double, -1, -1, 0, -1, -1>, Eigen
 template void igl::fit_rotations_planar<Eigen::Matrix<double, -1, -1, 0, -1, -1>, Eigen::Matrix<double, -1, -1, 0, -1, -1> >(Eigen::PlainObjectBase<Eigen::Matrix<double, -1, -1, 0, -1, -1> > const&, Eigen::PlainObjectBase<Eigen::Matrix<double, -1, -1, 0, -1, -1> >&);
 template void igl::fit_rotations_planar<Eigen::Matrix<float, -1, -1, 0, -1, -1>, Eigen::Matrix<float, -1, -1, 0, -1, -1> >(Eigen::PlainObjectBase<Eigen::Matrix<float, -1, -1, 0, -1, -1> > const&, Eigen::PlainObjectBase<Eigen::Matrix<float, -1, -1, 0, -1, -1> >&);
 template void igl::fit_rotations<Eigen::Matrix<float,-1,-1,0,-1,-1>,Eigen::Matrix<float,-1,-1,0,-1,-1> >(Eigen::PlainObjectBase<Eigen::Matrix<float,-1,-1,0,-1,-1> > const &,bool,Eigen::PlainObjectBase<Eigen::Matrix<float,-1,-1,0,-1,-1> > &);
+template void igl::fit_rotations_fast<Eigen::Matrix<double, -1, -1, 0, -1, -1>, Eigen::Matrix<double, -1, -1, 0, -1, -1> >(Eigen::PlainObjectBase<Eigen::Matrix<double, -1, -1, 0, -1, -1> > const&, Eigen::PlainObjectBase<Eigen::Matrix<double, -1, -1, 0, -1, -1> >&);
+template void igl::fit_rotations_fast<Eigen::Matrix<double, -1, -1, 0, -1, -1>, Eigen::Matrix<double, -1, -1, 0, -1, -1> >(Eigen::PlainObjectBase<Eigen::Matrix<double, -1, -1, 0, -1, -1> > const&, igl::FitRotationsKernel, Eigen::PlainObjectBase<Eigen::Matrix<double, -1, -1, 0, -1, -1> >&);
+template void igl::fit_rotations_fast<Eigen::Matrix<float, -1, -1, 0, -1, -1>, Eigen::Matrix<float, -1, -1, 0, -1, -1> >(Eigen::PlainObjectBase<Eigen::Matrix<float, -1, -1, 0, -1, -1> > const&, Eigen::PlainObjectBase<Eigen::Matrix<float, -1, -1, 0, -1, -1> >&);
+template void igl::fit_rotations_fast<Eigen::Matrix<float, -1, -1, 0, -1, -1>, Eigen::Matrix<float, -1, -1, 0, -1, -1> >(Eigen::PlainObjectBase<Eigen::Matrix<float, -1, -1, 0, -1, -1> > const&, igl::FitRotationsKernel, Eigen::PlainObjectBase<Eigen::Matrix<float, -1, -1, 0, -1, -1> >&);
 #endif
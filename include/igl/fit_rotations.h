@@ -44,6 +44,40 @@ namespace igl
   IGL_INLINE void fit_rotations_planar(
     const Eigen::PlainObjectBase<DerivedS> & S,
           Eigen::PlainObjectBase<DerivedD> & R);
+  // Kernels available to fit_rotations_fast
+  enum FitRotationsKernel
+  {
+    FIT_ROTATIONS_KERNEL_SCALAR = 0,
+    FIT_ROTATIONS_KERNEL_SSE = 1,
+    FIT_ROTATIONS_KERNEL_AVX = 2
+  };
+  // Returns the widest kernel that was compiled in (see __SSE__, __AVX__) and
+  // that the running CPU supports. The result is computed once.
+  IGL_INLINE FitRotationsKernel fit_rotations_kernel();
+
+  // FIT_ROTATIONS_FAST Same as fit_rotations but decomposes 1, 4 or 8
+  // covariance matrices at a time with the 3x3 SVD kernel returned by
+  // fit_rotations_kernel, and processes the stack in parallel. The kernels
+  // work in single precision: for double precision input each rotation is
+  // then refined in double precision ("A Robust Method to Extract the
+  // Rotational Part of Deformations" [Müller et al. 2016]), so that the
+  // result matches fit_rotations(S,false,R) instead of being rounded to float.
+  //
+  // Inputs:
+  //   S  nr*3 by 3 stack of covariance matrices
+  //   kernel  kernel to use, clamped to fit_rotations_kernel() {fastest}
+  // Outputs:
+  //   R  3 by 3 * nr list of rotations
+  //
+  template <typename DerivedS, typename DerivedD>
+  IGL_INLINE void fit_rotations_fast(
+    const Eigen::PlainObjectBase<DerivedS> & S,
+    const FitRotationsKernel kernel,
+          Eigen::PlainObjectBase<DerivedD> & R);
+  template <typename DerivedS, typename DerivedD>
+  IGL_INLINE void fit_rotations_fast(
+    const Eigen::PlainObjectBase<DerivedS> & S,
+          Eigen::PlainObjectBase<DerivedD> & R);
 #ifdef __SSE__
   IGL_INLINE void fit_rotations_SSE( const Eigen::MatrixXf & S, Eigen::MatrixXf & R);
   IGL_INLINE void fit_rotations_SSE( const Eigen::MatrixXd & S, Eigen::MatrixXd & R);
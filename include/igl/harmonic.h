@@ -8,6 +8,7 @@
 #ifndef IGL_HARMONIC_H
 #define IGL_HARMONIC_H
 #include "igl_inline.h"
+#include "min_quad_with_fixed.h"
 #include <Eigen/Core>
 #include <Eigen/Sparse>
 namespace igl
@@ -81,6 +82,35 @@ namespace igl
     const Eigen::MatrixBase<Derivedbc> & bc,
     const int k,
     Eigen::PlainObjectBase<DerivedW> & W);
+  // Compute a harmonic map using a given Laplacian and mass matrix and a
+  // given min_quad_with_fixed solver
+  //
+  // Inputs:
+  //   L  #V by #V discrete (integrated) Laplacian  
+  //   M  #V by #V mass matrix
+  //   b  #b boundary indices into V
+  //   bc  #b by #W list of boundary values
+  //   k  power of harmonic operation (1: harmonic, 2: biharmonic, etc)
+  //   data  solver settings, e.g. data.backend =
+  //     min_quad_with_fixed_data<double>::MULTIGRID for large meshes
+  // Outputs:
+  //   data  factorization of the k-harmonic system with fixed b (can be
+  //     reused with min_quad_with_fixed_solve for other boundary values)
+  //   W  #V by #W list of weights
+  template <
+    typename DerivedL,
+    typename DerivedM,
+    typename Derivedb,
+    typename Derivedbc,
+    typename DerivedW>
+  IGL_INLINE bool harmonic(
+    const Eigen::SparseMatrix<DerivedL> & L,
+    const Eigen::SparseMatrix<DerivedM> & M,
+    const Eigen::MatrixBase<Derivedb> & b,
+    const Eigen::MatrixBase<Derivedbc> & bc,
+    const int k,
+    min_quad_with_fixed_data<DerivedL> & data,
+    Eigen::PlainObjectBase<DerivedW> & W);
   // Build the discrete k-harmonic operator (computing integrated quantities).
   // That is, if the k-harmonic PDE is Q x = 0, then this minimizes x' Q x
   //
@@ -7,6 +7,374 @@
 // obtain one at http://mozilla.org/MPL/2.0/.
 #include "hausdorff.h"
 #include "point_mesh_squared_distance.h"
+#include "AABB.h"
+#include "point_simplex_squared_distance.h"
+#include "parallel_for.h"
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <functional>
+#include <limits>
+#include <queue>
+#include <random>
+#include <vector>
+
+namespace igl
+{
+  namespace hausdorff_helpers
+  {
+    // Upper bound on the distance to B of any point of the triangle with corner
+    // positions V and corner distances d to B
+    template <typename DerivedV, typename Scalar>
+    IGL_INLINE Scalar triangle_upper_bound(
+      const Eigen::MatrixBase<DerivedV>& V,
+      const Scalar * d)
+    {
+      // e  3-long vector of opposite edge lengths
+      Eigen::Matrix<typename DerivedV::Scalar,1,3> e;
+      // Maximum edge length
+      Scalar e_max = 0;
+      for(int i=0;i<3;i++)
+      {
+        e(i) = (V.row((i+1)%3)-V.row((i+2)%3)).norm();
+        e_max = std::max(e_max,Scalar(e(i)));
+      }
+      // Semiperimeter
+      const Scalar s = (e(0)+e(1)+e(2))*0.5;
+      // Area
+      const Scalar A = sqrt(s*(s-e(0))*(s-e(1))*(s-e(2)));
+      // Circumradius
+      const Scalar R = e(0)*e(1)*e(2)/(4.*A);
+      // inradius
+      const Scalar r = A/s;
+      Scalar u1 = std::numeric_limits<Scalar>::infinity();
+      Scalar u2 = 0;
+      for(int i=0;i<3;i++)
+      {
+        // u1 is the minimum of corner distances + maximum adjacent edge 
+        u1 = std::min(u1,d[i] + std::max(e((i+1)%3),e((i+2)%3)));
+        // u2 first takes the maximum over corner distances
+        u2 = std::max(u2,d[i]);
+      }
+      // u2 is the distance from the circumcenter/midpoint of obtuse edge plus
+      // the largest corner distance 
+      u2 += (s-r>2.*R ? R : 0.5*e_max);
+      return std::min(u1,u2);
+    }
+
+    // Directed Hausdorff distance from the surface of (VA,FA) to (VB,FB) by
+    // branch and bound over the hierarchy of A.
+    //
+    // Two upper bounds are kept for each node and (sub)triangle of A:
+    //   - the distance to B of a point (box center, corners) plus the largest
+    //     distance from it to the rest (half diagonal, triangle_upper_bound),
+    //     since the distance to B is 1-Lipschitz;
+    //   - the largest distance of the box corners (triangle corners) to the
+    //     primitive of B closest to the center (a corner): the distance to a
+    //     single triangle is convex, so it is largest at a corner, and it
+    //     bounds the distance to B. This is tight where A lies along B.
+    // The node or triangle with the largest upper bound is refined first, until
+    // it is within tol of the largest distance of a point of A seen so far.
+    //
+    // Inputs:
+    //   l  known lower bound (e.g. from the other direction)
+    // Outputs:
+    //   l  lower bound, max(input l, largest distance seen)
+    //   u  upper bound on the directed distance, u <= l + tol
+    template <
+      typename DerivedVA,
+      typename DerivedFA,
+      typename DerivedVB,
+      typename DerivedFB,
+      typename Scalar>
+    IGL_INLINE void directed_hausdorff(
+      const Eigen::PlainObjectBase<DerivedVA> & VA, 
+      const Eigen::PlainObjectBase<DerivedFA> & FA,
+      const igl::AABB<DerivedVA,3> & treeA,
+      const Eigen::PlainObjectBase<DerivedVB> & VB, 
+      const Eigen::PlainObjectBase<DerivedFB> & FB,
+      const igl::AABB<DerivedVB,3> & treeB,
+      const Scalar tol,
+      Scalar & l,
+      Scalar & u)
+    {
+      typedef Eigen::Matrix<Scalar,1,3> RowVector3S;
+      typedef Eigen::Matrix<Scalar,3,3> Matrix3S;
+      typedef typename igl::AABB<DerivedVB,3>::RowVectorDIMS RowVectorB;
+      typedef typename DerivedVB::Scalar ScalarB;
+      typedef igl::AABB<DerivedVA,3> TreeA;
+      typedef typename TreeA::RowVectorDIMS RowVectorA;
+      typedef Eigen::AlignedBox<typename TreeA::Scalar,3> BoxA;
+      // Distance of p to B and closest primitive i, given an upper bound up on
+      // the distance (via the distance of a nearby point) which prunes the
+      // search in treeB
+      const auto dist_to_B = [&](
+        const RowVector3S & p, const Scalar up, int & i)->Scalar
+      {
+        const RowVectorB q = p.template cast<ScalarB>();
+        RowVectorB c;
+        i = -1;
+        // Slightly inflated so that round-off never cuts off the true distance
+        const ScalarB up_sqr_d = ScalarB(up*up*(1.+1e-10));
+        return sqrt(Scalar(treeB.squared_distance(VB,FB,q,up_sqr_d,i,c)));
+      };
+      // Distance of p to primitive i of B
+      const auto dist_to_prim = [&](const RowVector3S & p, const int i)->Scalar
+      {
+        const RowVectorB q = p.template cast<ScalarB>();
+        RowVectorB c;
+        ScalarB sqr_d;
+        igl::point_simplex_squared_distance<3>(q,VB,FB,i,sqr_d,c);
+        return sqrt(Scalar(sqr_d));
+      };
+      // Largest distance of a point of A seen so far, shared by all threads
+      std::atomic<Scalar> L(l);
+      const auto raise = [&L](const Scalar d)
+      {
+        Scalar cur = L.load();
+        while(d > cur && !L.compare_exchange_weak(cur,d)){}
+      };
+      // Distances and closest primitives of the vertices of A, computed on
+      // demand (IA is written before DA)
+      std::vector<std::atomic<Scalar> > DA(VA.rows());
+      std::vector<std::atomic<int> > IA(VA.rows());
+      igl::parallel_for(VA.rows(),[&](const int v)
+      {
+        DA[v].store(-1,std::memory_order_relaxed);
+        IA[v].store(-1,std::memory_order_relaxed);
+      },10000);
+      // Node of treeA, or a sub-triangle if node is NULL
+      struct Item
+      {
+        // Upper bound on the distance to B of the points of the item
+        Scalar u;
+        const TreeA * node;
+        // Distance and closest primitive of the center of the node's box
+        Scalar dc;
+        int ic;
+        // Corners of the sub-triangle, their distances and closest primitives
+        Matrix3S T;
+        Scalar d[3];
+        int id[3];
+        bool operator<(const Item & that) const { return u < that.u; }
+      };
+      typedef std::priority_queue<Item> Queue;
+      // Primitives of a node with at most max leaves
+      const std::function<bool(const TreeA *,int,std::vector<int> &)>
+        gather_primitives = [&](
+          const TreeA * node, const int max, std::vector<int> & P)->bool
+      {
+        if(node->is_leaf())
+        {
+          P.push_back(node->m_primitive);
+          return (int)P.size() <= max;
+        }
+        return
+          (!node->m_left || gather_primitives(node->m_left,max,P)) &&
+          (!node->m_right || gather_primitives(node->m_right,max,P));
+      };
+      const auto push_node = [&](
+        Queue & Q, const TreeA * node, const Scalar dc, const int ic)
+      {
+        Item item;
+        item.node = node;
+        item.dc = dc;
+        item.ic = ic;
+        item.u = dc + 0.5*Scalar(node->m_box.diagonal().norm());
+        if(ic >= 0)
+        {
+          // The points of the node lie in the convex hull of the vertices of
+          // its triangles (if there are few) or else of the corners of its box
+          Scalar m = 0;
+          std::vector<int> P;
+          if(gather_primitives(node,16,P))
+          {
+            for(int p = 0;p<(int)P.size() && m<item.u;p++)
+            {
+              for(int i = 0;i<3 && m<item.u;i++)
+              {
+                const RowVector3S v =
+                  VA.row(FA(P[p],i)).template cast<Scalar>();
+                m = std::max(m,dist_to_prim(v,ic));
+              }
+            }
+          }else
+          {
+            for(int k = 0;k<8 && m<item.u;k++)
+            {
+              const RowVectorA corner =
+                node->m_box.corner(typename BoxA::CornerType(k)).transpose();
+              m = std::max(m,dist_to_prim(corner.template cast<Scalar>(),ic));
+            }
+          }
+          item.u = std::min(item.u,m);
+        }
+        if(item.u > L.load())
+        {
+          Q.push(item);
+        }
+      };
+      const auto push_triangle = [&](
+        Queue & Q, const Matrix3S & T, const Scalar * d, const int * id)
+      {
+        Item item;
+        item.node = NULL;
+        item.T = T;
+        for(int i = 0;i<3;i++)
+        {
+          item.d[i] = d[i];
+          item.id[i] = id[i];
+          raise(d[i]);
+        }
+        item.u = triangle_upper_bound(T,d);
+        for(int j = 0;j<3 && item.u > L.load();j++)
+        {
+          if(id[j] < 0)
+          {
+            continue;
+          }
+          Scalar m = 0;
+          for(int i = 0;i<3 && m<item.u;i++)
+          {
+            m = std::max(m,i==j ? d[i] : dist_to_prim(T.row(i),id[j]));
+          }
+          item.u = std::min(item.u,m);
+        }
+        if(item.u > L.load())
+        {
+          Q.push(item);
+        }
+      };
+      // Refine the item of Q with the largest upper bound until all are within
+      // tol of L, or until Q holds max_size items
+      const auto refine = [&](Queue & Q, const size_t max_size)
+      {
+        while(!Q.empty() && Q.size() < max_size && Q.top().u > L.load() + tol)
+        {
+          const Item item = Q.top();
+          Q.pop();
+          if(item.u <= L.load())
+          {
+            continue;
+          }
+          if(item.node && item.node->is_leaf())
+          {
+            const RowVector3S c =
+              item.node->m_box.center().transpose().template cast<Scalar>();
+            const int f = item.node->m_primitive;
+            Matrix3S T;
+            Scalar d[3];
+            int id[3];
+            for(int i = 0;i<3;i++)
+            {
+              const int v = FA(f,i);
+              T.row(i) = VA.row(v).template cast<Scalar>();
+              d[i] = DA[v].load(std::memory_order_acquire);
+              if(d[i] < 0)
+              {
+                d[i] = dist_to_B(T.row(i),item.dc+(T.row(i)-c).norm(),id[i]);
+                IA[v].store(id[i],std::memory_order_relaxed);
+                DA[v].store(d[i],std::memory_order_release);
+              }else
+              {
+                id[i] = IA[v].load(std::memory_order_relaxed);
+              }
+            }
+            push_triangle(Q,T,d,id);
+          }else if(item.node)
+          {
+            const RowVector3S c =
+              item.node->m_box.center().transpose().template cast<Scalar>();
+            for(const TreeA * child : {item.node->m_left,item.node->m_right})
+            {
+              if(!child)
+              {
+                continue;
+              }
+              const RowVector3S cc =
+                child->m_box.center().transpose().template cast<Scalar>();
+              int ic;
+              const Scalar dc = dist_to_B(cc,item.dc+(cc-c).norm(),ic);
+              push_node(Q,child,dc,ic);
+            }
+          }else
+          {
+            // Split into four at the edge midpoints: M.row(i) is opposite
+            // corner i
+            Matrix3S M;
+            Scalar dm[3];
+            int im[3];
+            for(int i = 0;i<3;i++)
+            {
+              const int a = (i+1)%3;
+              const int b = (i+2)%3;
+              M.row(i) = 0.5*(item.T.row(a)+item.T.row(b));
+              const Scalar h = 0.5*(item.T.row(a)-item.T.row(b)).norm();
+              dm[i] = dist_to_B(M.row(i),std::min(item.d[a],item.d[b])+h,im[i]);
+            }
+            for(int i = 0;i<3;i++)
+            {
+              // Corner i with the midpoints of its two edges
+              const int a = (i+1)%3;
+              const int b = (i+2)%3;
+              Matrix3S T;
+              T.row(i) = item.T.row(i);
+              T.row(a) = M.row(b);
+              T.row(b) = M.row(a);
+              Scalar d[3];
+              int id[3];
+              d[i] = item.d[i];
+              d[a] = dm[b];
+              d[b] = dm[a];
+              id[i] = item.id[i];
+              id[a] = im[b];
+              id[b] = im[a];
+              push_triangle(Q,T,d,id);
+            }
+            push_triangle(Q,M,dm,im);
+          }
+        }
+      };
+      // Refine serially until there are enough independent items to keep all
+      // threads busy, then refine each of them in parallel. All share L, so
+      // work found unnecessary by one thread is culled by the others.
+      Queue Q;
+      if(FA.rows() > 0)
+      {
+        const RowVector3S c =
+          treeA.m_box.center().transpose().template cast<Scalar>();
+        int ic;
+        const Scalar dc =
+          dist_to_B(c,std::numeric_limits<Scalar>::infinity(),ic);
+        push_node(Q,&treeA,dc,ic);
+      }
+      refine(Q,1024);
+      std::vector<Item> W;
+      W.reserve(Q.size());
+      for(;!Q.empty();Q.pop())
+      {
+        W.push_back(Q.top());
+      }
+      // Mix the items with the largest bounds (most work) into all threads'
+      // slices
+      std::shuffle(W.begin(),W.end(),std::minstd_rand(0));
+      std::vector<Scalar> U(W.size(),0);
+      igl::parallel_for(W.size(),[&](const int w)
+      {
+        Queue Qw;
+        Qw.push(W[w]);
+        refine(Qw,std::numeric_limits<size_t>::max());
+        U[w] = Qw.empty() ? 0 : Qw.top().u;
+      },2);
+      l = L.load();
+      u = l;
+      for(const Scalar Uw : U)
+      {
+        u = std::max(u,Uw);
+      }
+    }
+  }
+}
 
 template <
   typename DerivedVA, 
@@ -36,6 +404,39 @@ IGL_INLINE void igl::hausdorff(
   d = sqrt(std::max(dba,dab));
 }
 
+template <
+  typename DerivedVA, 
+  typename DerivedFA,
+  typename DerivedVB,
+  typename DerivedFB,
+  typename Scalar>
+IGL_INLINE void igl::hausdorff(
+  const Eigen::PlainObjectBase<DerivedVA> & VA, 
+  const Eigen::PlainObjectBase<DerivedFA> & FA,
+  const Eigen::PlainObjectBase<DerivedVB> & VB, 
+  const Eigen::PlainObjectBase<DerivedFB> & FB,
+  const Scalar tol,
+  Scalar & l,
+  Scalar & u)
+{
+  assert(VA.cols() == 3 && "VA should contain 3d points");
+  assert(FA.cols() == 3 && "FA should contain triangles");
+  assert(VB.cols() == 3 && "VB should contain 3d points");
+  assert(FB.cols() == 3 && "FB should contain triangles");
+  assert(tol > 0 && "tol should be positive");
+  igl::AABB<DerivedVA,3> treeA;
+  treeA.init(VA,FA);
+  igl::AABB<DerivedVB,3> treeB;
+  treeB.init(VB,FB);
+  // The second direction only has to refine parts that could exceed the
+  // lower bound found by the first
+  l = 0;
+  Scalar uAB,uBA;
+  hausdorff_helpers::directed_hausdorff(VA,FA,treeA,VB,FB,treeB,tol,l,uAB);
+  hausdorff_helpers::directed_hausdorff(VB,FB,treeB,VA,FA,treeA,tol,l,uBA);
+  u = std::max(uAB,uBA);
+}
+
 template <
   typename DerivedV,
   typename Scalar>
@@ -45,45 +446,20 @@ IGL_INLINE void igl::hausdorff(
   Scalar & l,
   Scalar & u)
 {
-  // e  3-long vector of opposite edge lengths
-  Eigen::Matrix<typename DerivedV::Scalar,1,3> e;
-  // Maximum edge length
-  Scalar e_max = 0;
-  for(int i=0;i<3;i++)
-  {
-    e(i) = (V.row((i+1)%3)-V.row((i+2)%3)).norm();
-    e_max = std::max(e_max,e(i));
-  }
-  // Semiperimeter
-  const Scalar s = (e(0)+e(1)+e(2))*0.5;
-  // Area
-  const Scalar A = sqrt(s*(s-e(0))*(s-e(1))*(s-e(2)));
-  // Circumradius
-  const Scalar R = e(0)*e(1)*e(2)/(4.*A);
-  // inradius
-  const Scalar r = A/s;
-  // Initialize lower bound to ∞
-  l = std::numeric_limits<Scalar>::infinity();
-  // d  3-long vector of distance from each corner to B
-  Eigen::Matrix<typename DerivedV::Scalar,1,3> d;
-  Scalar u1 = std::numeric_limits<Scalar>::infinity();
-  Scalar u2 = 0;
+  // Initialize lower bound to 0
+  l = 0;
+  // d  3 distances from each corner to B
+  Scalar d[3];
   for(int i=0;i<3;i++)
   {
-    d(i) = dist_to_B(V(i,0),V(i,1),V(i,2));
+    d[i] = dist_to_B(V(i,0),V(i,1),V(i,2));
     // Lower bound is simply the max over vertex distances
-    l = std::max(d(i),l);
-    // u1 is the minimum of corner distances + maximum adjacent edge 
-    u1 = std::min(u1,d(i) + std::max(e((i+1)%3),e((i+2)%3)));
-    // u2 first takes the maximum over corner distances
-    u2 = std::max(u2,d(i));
+    l = std::max(d[i],l);
   }
-  // u2 is the distance from the circumcenter/midpoint of obtuse edge plus the
-  // largest corner distance 
-  u2 += (s-r>2.*R ? R : 0.5*e_max);
-  u = std::min(u1,u2);
+  u = hausdorff_helpers::triangle_upper_bound(V,d);
 }
 
 #ifdef IGL_STATIC_LIBRARY
 template void igl::hausdorff<Eigen::Matrix<double, -1, -1, 0, -1, -1>, Eigen::Matrix<int, -1, -1, 0, -1, -1>, Eigen::Matrix<double, -1, -1, 0, -1, -1>, Eigen::Matrix<int, -1, -1, 0, -1, -1>, double>(Eigen::PlainObjectBase<Eigen::Matrix<double, -1, -1, 0, -1, -1> > const&, Eigen::PlainObjectBase<Eigen::Matrix<int, -1, -1, 0, -1, -1> > const&, Eigen::PlainObjectBase<Eigen::Matrix<double, -1, -1, 0, -1, -1> > const&, Eigen::PlainObjectBase<Eigen::Matrix<int, -1, -1, 0, -1, -1> > const&, double&);
+template void igl::hausdorff<Eigen::Matrix<double, -1, -1, 0, -1, -1>, Eigen::Matrix<int, -1, -1, 0, -1, -1>, Eigen::Matrix<double, -1, -1, 0, -1, -1>, Eigen::Matrix<int, -1, -1, 0, -1, -1>, double>(Eigen::PlainObjectBase<Eigen::Matrix<double, -1, -1, 0, -1, -1> > const&, Eigen::PlainObjectBase<Eigen::Matrix<int, -1, -1, 0, -1, -1> > const&, Eigen::PlainObjectBase<Eigen::Matrix<double, -1, -1, 0, -1, -1> > const&, Eigen::PlainObjectBase<Eigen::Matrix<int, -1, -1, 0, -1, -1> > const&, double, double&, double&);
 #endif
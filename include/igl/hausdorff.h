@@ -27,7 +27,8 @@ namespace igl
   // Hausdorff distance between the non-convex, block letter V polygon (with 7
   // vertices) in 2D and its convex hull. The Hausdorff distance is defined by
   // the midpoint in the middle of the segment across the concavity and some
-  // non-vertex point _on the edge_ of the V.
+  // non-vertex point _on the edge_ of the V. See the overload with a
+  // tolerance below for the distance between the surfaces.
   //
   // Inputs:
   //   VA  #VA by 3 list of vertex positions
@@ -51,6 +52,43 @@ namespace igl
     const Eigen::PlainObjectBase<DerivedVB> & VB, 
     const Eigen::PlainObjectBase<DerivedFB> & FB,
     Scalar & d);
+  // Compute the Hausdorff distance between the surfaces of (VA,FA) and
+  // (VB,FB) up to a tolerance, by branch and bound [Tang et al. 2009]. An
+  // AABB tree is built on each mesh. For each direction, the nodes of the
+  // first tree are bounded by the distance of their box center to the other
+  // mesh plus their half diagonal, and the triangles in the leaves by the
+  // triangle bounds below. Whatever has the largest upper bound is refined
+  // first (nodes into children, triangles into four) and whatever cannot
+  // exceed the largest distance found so far is culled. Distance queries are
+  // pruned with the (Lipschitz) bound given by a nearby point. Once the queue
+  // is large enough its entries are refined in parallel, sharing the lower
+  // bound, so l and u may vary between runs (always within tol).
+  //
+  // Inputs:
+  //   VA  #VA by 3 list of vertex positions
+  //   FA  #FA by 3 list of face indices into VA
+  //   VB  #VB by 3 list of vertex positions
+  //   FB  #FB by 3 list of face indices into VB
+  //   tol  positive absolute tolerance
+  // Outputs:
+  //   l  lower bound on the Hausdorff distance (attained by a point on one of
+  //     the surfaces)
+  //   u  upper bound on the Hausdorff distance, u <= l + tol
+  //
+  template <
+    typename DerivedVA, 
+    typename DerivedFA,
+    typename DerivedVB,
+    typename DerivedFB,
+    typename Scalar>
+  IGL_INLINE void hausdorff(
+    const Eigen::PlainObjectBase<DerivedVA> & VA, 
+    const Eigen::PlainObjectBase<DerivedFA> & FA,
+    const Eigen::PlainObjectBase<DerivedVB> & VB, 
+    const Eigen::PlainObjectBase<DerivedFB> & FB,
+    const Scalar tol,
+    Scalar & l,
+    Scalar & u);
   // Compute lower and upper bounds (l,u) on the Hausdorff distance between a triangle
   // (V) and a pointset (e.g., mesh, triangle soup) given by a distance function
   // handle (dist_to_B).
@@ -0,0 +1,186 @@
+// This file is part of libigl, a simple c++ geometry processing library.
+//
+// Copyright (C) 2018 Floor Verhoeven
+//
+// This Source Code Form is subject to the terms of the Mozilla Public License
+// v. 2.0. If a copy of the MPL was not distributed with this file, You can
+// obtain one at http://mozilla.org/MPL/2.0/.
+#include "heat_geodesics.h"
+#include "avg_edge_length.h"
+#include "boundary_facets.h"
+#include "cotmatrix.h"
+#include "doublearea.h"
+#include "grad.h"
+#include "massmatrix.h"
+#include "parallel_for.h"
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+
+template <typename DerivedV, typename DerivedF, typename Scalar>
+IGL_INLINE bool igl::heat_geodesics_precompute(
+  const Eigen::PlainObjectBase<DerivedV> & V,
+  const Eigen::PlainObjectBase<DerivedF> & F,
+  const Scalar t,
+  heat_geodesics_data<Scalar> & data)
+{
+  using namespace Eigen;
+  using namespace std;
+  typedef Matrix<Scalar,Dynamic,1> VectorXS;
+  assert(F.cols() == 3 && "Only triangle meshes are supported");
+  Eigen::SparseMatrix<Scalar> L,M;
+  cotmatrix(V,F,L);
+  massmatrix(V,F,MASSMATRIX_TYPE_DEFAULT,M);
+  const SparseMatrix<Scalar> Aeq;
+  // Heat flow (M - t*L) u = u0 with zero Neumann conditions
+  const SparseMatrix<Scalar> Q = M - t*L;
+  if(!min_quad_with_fixed_precompute(Q,VectorXi(),Aeq,true,data.Neumann))
+  {
+    cerr<<"Error: heat_geodesics: Neumann heat flow factorization failed."<<
+      endl;
+    return false;
+  }
+  // ... and with zero Dirichlet conditions if there is a boundary
+  {
+    Matrix<typename DerivedF::Scalar,Dynamic,Dynamic> O;
+    boundary_facets(F,O);
+    vector<bool> on_boundary(V.rows(),false);
+    for(int i = 0;i<O.size();i++)
+    {
+      on_boundary[O(i)] = true;
+    }
+    data.b.resize(std::count(on_boundary.begin(),on_boundary.end(),true));
+    for(int i = 0,k = 0;i<V.rows();i++)
+    {
+      if(on_boundary[i])
+      {
+        data.b(k++) = i;
+      }
+    }
+  }
+  if(data.b.size() > 0 &&
+    !min_quad_with_fixed_precompute(Q,data.b,Aeq,true,data.Dirichlet))
+  {
+    cerr<<"Error: heat_geodesics: Dirichlet heat flow factorization failed."<<
+      endl;
+    return false;
+  }
+  // Gradient and divergence
+  grad(V,F,data.Grad);
+  data.ng = data.Grad.rows()/F.rows();
+  VectorXS dblA;
+  doublearea(V,F,dblA);
+  const VectorXS area = (0.5*dblA).replicate(data.ng,1);
+  data.Div = data.Grad.transpose()*area.asDiagonal();
+  // Poisson problem -L D = Div X, pinning one vertex
+  data.pinned = F(0,0);
+  const SparseMatrix<Scalar> NL = -L;
+  if(!min_quad_with_fixed_precompute(
+    NL,(VectorXi(1)<<data.pinned).finished(),Aeq,true,data.Poisson))
+  {
+    cerr<<"Error: heat_geodesics: Poisson factorization failed."<<endl;
+    return false;
+  }
+  return true;
+}
+
+template <typename DerivedV, typename DerivedF, typename Scalar>
+IGL_INLINE bool igl::heat_geodesics_precompute(
+  const Eigen::PlainObjectBase<DerivedV> & V,
+  const Eigen::PlainObjectBase<DerivedF> & F,
+  heat_geodesics_data<Scalar> & data)
+{
+  const Scalar h = avg_edge_length(V,F);
+  return heat_geodesics_precompute(V,F,h*h,data);
+}
+
+template <typename Scalar, typename Derivedgamma, typename DerivedD>
+IGL_INLINE void igl::heat_geodesics_solve(
+  const heat_geodesics_data<Scalar> & data,
+  const Eigen::MatrixBase<Derivedgamma> & gamma,
+  Eigen::PlainObjectBase<DerivedD> & D)
+{
+  std::vector<Eigen::VectorXi> gammas(1,gamma.template cast<int>());
+  heat_geodesics_solve(data,gammas,D);
+}
+
+template <typename Scalar, typename DerivedD>
+IGL_INLINE void igl::heat_geodesics_solve(
+  const heat_geodesics_data<Scalar> & data,
+  const std::vector<Eigen::VectorXi> & gammas,
+  Eigen::PlainObjectBase<DerivedD> & D)
+{
+  using namespace Eigen;
+  typedef Matrix<Scalar,Dynamic,Dynamic> MatrixXS;
+  typedef Matrix<Scalar,Dynamic,1> VectorXS;
+  const int n = data.Grad.cols();
+  const int k = gammas.size();
+  // Heat flow from unit sources
+  MatrixXS u0 = MatrixXS::Zero(n,k);
+  for(int s = 0;s<k;s++)
+  {
+    for(int g = 0;g<gammas[s].size();g++)
+    {
+      u0(gammas[s](g),s) = 1;
+    }
+  }
+  MatrixXS u;
+  // (Y has no rows but sets the number of columns)
+  min_quad_with_fixed_solve(
+    data.Neumann,(-u0).eval(),MatrixXS(0,k),VectorXS(),u);
+  if(data.b.size() > 0)
+  {
+    // Average of Neumann and Dirichlet solutions
+    MatrixXS uD;
+    min_quad_with_fixed_solve(
+      data.Dirichlet,(-u0).eval(),MatrixXS::Zero(data.b.size(),k),
+      VectorXS(),uD);
+    u = 0.5*(u+uD);
+  }
+  // Normalized negative gradient
+  MatrixXS X = data.Grad*u;
+  const int m = X.rows()/data.ng;
+  parallel_for(m,[&](const int f)
+  {
+    for(int s = 0;s<k;s++)
+    {
+      Scalar norm = 0;
+      for(int c = 0;c<data.ng;c++)
+      {
+        norm += X(c*m+f,s)*X(c*m+f,s);
+      }
+      norm = std::sqrt(norm);
+      for(int c = 0;c<data.ng;c++)
+      {
+        X(c*m+f,s) = norm > 0 ? -X(c*m+f,s)/norm : 0;
+      }
+    }
+  },1000);
+  // Distance whose gradient best fits X
+  const MatrixXS B = -(data.Div*X);
+  MatrixXS DS;
+  min_quad_with_fixed_solve(
+    data.Poisson,B,MatrixXS::Zero(1,k),VectorXS(),DS);
+  // Shift to zero at the sources
+  D.resize(n,k);
+  for(int s = 0;s<k;s++)
+  {
+    Scalar mean = 0;
+    for(int g = 0;g<gammas[s].size();g++)
+    {
+      mean += DS(gammas[s](g),s);
+    }
+    mean /= std::max<int>(1,gammas[s].size());
+    D.col(s) =
+      (DS.col(s).array()-mean).template cast<typename DerivedD::Scalar>();
+  }
+}
+
+#ifdef IGL_STATIC_LIBRARY
+// Explicit template instantiation
+template bool igl::heat_geodesics_precompute<Eigen::Matrix<double, -1, -1, 0, -1, -1>, Eigen::Matrix<int, -1, -1, 0, -1, -1>, double>(Eigen::PlainObjectBase<Eigen::Matrix<double, -1, -1, 0, -1, -1> > const&, Eigen::PlainObjectBase<Eigen::Matrix<int, -1, -1, 0, -1, -1> > const&, double, igl::heat_geodesics_data<double>&);
+template bool igl::heat_geodesics_precompute<Eigen::Matrix<double, -1, -1, 0, -1, -1>, Eigen::Matrix<int, -1, -1, 0, -1, -1>, double>(Eigen::PlainObjectBase<Eigen::Matrix<double, -1, -1, 0, -1, -1> > const&, Eigen::PlainObjectBase<Eigen::Matrix<int, -1, -1, 0, -1, -1> > const&, igl::heat_geodesics_data<double>&);
+template void igl::heat_geodesics_solve<double, Eigen::Matrix<int, -1, 1, 0, -1, 1>, Eigen::Matrix<double, -1, 1, 0, -1, 1> >(igl::heat_geodesics_data<double> const&, Eigen::MatrixBase<Eigen::Matrix<int, -1, 1, 0, -1, 1> > const&, Eigen::PlainObjectBase<Eigen::Matrix<double, -1, 1, 0, -1, 1> >&);
+template void igl::heat_geodesics_solve<double, Eigen::Matrix<double, -1, -1, 0, -1, -1> >(igl::heat_geodesics_data<double> const&, std::vector<Eigen::Matrix<int, -1, 1, 0, -1, 1>, std::allocator<Eigen::Matrix<int, -1, 1, 0, -1, 1> > > const&, Eigen::PlainObjectBase<Eigen::Matrix<double, -1, -1, 0, -1, -1> >&);
+template void igl::heat_geodesics_solve<double, Eigen::Matrix<double, -1, 1, 0, -1, 1> >(igl::heat_geodesics_data<double> const&, std::vector<Eigen::Matrix<int, -1, 1, 0, -1, 1>, std::allocator<Eigen::Matrix<int, -1, 1, 0, -1, 1> > > const&, Eigen::PlainObjectBase<Eigen::Matrix<double, -1, 1, 0, -1, 1> >&);
+#endif
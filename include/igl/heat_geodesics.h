@@ -0,0 +1,91 @@
+// This file is part of libigl, a simple c++ geometry processing library.
+//
+// Copyright (C) 2018 Floor Verhoeven
+//
+// This Source Code Form is subject to the terms of the Mozilla Public License
+// v. 2.0. If a copy of the MPL was not distributed with this file, You can
+// obtain one at http://mozilla.org/MPL/2.0/.
+#ifndef IGL_HEAT_GEODESICS_H
+#define IGL_HEAT_GEODESICS_H
+#include "igl_inline.h"
+#include "min_quad_with_fixed.h"
+#include <Eigen/Sparse>
+#include <Eigen/Core>
+#include <vector>
+
+namespace igl
+{
+  // Cached operators and factorizations of the heat method
+  template <typename Scalar>
+  struct heat_geodesics_data
+  {
+    // Gradient and (integrated) divergence, Div = Grad' * diag(face areas)
+    Eigen::SparseMatrix<Scalar> Grad,Div;
+    // Number of gradient components
+    int ng;
+    // List of boundary vertex indices
+    Eigen::VectorXi b;
+    // Vertex pinned to zero to make the Poisson problem definite
+    int pinned;
+    // Factorizations of the heat flow with Neumann and (if there is a
+    // boundary) Dirichlet conditions and of the Poisson problem. Their
+    // backend may be set before heat_geodesics_precompute (e.g.
+    // min_quad_with_fixed_data::MULTIGRID for very large meshes).
+    min_quad_with_fixed_data<Scalar> Neumann,Dirichlet,Poisson;
+    heat_geodesics_data():ng(0),pinned(0){}
+  };
+  // Precompute factorized solvers for computing fast geodesic distances on a
+  // connected triangle mesh with the heat method [Crane et al. 2013]
+  //
+  // Inputs:
+  //   V  #V by dim list of mesh vertex positions
+  //   F  #F by 3 list of mesh face indices into V
+  //   t  time step of the heat flow (smaller is more accurate but noisier)
+  // Outputs:
+  //   data  precomputation data (see heat_geodesics_solve)
+  // Returns true on success, false on error
+  template <typename DerivedV, typename DerivedF, typename Scalar>
+  IGL_INLINE bool heat_geodesics_precompute(
+    const Eigen::PlainObjectBase<DerivedV> & V,
+    const Eigen::PlainObjectBase<DerivedF> & F,
+    const Scalar t,
+    heat_geodesics_data<Scalar> & data);
+  // Same as above with t = (average edge length)^2
+  template <typename DerivedV, typename DerivedF, typename Scalar>
+  IGL_INLINE bool heat_geodesics_precompute(
+    const Eigen::PlainObjectBase<DerivedV> & V,
+    const Eigen::PlainObjectBase<DerivedF> & F,
+    heat_geodesics_data<Scalar> & data);
+  // Compute approximate geodesic distances to a set of sources using
+  // precomputed data (two back-substitutions, three with a boundary)
+  //
+  // Inputs:
+  //   data  precomputation data (see heat_geodesics_precompute)
+  //   gamma  #gamma list of indices into V of source vertices
+  // Outputs:
+  //   D  #V list of distances to gamma
+  template <typename Scalar, typename Derivedgamma, typename DerivedD>
+  IGL_INLINE void heat_geodesics_solve(
+    const heat_geodesics_data<Scalar> & data,
+    const Eigen::MatrixBase<Derivedgamma> & gamma,
+    Eigen::PlainObjectBase<DerivedD> & D);
+  // Compute distances to several independent source sets at once. All sets
+  // are solved as the columns of the same back-substitutions.
+  //
+  // Inputs:
+  //   data  precomputation data (see heat_geodesics_precompute)
+  //   gammas  #sets list of lists of source vertex indices
+  // Outputs:
+  //   D  #V by #sets list of distances, column s to gammas[s]
+  template <typename Scalar, typename DerivedD>
+  IGL_INLINE void heat_geodesics_solve(
+    const heat_geodesics_data<Scalar> & data,
+    const std::vector<Eigen::VectorXi> & gammas,
+    Eigen::PlainObjectBase<DerivedD> & D);
+}
+
+#ifndef IGL_STATIC_LIBRARY
+#  include "heat_geodesics.cpp"
+#endif
+
+#endif
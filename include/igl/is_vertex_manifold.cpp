@@ -6,9 +6,10 @@
 // v. 2.0. If a copy of the MPL was not distributed with this file, You can 
 // obtain one at http://mozilla.org/MPL/2.0/.
 #include "is_vertex_manifold.h"
+#include "parallel_for.h"
 #include "triangle_triangle_adjacency.h"
 #include "vertex_triangle_adjacency.h"
-#include "unique.h"
+#include <algorithm>
 #include <vector>
 #include <cassert>
 #include <map>
@@ -31,16 +32,14 @@ IGL_INLINE bool igl::is_vertex_manifold(
   vector<vector<vector<FIndex > > > TTi;
   triangle_triangle_adjacency(F,TT,TTi);
 
-  vector<vector<FIndex > > V2F,_1;
-  vertex_triangle_adjacency(n,F,V2F,_1);
+  VectorXi VF,NI;
+  vertex_triangle_adjacency(F,n,VF,NI);
 
   const auto & check_vertex = [&](const Index v)->bool
   {
-    vector<FIndex> uV2Fv;
-    {
-      vector<size_t> _1,_2;
-      unique(V2F[v],uV2Fv,_1,_2);
-    }
+    // Faces of v are listed in ascending order
+    vector<FIndex> uV2Fv(VF.data()+NI(int(v)),VF.data()+NI(int(v)+1));
+    uV2Fv.erase(std::unique(uV2Fv.begin(),uV2Fv.end()),uV2Fv.end());
     const FIndex one_ring_size = uV2Fv.size();
     if(one_ring_size == 0)
     {
@@ -87,10 +86,11 @@ IGL_INLINE bool igl::is_vertex_manifold(
   // Unreferenced vertices are considered non-manifold
   B.setConstant(n,1,false);
   // Loop over all vertices touched by F
+  parallel_for(int(n),[&](const int v){ B(v) = check_vertex(v); },1000);
   bool all = true;
   for(Index v = 0;v<n;v++)
   {
-    all &= B(v) = check_vertex(v);
+    all &= (bool)B(v);
   }
   return all;
 }
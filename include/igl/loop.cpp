@@ -8,8 +8,7 @@
 
 #include "loop.h"
 
-#include <igl/adjacency_list.h>
-#include <igl/triangle_triangle_adjacency.h>
+#include <igl/CornerTable.h>
 #include <igl/unique.h>
 
 #include <vector>
@@ -30,17 +29,21 @@ IGL_INLINE void igl::loop(
   //Ref. https://graphics.stanford.edu/~mdfisher/subdivision.html
   //Heavily borrowing from igl::upsample
   
-  DerivedF FF, FFi;
-  triangle_triangle_adjacency(F, FF, FFi);
-  std::vector<std::vector<typename DerivedF::Scalar>> adjacencyList;
-  adjacency_list(F, adjacencyList, true);
+  //Edge j of face i, from F(i,j) to F(i,(j+1)%3), is the edge of corner
+  //3*i+(j+2)%3
+  CornerTable ct;
+  ct.init(F, n_verts);
+  const auto opposite = [&ct](const int i, const int j)
+  {
+    return ct.opposite(3*i+(j+2)%3);
+  };
   
   //Compute the number and positions of the vertices to insert (on edges)
-  Eigen::MatrixXi NI = Eigen::MatrixXi::Constant(FF.rows(), FF.cols(), -1);
-  Eigen::MatrixXi NIdoubles = Eigen::MatrixXi::Zero(FF.rows(), FF.cols());
+  Eigen::MatrixXi NI = Eigen::MatrixXi::Constant(F.rows(), 3, -1);
+  Eigen::MatrixXi NIdoubles = Eigen::MatrixXi::Zero(F.rows(), 3);
   Eigen::VectorXi vertIsOnBdry = Eigen::VectorXi::Zero(n_verts);
   int counter = 0;
-  for(int i=0; i<FF.rows(); ++i)
+  for(int i=0; i<F.rows(); ++i)
   {
     for(int j=0; j<3; ++j)
     {
@@ -48,10 +51,11 @@ IGL_INLINE void igl::loop(
       {
         NI(i,j) = counter;
         NIdoubles(i,j) = 0;
-        if (FF(i,j) != -1) 
+        const int o = opposite(i,j);
+        if (o != -1) 
         {
           //If it is not a boundary
-          NI(FF(i,j), FFi(i,j)) = counter;
+          NI(ct.face(o), (o%3+1)%3) = counter;
           NIdoubles(i,j) = 1;
         } else 
         {
@@ -70,19 +74,22 @@ IGL_INLINE void igl::loop(
   
   //Construct vertex positions
   std::vector<Triplet_t> tripletList;
+  //Corners around a vertex, the first and last are on the boundary
+  std::vector<int> ring;
   for(int i=0; i<n_odd; ++i) 
   {
     //Old vertices
-    const std::vector<int>& localAdjList = adjacencyList[i];
+    ring.clear();
+    ct.vertex_ring(i, [&ring](const int c){ ring.push_back(c); });
     if(vertIsOnBdry(i)==1) 
     {
       //Boundary vertex
-      tripletList.emplace_back(i, localAdjList.front(), 1./8.);
-      tripletList.emplace_back(i, localAdjList.back(), 1./8.);
+      tripletList.emplace_back(i, ct.vertex(ct.prev(ring.front())), 1./8.);
+      tripletList.emplace_back(i, ct.vertex(ct.next(ring.back())), 1./8.);
       tripletList.emplace_back(i, i, 3./4.);
     } else 
     {
-      const int n = localAdjList.size();
+      const int n = ring.size();
       const SType dn = n;
       SType beta;
       if(n==3)
@@ -94,19 +101,20 @@ IGL_INLINE void igl::loop(
       }
       for(int j=0; j<n; ++j)
       {
-        tripletList.emplace_back(i, localAdjList[j], beta);
+        tripletList.emplace_back(i, ct.vertex(ct.next(ring[j])), beta);
       }
       tripletList.emplace_back(i, i, 1.-dn*beta);
     }
   }
-  for(int i=0; i<FF.rows(); ++i) 
+  for(int i=0; i<F.rows(); ++i) 
   {
     //New vertices
     for(int j=0; j<3; ++j) 
     {
       if(NIdoubles(i,j)==0) 
       {
-        if(FF(i,j)==-1) 
+        const int o = opposite(i,j);
+        if(o==-1) 
         {
           //Boundary vertex
           tripletList.emplace_back(NI(i,j) + n_odd, F(i,j), 1./2.);
@@ -116,7 +124,7 @@ IGL_INLINE void igl::loop(
           tripletList.emplace_back(NI(i,j) + n_odd, F(i,j), 3./8.);
           tripletList.emplace_back(NI(i,j) + n_odd, F(i, (j+1)%3), 3./8.);
           tripletList.emplace_back(NI(i,j) + n_odd, F(i, (j+2)%3), 1./8.);
-          tripletList.emplace_back(NI(i,j) + n_odd, F(FF(i,j), (FFi(i,j)+2)%3), 1./8.);
+          tripletList.emplace_back(NI(i,j) + n_odd, ct.vertex(o), 1./8.);
         }
       }
     }
@@ -0,0 +1,57 @@
+// This file is part of libigl, a simple c++ geometry processing library.
+//
+// Copyright (C) 2018 Floor Verhoeven
+//
+// This Source Code Form is subject to the terms of the Mozilla Public License
+// v. 2.0. If a copy of the MPL was not distributed with this file, You can
+// obtain one at http://mozilla.org/MPL/2.0/.
+#include "massmatrix_cached.h"
+#include "massmatrix_entries.h"
+#include <vector>
+
+template <typename DerivedV, typename DerivedF, typename Scalar>
+IGL_INLINE void igl::massmatrix_cached_precompute(
+  const Eigen::MatrixBase<DerivedV> & V,
+  const Eigen::MatrixBase<DerivedF> & F,
+  const MassMatrixType type,
+  sparse_cached_data & data,
+  Eigen::SparseMatrix<Scalar>& M)
+{
+  using namespace Eigen;
+  using namespace std;
+  const int m = F.rows();
+  const int simplex_size = F.cols();
+  // One diagonal entry per element corner, in the (column major) order of the
+  // per-element masses
+  vector<Triplet<Scalar> > IJV(m*simplex_size);
+  for(int c = 0;c<simplex_size;c++)
+  {
+    for(int i = 0;i<m;i++)
+    {
+      IJV[c*m+i] = Triplet<Scalar>(F(i,c),F(i,c),0);
+    }
+  }
+  M.resize(V.rows(),V.rows());
+  sparse_cached_precompute(IJV,data,M);
+  massmatrix_cached(V,F,type,data,M);
+}
+
+template <typename DerivedV, typename DerivedF, typename Scalar>
+IGL_INLINE void igl::massmatrix_cached(
+  const Eigen::MatrixBase<DerivedV> & V,
+  const Eigen::MatrixBase<DerivedF> & F,
+  const MassMatrixType type,
+  const sparse_cached_data & data,
+  Eigen::SparseMatrix<Scalar>& M)
+{
+  // Per-element masses of each corner
+  Eigen::Matrix<Scalar,Eigen::Dynamic,Eigen::Dynamic> MV;
+  massmatrix_entries(V,F,type,MV);
+  sparse_cached(MV,data,M);
+}
+
+#ifdef IGL_STATIC_LIBRARY
+// Explicit template instantiation
+template void igl::massmatrix_cached_precompute<Eigen::Matrix<double, -1, -1, 0, -1, -1>, Eigen::Matrix<int, -1, -1, 0, -1, -1>, double>(Eigen::MatrixBase<Eigen::Matrix<double, -1, -1, 0, -1, -1> > const&, Eigen::MatrixBase<Eigen::Matrix<int, -1, -1, 0, -1, -1> > const&, igl::MassMatrixType, igl::sparse_cached_data&, Eigen::SparseMatrix<double, 0, int>&);
+template void igl::massmatrix_cached<Eigen::Matrix<double, -1, -1, 0, -1, -1>, Eigen::Matrix<int, -1, -1, 0, -1, -1>, double>(Eigen::MatrixBase<Eigen::Matrix<double, -1, -1, 0, -1, -1> > const&, Eigen::MatrixBase<Eigen::Matrix<int, -1, -1, 0, -1, -1> > const&, igl::MassMatrixType, igl::sparse_cached_data const&, Eigen::SparseMatrix<double, 0, int>&);
+#endif
@@ -0,0 +1,55 @@
+// This file is part of libigl, a simple c++ geometry processing library.
+//
+// Copyright (C) 2018 Floor Verhoeven
+//
+// This Source Code Form is subject to the terms of the Mozilla Public License
+// v. 2.0. If a copy of the MPL was not distributed with this file, You can
+// obtain one at http://mozilla.org/MPL/2.0/.
+#ifndef IGL_MASSMATRIX_CACHED_H
+#define IGL_MASSMATRIX_CACHED_H
+#include "igl_inline.h"
+#include "massmatrix.h"
+#include "sparse_cached.h"
+#include <Eigen/Dense>
+#include <Eigen/Sparse>
+
+namespace igl
+{
+  // Constructs the mass (area) matrix like igl::massmatrix, in two phases:
+  // the sparsity pattern is fixed once for a given F, and subsequent
+  // evaluations (e.g. on a deforming mesh) compute the per-element masses in
+  // parallel and sum them directly into the diagonal of M.
+  //
+  // Inputs:
+  //   V  #V by dim list of mesh vertex positions
+  //   F  #F by simplex_size list of mesh elements (triangles or tetrahedra)
+  //   type  one of the following ints:
+  //     MASSMATRIX_TYPE_BARYCENTRIC  barycentric
+  //     MASSMATRIX_TYPE_VORONOI voronoi-hybrid {default}
+  //   data  pattern from massmatrix_cached_precompute (with the same F)
+  // Outputs:
+  //   data  cached pattern (precompute only)
+  //   M  #V by #V mass matrix
+  //
+  // See also: massmatrix, cotmatrix_cached, sparse_cached
+  template <typename DerivedV, typename DerivedF, typename Scalar>
+  IGL_INLINE void massmatrix_cached_precompute(
+    const Eigen::MatrixBase<DerivedV> & V,
+    const Eigen::MatrixBase<DerivedF> & F,
+    const MassMatrixType type,
+    sparse_cached_data & data,
+    Eigen::SparseMatrix<Scalar>& M);
+  template <typename DerivedV, typename DerivedF, typename Scalar>
+  IGL_INLINE void massmatrix_cached(
+    const Eigen::MatrixBase<DerivedV> & V,
+    const Eigen::MatrixBase<DerivedF> & F,
+    const MassMatrixType type,
+    const sparse_cached_data & data,
+    Eigen::SparseMatrix<Scalar>& M);
+}
+
+#ifndef IGL_STATIC_LIBRARY
+#  include "massmatrix_cached.cpp"
+#endif
+
+#endif
@@ -0,0 +1,104 @@
+// This file is part of libigl, a simple c++ geometry processing library.
+//
+// Copyright (C) 2018 Floor Verhoeven
+//
+// This Source Code Form is subject to the terms of the Mozilla Public License
+// v. 2.0. If a copy of the MPL was not distributed with this file, You can
+// obtain one at http://mozilla.org/MPL/2.0/.
+#include "massmatrix_entries.h"
+#include "doublearea.h"
+#include "parallel_for.h"
+#include <Eigen/Geometry>
+
+template <typename DerivedV, typename DerivedF, typename DerivedMV>
+IGL_INLINE void igl::massmatrix_entries(
+  const Eigen::MatrixBase<DerivedV> & V,
+  const Eigen::MatrixBase<DerivedF> & F,
+  const MassMatrixType type,
+  Eigen::PlainObjectBase<DerivedMV> & MV)
+{
+  using namespace Eigen;
+  typedef typename DerivedMV::Scalar Scalar;
+  const int m = F.rows();
+  const int simplex_size = F.cols();
+
+  MassMatrixType eff_type = type;
+  // Use voronoi of for triangles by default, otherwise barycentric
+  if(type == MASSMATRIX_TYPE_DEFAULT)
+  {
+    eff_type = (simplex_size == 3?MASSMATRIX_TYPE_VORONOI:MASSMATRIX_TYPE_BARYCENTRIC);
+  }
+  // Not yet supported
+  assert(eff_type!=MASSMATRIX_TYPE_FULL);
+
+  MV.resize(m,simplex_size);
+  if(simplex_size == 3)
+  {
+    // edge lengths numbered same as opposite vertices
+    Matrix<Scalar,Dynamic,3> l(m,3);
+    parallel_for(m,[&](const int i)
+    {
+      l(i,0) = (V.row(F(i,1))-V.row(F(i,2))).norm();
+      l(i,1) = (V.row(F(i,2))-V.row(F(i,0))).norm();
+      l(i,2) = (V.row(F(i,0))-V.row(F(i,1))).norm();
+    },1000);
+    Matrix<Scalar,Dynamic,1> dblA;
+    doublearea(l,0.,dblA);
+    parallel_for(m,[&](const int i)
+    {
+      if(eff_type == MASSMATRIX_TYPE_BARYCENTRIC)
+      {
+        MV.row(i).setConstant(dblA(i)/6.0);
+        return;
+      }
+      // Same as the voronoi-hybrid areas of igl::massmatrix
+      // http://www.alecjacobson.com/weblog/?p=874
+      Scalar cosines[3],partial[3];
+      for(int c = 0;c<3;c++)
+      {
+        const Scalar a = l(i,c),b = l(i,(c+1)%3),d = l(i,(c+2)%3);
+        cosines[c] = (d*d+b*b-a*a)/(b*d*2.0);
+        partial[c] = cosines[c]*a;
+      }
+      const Scalar sum = partial[0]+partial[1]+partial[2];
+      for(int c = 0;c<3;c++)
+      {
+        partial[c] *= dblA(i)*0.5/sum;
+      }
+      for(int c = 0;c<3;c++)
+      {
+        MV(i,c) = (partial[(c+1)%3]+partial[(c+2)%3])*0.5;
+      }
+      for(int c = 0;c<3;c++)
+      {
+        if(cosines[c] < 0)
+        {
+          MV.row(i).setConstant(0.125*dblA(i));
+          MV(i,c) = 0.25*dblA(i);
+        }
+      }
+    },1000);
+  }else if(simplex_size == 4)
+  {
+    assert(V.cols() == 3);
+    assert(eff_type == MASSMATRIX_TYPE_BARYCENTRIC);
+    parallel_for(m,[&](const int i)
+    {
+      // http://en.wikipedia.org/wiki/Tetrahedron#Volume
+      Matrix<Scalar,3,1> v0m3,v1m3,v2m3;
+      v0m3.head(V.cols()) = V.row(F(i,0)) - V.row(F(i,3));
+      v1m3.head(V.cols()) = V.row(F(i,1)) - V.row(F(i,3));
+      v2m3.head(V.cols()) = V.row(F(i,2)) - V.row(F(i,3));
+      MV.row(i).setConstant(fabs(v0m3.dot(v1m3.cross(v2m3)))/6.0/4.0);
+    },1000);
+  }else
+  {
+    // Unsupported simplex size
+    assert(false && "Unsupported simplex size");
+  }
+}
+
+#ifdef IGL_STATIC_LIBRARY
+// Explicit template instantiation
+template void igl::massmatrix_entries<Eigen::Matrix<double, -1, -1, 0, -1, -1>, Eigen::Matrix<int, -1, -1, 0, -1, -1>, Eigen::Matrix<double, -1, -1, 0, -1, -1> >(Eigen::MatrixBase<Eigen::Matrix<double, -1, -1, 0, -1, -1> > const&, Eigen::MatrixBase<Eigen::Matrix<int, -1, -1, 0, -1, -1> > const&, igl::MassMatrixType, Eigen::PlainObjectBase<Eigen::Matrix<double, -1, -1, 0, -1, -1> >&);
+#endif
@@ -0,0 +1,41 @@
+// This file is part of libigl, a simple c++ geometry processing library.
+//
+// Copyright (C) 2018 Floor Verhoeven
+//
+// This Source Code Form is subject to the terms of the Mozilla Public License
+// v. 2.0. If a copy of the MPL was not distributed with this file, You can
+// obtain one at http://mozilla.org/MPL/2.0/.
+#ifndef IGL_MASSMATRIX_ENTRIES_H
+#define IGL_MASSMATRIX_ENTRIES_H
+#include "igl_inline.h"
+#include "massmatrix.h"
+#include <Eigen/Core>
+namespace igl
+{
+  // MASSMATRIX_ENTRIES compute the mass of each element corner in mesh (V,F),
+  // such that summing MV(i,c) into the diagonal entry of F(i,c) yields the
+  // lumped mass matrix of igl::massmatrix
+  //
+  // Inputs:
+  //   V  #V by dim list of mesh vertex positions
+  //   F  #F by {3|4} list of {triangle|tetrahedra} indices into V
+  //   type  one of the following ints:
+  //     MASSMATRIX_TYPE_BARYCENTRIC  barycentric
+  //     MASSMATRIX_TYPE_VORONOI voronoi-hybrid {default}
+  // Outputs:
+  //   MV  #F by {3|4} list of per-corner masses
+  //
+  // See also: massmatrix, cotmatrix_entries
+  template <typename DerivedV, typename DerivedF, typename DerivedMV>
+  IGL_INLINE void massmatrix_entries(
+    const Eigen::MatrixBase<DerivedV> & V,
+    const Eigen::MatrixBase<DerivedF> & F,
+    const MassMatrixType type,
+    Eigen::PlainObjectBase<DerivedMV> & MV);
+}
+
+#ifndef IGL_STATIC_LIBRARY
+#  include "massmatrix_entries.cpp"
+#endif
+
+#endif
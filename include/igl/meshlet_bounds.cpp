@@ -0,0 +1,136 @@
+// This file is part of libigl, a simple c++ geometry processing library.
+//
+// Copyright (C) 2018 Floor Verhoeven
+//
+// This Source Code Form is subject to the terms of the Mozilla Public License
+// v. 2.0. If a copy of the MPL was not distributed with this file, You can
+// obtain one at http://mozilla.org/MPL/2.0/.
+#include "meshlet_bounds.h"
+#include "parallel_for.h"
+#include <Eigen/Geometry>
+#include <algorithm>
+#include <cmath>
+
+template <
+  typename DerivedV,
+  typename DerivedF,
+  typename DerivedI,
+  typename DerivedO,
+  typename DerivedB,
+  typename DerivedR,
+  typename DerivedN,
+  typename DerivedA>
+IGL_INLINE void igl::meshlet_bounds(
+  const Eigen::MatrixBase<DerivedV> & V,
+  const Eigen::MatrixBase<DerivedF> & F,
+  const Eigen::MatrixBase<DerivedI> & I,
+  const Eigen::MatrixBase<DerivedO> & O,
+  Eigen::PlainObjectBase<DerivedB> & B,
+  Eigen::PlainObjectBase<DerivedR> & R,
+  Eigen::PlainObjectBase<DerivedN> & N,
+  Eigen::PlainObjectBase<DerivedA> & A)
+{
+  typedef typename DerivedB::Scalar Scalar;
+  typedef Eigen::Matrix<Scalar,1,3> RowVector3S;
+  assert(F.cols() == 3 && "F should contain triangles");
+  assert(O.size() >= 1);
+  const int nc = O.size()-1;
+  B.resize(nc,3);
+  R.resize(nc,1);
+  N.resize(nc,3);
+  A.resize(nc,1);
+  igl::parallel_for(nc,[&](const int c)
+  {
+    const int begin = O(c);
+    const int end = O(c+1);
+    const auto corner = [&](const int k)->RowVector3S
+    {
+      return V.row(F(I(begin+k/3),k%3)).template cast<Scalar>();
+    };
+    const int ncorners = 3*(end-begin);
+    if(ncorners == 0)
+    {
+      B.row(c).setZero();
+      R(c) = 0;
+      N.row(c).setZero();
+      A(c) = 1;
+      return;
+    }
+    // Ritter's bounding sphere: pick the corner farthest from an arbitrary
+    // corner, then the corner farthest from that, then grow to enclose all
+    RowVector3S p = corner(0);
+    RowVector3S q = p;
+    Scalar max_d = -1;
+    for(int k = 0;k<ncorners;k++)
+    {
+      const Scalar d = (corner(k)-p).squaredNorm();
+      if(d > max_d) { max_d = d; q = corner(k); }
+    }
+    RowVector3S r = q;
+    max_d = -1;
+    for(int k = 0;k<ncorners;k++)
+    {
+      const Scalar d = (corner(k)-q).squaredNorm();
+      if(d > max_d) { max_d = d; r = corner(k); }
+    }
+    RowVector3S center = 0.5*(q+r);
+    Scalar radius = 0.5*(r-q).norm();
+    for(int k = 0;k<ncorners;k++)
+    {
+      const RowVector3S x = corner(k);
+      const Scalar d = (x-center).norm();
+      if(d > radius)
+      {
+        const Scalar new_radius = 0.5*(radius+d);
+        center += (d-new_radius)/d*(x-center);
+        radius = new_radius;
+      }
+    }
+    B.row(c) = center;
+    R(c) = radius;
+
+    // Normal cone: average of unit face normals, half-angle given by the
+    // normal deviating the most from it
+    RowVector3S axis(0,0,0);
+    for(int i = begin;i<end;i++)
+    {
+      const RowVector3S n =
+        (corner(3*(i-begin)+1)-corner(3*(i-begin))).cross(
+          corner(3*(i-begin)+2)-corner(3*(i-begin)));
+      const Scalar nn = n.norm();
+      if(nn > 0)
+      {
+        axis += n/nn;
+      }
+    }
+    const Scalar axis_norm = axis.norm();
+    if(axis_norm == 0)
+    {
+      N.row(c).setZero();
+      A(c) = 1;
+      return;
+    }
+    axis /= axis_norm;
+    Scalar min_dp = 1;
+    for(int i = begin;i<end;i++)
+    {
+      const RowVector3S n =
+        (corner(3*(i-begin)+1)-corner(3*(i-begin))).cross(
+          corner(3*(i-begin)+2)-corner(3*(i-begin)));
+      const Scalar nn = n.norm();
+      if(nn > 0)
+      {
+        min_dp = std::min(min_dp,n.dot(axis)/nn);
+      }
+    }
+    N.row(c) = axis;
+    // Normals spread over more than a hemisphere: can never be back-facing
+    A(c) = min_dp <= 0 ? 1 : std::sqrt(std::max(Scalar(0),1-min_dp*min_dp));
+  },1000);
+}
+
+#ifdef IGL_STATIC_LIBRARY
+// Explicit template instantiation
+template void igl::meshlet_bounds<Eigen::Matrix<double, -1, -1, 0, -1, -1>, Eigen::Matrix<int, -1, -1, 0, -1, -1>, Eigen::Matrix<int, -1, 1, 0, -1, 1>, Eigen::Matrix<int, -1, 1, 0, -1, 1>, Eigen::Matrix<float, -1, -1, 1, -1, -1>, Eigen::Matrix<float, -1, 1, 0, -1, 1>, Eigen::Matrix<float, -1, -1, 1, -1, -1>, Eigen::Matrix<float, -1, 1, 0, -1, 1> >(Eigen::MatrixBase<Eigen::Matrix<double, -1, -1, 0, -1, -1> > const&, Eigen::MatrixBase<Eigen::Matrix<int, -1, -1, 0, -1, -1> > const&, Eigen::MatrixBase<Eigen::Matrix<int, -1, 1, 0, -1, 1> > const&, Eigen::MatrixBase<Eigen::Matrix<int, -1, 1, 0, -1, 1> > const&, Eigen::PlainObjectBase<Eigen::Matrix<float, -1, -1, 1, -1, -1> >&, Eigen::PlainObjectBase<Eigen::Matrix<float, -1, 1, 0, -1, 1> >&, Eigen::PlainObjectBase<Eigen::Matrix<float, -1, -1, 1, -1, -1> >&, Eigen::PlainObjectBase<Eigen::Matrix<float, -1, 1, 0, -1, 1> >&);
+template void igl::meshlet_bounds<Eigen::Matrix<double, -1, -1, 0, -1, -1>, Eigen::Matrix<int, -1, -1, 0, -1, -1>, Eigen::Matrix<int, -1, 1, 0, -1, 1>, Eigen::Matrix<int, -1, 1, 0, -1, 1>, Eigen::Matrix<double, -1, -1, 0, -1, -1>, Eigen::Matrix<double, -1, 1, 0, -1, 1>, Eigen::Matrix<double, -1, -1, 0, -1, -1>, Eigen::Matrix<double, -1, 1, 0, -1, 1> >(Eigen::MatrixBase<Eigen::Matrix<double, -1, -1, 0, -1, -1> > const&, Eigen::MatrixBase<Eigen::Matrix<int, -1, -1, 0, -1, -1> > const&, Eigen::MatrixBase<Eigen::Matrix<int, -1, 1, 0, -1, 1> > const&, Eigen::MatrixBase<Eigen::Matrix<int, -1, 1, 0, -1, 1> > const&, Eigen::PlainObjectBase<Eigen::Matrix<double, -1, -1, 0, -1, -1> >&, Eigen::PlainObjectBase<Eigen::Matrix<double, -1, 1, 0, -1, 1> >&, Eigen::PlainObjectBase<Eigen::Matrix<double, -1, -1, 0, -1, -1> >&, Eigen::PlainObjectBase<Eigen::Matrix<double, -1, 1, 0, -1, 1> >&);
+#endif
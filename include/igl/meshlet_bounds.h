@@ -0,0 +1,55 @@
+// This file is part of libigl, a simple c++ geometry processing library.
+//
+// Copyright (C) 2018 Floor Verhoeven
+//
+// This Source Code Form is subject to the terms of the Mozilla Public License
+// v. 2.0. If a copy of the MPL was not distributed with this file, You can
+// obtain one at http://mozilla.org/MPL/2.0/.
+#ifndef IGL_MESHLET_BOUNDS_H
+#define IGL_MESHLET_BOUNDS_H
+#include "igl_inline.h"
+#include <Eigen/Core>
+namespace igl
+{
+  // MESHLET_BOUNDS Compute culling bounds (bounding spheres and normal cones)
+  // of a given partition of a mesh into clusters. This is useful to refresh
+  // the bounds of a deforming mesh without recomputing the partition.
+  //
+  // Inputs:
+  //   V  #V by 3 list of mesh vertex positions
+  //   F  #F by 3 list of triangle indices into V
+  //   I  #F list of face indices so that F(I,:) stores each cluster
+  //     contiguously
+  //   O  #C+1 list of offsets into I
+  // Outputs:
+  //   B  #C by 3 list of bounding sphere centers
+  //   R  #C list of bounding sphere radii
+  //   N  #C by 3 list of unit normal cone axes
+  //   A  #C list of normal cone cutoffs (see meshlets.h)
+  //
+  // See also: meshlets
+  template <
+    typename DerivedV,
+    typename DerivedF,
+    typename DerivedI,
+    typename DerivedO,
+    typename DerivedB,
+    typename DerivedR,
+    typename DerivedN,
+    typename DerivedA>
+  IGL_INLINE void meshlet_bounds(
+    const Eigen::MatrixBase<DerivedV> & V,
+    const Eigen::MatrixBase<DerivedF> & F,
+    const Eigen::MatrixBase<DerivedI> & I,
+    const Eigen::MatrixBase<DerivedO> & O,
+    Eigen::PlainObjectBase<DerivedB> & B,
+    Eigen::PlainObjectBase<DerivedR> & R,
+    Eigen::PlainObjectBase<DerivedN> & N,
+    Eigen::PlainObjectBase<DerivedA> & A);
+}
+
+#ifndef IGL_STATIC_LIBRARY
+#  include "meshlet_bounds.cpp"
+#endif
+
+#endif
@@ -0,0 +1,147 @@
+// This file is part of libigl, a simple c++ geometry processing library.
+//
+// Copyright (C) 2018 Floor Verhoeven
+//
+// This Source Code Form is subject to the terms of the Mozilla Public License
+// v. 2.0. If a copy of the MPL was not distributed with this file, You can
+// obtain one at http://mozilla.org/MPL/2.0/.
+#include "meshlets.h"
+#include "meshlet_bounds.h"
+#include "triangle_triangle_adjacency.h"
+#include "vertex_triangle_adjacency.h"
+#include <deque>
+#include <vector>
+
+template <
+  typename DerivedV,
+  typename DerivedF,
+  typename DerivedI,
+  typename DerivedO,
+  typename DerivedB,
+  typename DerivedR,
+  typename DerivedN,
+  typename DerivedA>
+IGL_INLINE void igl::meshlets(
+  const Eigen::PlainObjectBase<DerivedV> & V,
+  const Eigen::PlainObjectBase<DerivedF> & F,
+  const int max_faces,
+  Eigen::PlainObjectBase<DerivedI> & I,
+  Eigen::PlainObjectBase<DerivedO> & O,
+  Eigen::PlainObjectBase<DerivedB> & B,
+  Eigen::PlainObjectBase<DerivedR> & R,
+  Eigen::PlainObjectBase<DerivedN> & N,
+  Eigen::PlainObjectBase<DerivedA> & A)
+{
+  meshlets(F,max_faces,I,O);
+  meshlet_bounds(V,F,I,O,B,R,N,A);
+}
+
+template <
+  typename DerivedF,
+  typename DerivedI,
+  typename DerivedO>
+IGL_INLINE void igl::meshlets(
+  const Eigen::PlainObjectBase<DerivedF> & F,
+  const int max_faces,
+  Eigen::PlainObjectBase<DerivedI> & I,
+  Eigen::PlainObjectBase<DerivedO> & O)
+{
+  using namespace std;
+  assert(F.cols() == 3 && "F should contain triangles");
+  assert(max_faces > 0);
+  const int m = F.rows();
+  I.resize(m,1);
+  if(m == 0)
+  {
+    O.setZero(1,1);
+    return;
+  }
+  Eigen::MatrixXi TT;
+  triangle_triangle_adjacency(F,TT);
+  vector<vector<int> > VF,VFi;
+  vertex_triangle_adjacency(F.maxCoeff()+1,F,VF,VFi);
+
+  vector<int> offsets(1,0);
+  vector<bool> assigned(m,false);
+  // Last cluster that enqueued each face (avoids duplicate queue entries)
+  vector<int> stamp(m,-1);
+  // Unassigned faces left on the frontier of previous clusters: seeding from
+  // them keeps consecutive clusters spatially close
+  vector<int> candidates;
+  int count = 0;
+  int scan = 0;
+  while(count < m)
+  {
+    const int c = offsets.size()-1;
+    int seed = -1;
+    while(seed < 0 && !candidates.empty())
+    {
+      const int f = candidates.back();
+      candidates.pop_back();
+      if(!assigned[f])
+      {
+        seed = f;
+      }
+    }
+    if(seed < 0)
+    {
+      while(assigned[scan]) scan++;
+      seed = scan;
+    }
+    const int begin = count;
+    deque<int> Q(1,seed);
+    stamp[seed] = c;
+    while(count-begin < max_faces && !Q.empty())
+    {
+      const int f = Q.front();
+      Q.pop_front();
+      if(assigned[f])
+      {
+        continue;
+      }
+      assigned[f] = true;
+      I(count++) = f;
+      for(int e = 0;e<3;e++)
+      {
+        const int g = TT(f,e);
+        if(g >= 0 && !assigned[g] && stamp[g] != c)
+        {
+          stamp[g] = c;
+          Q.push_back(g);
+        }
+      }
+      if(Q.empty() && count-begin < max_faces)
+      {
+        // Edge neighbourhood exhausted (boundary, non-manifold edge or
+        // vertex-connected component): continue across shared vertices
+        for(int i = begin;i<count;i++)
+        {
+          for(int j = 0;j<3;j++)
+          {
+            for(const int g : VF[F(I(i),j)])
+            {
+              if(!assigned[g] && stamp[g] != c)
+              {
+                stamp[g] = c;
+                Q.push_back(g);
+              }
+            }
+          }
+        }
+      }
+    }
+    candidates.insert(candidates.end(),Q.rbegin(),Q.rend());
+    offsets.push_back(count);
+  }
+  O.resize(offsets.size(),1);
+  for(int c = 0;c<(int)offsets.size();c++)
+  {
+    O(c) = offsets[c];
+  }
+}
+
+#ifdef IGL_STATIC_LIBRARY
+// Explicit template instantiation
+template void igl::meshlets<Eigen::Matrix<int, -1, -1, 0, -1, -1>, Eigen::Matrix<int, -1, 1, 0, -1, 1>, Eigen::Matrix<int, -1, 1, 0, -1, 1> >(Eigen::PlainObjectBase<Eigen::Matrix<int, -1, -1, 0, -1, -1> > const&, int, Eigen::PlainObjectBase<Eigen::Matrix<int, -1, 1, 0, -1, 1> >&, Eigen::PlainObjectBase<Eigen::Matrix<int, -1, 1, 0, -1, 1> >&);
+template void igl::meshlets<Eigen::Matrix<double, -1, -1, 0, -1, -1>, Eigen::Matrix<int, -1, -1, 0, -1, -1>, Eigen::Matrix<int, -1, 1, 0, -1, 1>, Eigen::Matrix<int, -1, 1, 0, -1, 1>, Eigen::Matrix<double, -1, -1, 0, -1, -1>, Eigen::Matrix<double, -1, 1, 0, -1, 1>, Eigen::Matrix<double, -1, -1, 0, -1, -1>, Eigen::Matrix<double, -1, 1, 0, -1, 1> >(Eigen::PlainObjectBase<Eigen::Matrix<double, -1, -1, 0, -1, -1> > const&, Eigen::PlainObjectBase<Eigen::Matrix<int, -1, -1, 0, -1, -1> > const&, int, Eigen::PlainObjectBase<Eigen::Matrix<int, -1, 1, 0, -1, 1> >&, Eigen::PlainObjectBase<Eigen::Matrix<int, -1, 1, 0, -1, 1> >&, Eigen::PlainObjectBase<Eigen::Matrix<double, -1, -1, 0, -1, -1> >&, Eigen::PlainObjectBase<Eigen::Matrix<double, -1, 1, 0, -1, 1> >&, Eigen::PlainObjectBase<Eigen::Matrix<double, -1, -1, 0, -1, -1> >&, Eigen::PlainObjectBase<Eigen::Matrix<double, -1, 1, 0, -1, 1> >&);
+#endif
@@ -0,0 +1,75 @@
+// This file is part of libigl, a simple c++ geometry processing library.
+//
+// Copyright (C) 2018 Floor Verhoeven
+//
+// This Source Code Form is subject to the terms of the Mozilla Public License
+// v. 2.0. If a copy of the MPL was not distributed with this file, You can
+// obtain one at http://mozilla.org/MPL/2.0/.
+#ifndef IGL_MESHLETS_H
+#define IGL_MESHLETS_H
+#include "igl_inline.h"
+#include <Eigen/Core>
+namespace igl
+{
+  // MESHLETS Partition a triangle mesh into spatially coherent clusters
+  // ("meshlets") of at most max_faces faces each, so that each cluster can be
+  // culled independently (frustum and back-face) at draw time. Clusters are
+  // grown breadth-first across edge-adjacent faces and continue across
+  // vertex-adjacent faces when the edge neighbourhood is exhausted.
+  //
+  // Inputs:
+  //   V  #V by 3 list of mesh vertex positions
+  //   F  #F by 3 list of triangle indices into V
+  //   max_faces  maximum number of faces per cluster (e.g. 64 to 256)
+  // Outputs:
+  //   I  #F list of face indices so that F(I,:) stores each cluster
+  //     contiguously
+  //   O  #C+1 list of offsets into I so that cluster c is
+  //     I(O(c)),...,I(O(c+1)-1)
+  //   B  #C by 3 list of bounding sphere centers
+  //   R  #C list of bounding sphere radii
+  //   N  #C by 3 list of unit normal cone axes
+  //   A  #C list of normal cone cutoffs: a cluster is entirely back-facing
+  //     with respect to an eye position e if
+  //       (B(c,:)-e)·N(c,:) >= A(c)*‖B(c,:)-e‖ + R(c)
+  //     (A(c)=1 means the cone is degenerate and the cluster is never
+  //     back-face culled)
+  //
+  // See also: meshlet_bounds, triangle_triangle_adjacency,
+  // vertex_triangle_adjacency
+  template <
+    typename DerivedV,
+    typename DerivedF,
+    typename DerivedI,
+    typename DerivedO,
+    typename DerivedB,
+    typename DerivedR,
+    typename DerivedN,
+    typename DerivedA>
+  IGL_INLINE void meshlets(
+    const Eigen::PlainObjectBase<DerivedV> & V,
+    const Eigen::PlainObjectBase<DerivedF> & F,
+    const int max_faces,
+    Eigen::PlainObjectBase<DerivedI> & I,
+    Eigen::PlainObjectBase<DerivedO> & O,
+    Eigen::PlainObjectBase<DerivedB> & B,
+    Eigen::PlainObjectBase<DerivedR> & R,
+    Eigen::PlainObjectBase<DerivedN> & N,
+    Eigen::PlainObjectBase<DerivedA> & A);
+  // Only compute the partition (topology only, V is not needed)
+  template <
+    typename DerivedF,
+    typename DerivedI,
+    typename DerivedO>
+  IGL_INLINE void meshlets(
+    const Eigen::PlainObjectBase<DerivedF> & F,
+    const int max_faces,
+    Eigen::PlainObjectBase<DerivedI> & I,
+    Eigen::PlainObjectBase<DerivedO> & O);
+}
+
+#ifndef IGL_STATIC_LIBRARY
+#  include "meshlets.cpp"
+#endif
+
+#endif
@@ -15,6 +15,7 @@
 #include "matlab_format.h"
 #include "EPS.h"
 #include "cat.h"
+#include "parallel_for.h"
 
 //#include <Eigen/SparseExtra>
 // Bug in unsupported/Eigen/SparseExtra needs iostream first
@@ -23,6 +24,285 @@
 #include <cassert>
 #include <cstdio>
 #include <iostream>
+#include <algorithm>
+#include <atomic>
+#include <thread>
+
+namespace igl
+{
+  namespace min_quad_with_fixed_helpers
+  {
+    // Factor a positive definite system with data.backend. The symbolic
+    // analysis is only (re)done if analyze is true, so that
+    // min_quad_with_fixed_refactor can reuse it.
+    //
+    // Inputs:
+    //   M  positive definite matrix
+    //   analyze  whether to run the symbolic analysis
+    //   allow_cg  whether CONJUGATE_GRADIENT or MULTIGRID may be used for M
+    //   data  factorization struct
+    // Outputs:
+    //   data  updated factorization struct
+    // Returns true on success, false on error
+    template <typename T>
+    IGL_INLINE bool factor_pd(
+      const Eigen::SparseMatrix<T> & M,
+      const bool analyze,
+      const bool allow_cg,
+      min_quad_with_fixed_data<T> & data)
+    {
+      using namespace std;
+      Eigen::ComputationInfo info;
+      if(allow_cg &&
+        data.backend == min_quad_with_fixed_data<T>::CONJUGATE_GRADIENT)
+      {
+        // Iterations multiply against the system matrix during solve
+        data.Auu = M;
+        if(analyze)
+        {
+          data.cg_precond.analyzePattern(data.Auu);
+        }
+        data.cg_precond.factorize(data.Auu);
+        info = data.cg_precond.info();
+      }
+      else if(allow_cg &&
+        data.backend == min_quad_with_fixed_data<T>::MULTIGRID)
+      {
+        data.Auu = M;
+        // The hierarchy depends on the values, so it is always rebuilt
+        data.amg.compute(data.Auu);
+        info = data.amg.info();
+      }
+#ifdef CHOLMOD
+      else if(data.backend == min_quad_with_fixed_data<T>::SUPERNODAL)
+      {
+        if(analyze)
+        {
+          data.cholmod.analyzePattern(M);
+        }
+        data.cholmod.factorize(M);
+        info = data.cholmod.info();
+      }
+#endif
+      else
+      {
+        if(analyze)
+        {
+          data.llt.analyzePattern(M);
+        }
+        data.llt.factorize(M);
+        info = data.llt.info();
+      }
+      switch(info)
+      {
+        case Eigen::Success:
+          return true;
+        case Eigen::NumericalIssue:
+          cerr<<"Error: Numerical issue."<<endl;
+          return false;
+        default:
+          cerr<<"Error: Other."<<endl;
+          return false;
+      }
+    }
+
+    // Sparsity pattern of a (possibly uncompressed) sparse matrix in
+    // compressed form
+    //
+    // Inputs:
+    //   A  sparse matrix
+    // Outputs:
+    //   outer  #A.outerSize()+1 list of offsets into inner
+    //   inner  #A.nonZeros() list of inner indices
+    template <typename T>
+    IGL_INLINE void sparsity_pattern(
+      const Eigen::SparseMatrix<T> & A,
+      Eigen::VectorXi & outer,
+      Eigen::VectorXi & inner)
+    {
+      outer.resize(A.outerSize()+1);
+      inner.resize(A.nonZeros());
+      int k = 0;
+      outer(0) = 0;
+      for(int j = 0;j<A.outerSize();j++)
+      {
+        for(typename Eigen::SparseMatrix<T>::InnerIterator it(A,j);it;++it)
+        {
+          inner(k++) = it.index();
+        }
+        outer(j+1) = k;
+      }
+    }
+
+    // Preconditioner for Eigen::ConjugateGradient that applies one already
+    // computed in data (compute is a no-op), so that each thread can run its
+    // own solver without copying or rebuilding it
+    template <typename Preconditioner>
+    class SharedPreconditioner
+    {
+      private:
+        const Preconditioner * m_precond;
+      public:
+        SharedPreconditioner():m_precond(NULL){}
+        void set(const Preconditioner & precond){ m_precond = &precond; }
+        template <typename MatType>
+        SharedPreconditioner & analyzePattern(const MatType &){ return *this; }
+        template <typename MatType>
+        SharedPreconditioner & factorize(const MatType &){ return *this; }
+        template <typename MatType>
+        SharedPreconditioner & compute(const MatType &){ return *this; }
+        template <typename Rhs>
+        auto solve(const Eigen::MatrixBase<Rhs> & b) const ->
+          decltype(m_precond->solve(b))
+        {
+          return m_precond->solve(b);
+        }
+        Eigen::ComputationInfo info() const { return Eigen::Success; }
+    };
+
+    // Conjugate gradient on data.Auu preconditioned with precond
+    //
+    // Inputs:
+    //   data  factorization struct
+    //   precond  computed preconditioner of data.Auu
+    //   RHS  #rows by k right-hand sides
+    //   guess  #rows by k initial guess
+    // Outputs:
+    //   X  #rows by k solutions
+    // Returns true if every column converged, false otherwise
+    template <
+      typename T,
+      typename Preconditioner,
+      typename DerivedRHS,
+      typename Derivedguess,
+      typename DerivedX>
+    IGL_INLINE bool cg_solve(
+      const min_quad_with_fixed_data<T> & data,
+      const Preconditioner & precond,
+      const Eigen::MatrixBase<DerivedRHS> & RHS,
+      const Eigen::MatrixBase<Derivedguess> & guess,
+      Eigen::MatrixBase<DerivedX> & X)
+    {
+      Eigen::ConjugateGradient<Eigen::SparseMatrix<T>,
+        Eigen::Lower|Eigen::Upper,SharedPreconditioner<Preconditioner> > cg;
+      cg.preconditioner().set(precond);
+      cg.compute(data.Auu);
+      cg.setTolerance(data.cg_tolerance);
+      if(data.cg_max_iter > 0)
+      {
+        cg.setMaxIterations(data.cg_max_iter);
+      }
+      X = cg.solveWithGuess(RHS,guess);
+      return cg.info() == Eigen::Success;
+    }
+
+    // Solve all right-hand sides through the cached factorization. Columns
+    // are split into one contiguous block per thread so that supernodal
+    // solvers (SparseLU) still see several columns at a time. CHOLMOD's
+    // workspace is not thread-safe, so it solves all columns at once.
+    //
+    // Inputs:
+    //   data  factorization struct
+    //   RHS  #rows by k right-hand sides
+    //   guess  #rows by k initial guess for iterative backends (or empty)
+    // Outputs:
+    //   X  #rows by k solutions
+    // Returns true on success, false on error
+    template <typename T>
+    IGL_INLINE bool factored_solve(
+      const min_quad_with_fixed_data<T> & data,
+      const Eigen::Matrix<T,Eigen::Dynamic,Eigen::Dynamic> & RHS,
+      const Eigen::Matrix<T,Eigen::Dynamic,Eigen::Dynamic> & guess,
+      Eigen::Matrix<T,Eigen::Dynamic,Eigen::Dynamic> & X)
+    {
+      using namespace std;
+      if(data.solver_type < 0 ||
+        data.solver_type >= min_quad_with_fixed_data<T>::NUM_SOLVER_TYPES)
+      {
+        cerr<<"Error: invalid solver type"<<endl;
+        return false;
+      }
+      X.resize(RHS.rows(),RHS.cols());
+      const int ncols = RHS.cols();
+      if(ncols == 0)
+      {
+        return true;
+      }
+      const bool cg =
+        data.solver_type == min_quad_with_fixed_data<T>::LLT &&
+        (data.backend == min_quad_with_fixed_data<T>::CONJUGATE_GRADIENT ||
+         data.backend == min_quad_with_fixed_data<T>::MULTIGRID);
+#ifdef CHOLMOD
+      if(!cg &&
+        (data.solver_type == min_quad_with_fixed_data<T>::LLT ||
+         data.solver_type == min_quad_with_fixed_data<T>::QR_LLT) &&
+        data.backend == min_quad_with_fixed_data<T>::SUPERNODAL)
+      {
+        X = data.cholmod.solve(RHS);
+        return true;
+      }
+#endif
+      const int nthreads =
+        std::max(1,(int)std::thread::hardware_concurrency());
+      // Tiny solves are not worth a thread each
+      const int nblocks =
+        RHS.rows()*ncols < 10000 ? 1 : std::min(ncols,nthreads);
+      const int block = (ncols+nblocks-1)/nblocks;
+      std::atomic<bool> converged(true);
+      igl::parallel_for(nblocks,[&](const int b)
+      {
+        const int c0 = b*block;
+        const int bc = std::min(block,ncols-c0);
+        if(bc <= 0)
+        {
+          return;
+        }
+        switch(data.solver_type)
+        {
+          case igl::min_quad_with_fixed_data<T>::LLT:
+            if(cg)
+            {
+              const Eigen::Matrix<T,Eigen::Dynamic,Eigen::Dynamic> G =
+                guess.cols() == ncols ?
+                  Eigen::Matrix<T,Eigen::Dynamic,Eigen::Dynamic>(
+                    guess.middleCols(c0,bc)) :
+                  Eigen::Matrix<T,Eigen::Dynamic,Eigen::Dynamic>::Zero(
+                    RHS.rows(),bc);
+              auto Xb = X.middleCols(c0,bc);
+              const bool ok =
+                data.backend == min_quad_with_fixed_data<T>::MULTIGRID ?
+                  cg_solve(data,data.amg,RHS.middleCols(c0,bc),G,Xb) :
+                  cg_solve(data,data.cg_precond,RHS.middleCols(c0,bc),G,Xb);
+              if(!ok)
+              {
+                converged = false;
+              }
+              break;
+            }
+            // fall through
+          case igl::min_quad_with_fixed_data<T>::QR_LLT:
+            X.middleCols(c0,bc) = data.llt.solve(RHS.middleCols(c0,bc));
+            break;
+          case igl::min_quad_with_fixed_data<T>::LDLT:
+            X.middleCols(c0,bc) = data.ldlt.solve(RHS.middleCols(c0,bc));
+            break;
+          case igl::min_quad_with_fixed_data<T>::LU:
+            // Not a bottleneck
+            X.middleCols(c0,bc) = data.lu.solve(RHS.middleCols(c0,bc));
+            break;
+          default:
+            break;
+        }
+      },2);
+      if(!converged)
+      {
+        cerr<<"Error: conjugate gradient did not converge."<<endl;
+        return false;
+      }
+      return true;
+    }
+  }
+}
 
 template <typename T, typename Derivedknown>
 IGL_INLINE bool igl::min_quad_with_fixed_precompute(
@@ -44,6 +324,9 @@ IGL_INLINE bool igl::min_quad_with_fixed_precompute(
   int n = A.rows();
   // cache problem size
   data.n = n;
+  min_quad_with_fixed_helpers::sparsity_pattern(A2,data.A_outer,data.A_inner);
+  // cache constraints (needed to rebuild the system in refactor)
+  data.Aeq = Aeq;
 
   int neq = Aeq.rows();
   // default is to have 0 linear equality constraints
@@ -103,6 +386,12 @@ IGL_INLINE bool igl::min_quad_with_fixed_precompute(
     data.unknown_lagrange.tail(data.lagrange.size()) = data.lagrange;
   }
 
+  // no updates of the known variables yet
+  data.base_unknown = data.unknown;
+  data.border.resize(0);
+  data.fixed_in_base.resize(0);
+  data.fixed_in_known.resize(0);
+
   SparseMatrix<T> Auu;
   slice(A,data.unknown,data.unknown,Auu);
   assert(Auu.size() != 0 && Auu.rows() > 0 && "There should be at least one unknown.");
@@ -214,17 +503,9 @@ IGL_INLINE bool igl::min_quad_with_fixed_precompute(
 #ifdef MIN_QUAD_WITH_FIXED_CPP_DEBUG
     cout<<"    llt"<<endl;
 #endif
-      data.llt.compute(Auu);
-      switch(data.llt.info())
+      if(!min_quad_with_fixed_helpers::factor_pd(Auu,true,true,data))
       {
-        case Eigen::Success:
-          break;
-        case Eigen::NumericalIssue:
-          cerr<<"Error: Numerical issue."<<endl;
-          return false;
-        default:
-          cerr<<"Error: Other."<<endl;
-          return false;
+        return false;
       }
       data.solver_type = min_quad_with_fixed_data<T>::LLT;
     }else
@@ -261,7 +542,8 @@ IGL_INLINE bool igl::min_quad_with_fixed_precompute(
 #endif
         // Resort to LU
         // Bottleneck >1/2
-        data.lu.compute(NA);
+        data.lu.analyzePattern(NA);
+        data.lu.factorize(NA);
         //std::cout<<"NA=["<<std::endl<<NA<<std::endl<<"];"<<std::endl;
         switch(data.lu.info())
         {
@@ -345,17 +627,9 @@ IGL_INLINE bool igl::min_quad_with_fixed_precompute(
       cout<<"    factorize"<<endl;
 #endif
       // QRAuu should always be PD
-      data.llt.compute(QRAuu);
-      switch(data.llt.info())
+      if(!min_quad_with_fixed_helpers::factor_pd(QRAuu,true,false,data))
       {
-        case Eigen::Success:
-          break;
-        case Eigen::NumericalIssue:
-          cerr<<"Error: Numerical issue."<<endl;
-          return false;
-        default:
-          cerr<<"Error: Other."<<endl;
-          return false;
+        return false;
       }
       data.solver_type = min_quad_with_fixed_data<T>::QR_LLT;
     }
@@ -379,6 +653,259 @@ IGL_INLINE bool igl::min_quad_with_fixed_precompute(
 }
 
 
+template <typename T>
+IGL_INLINE bool igl::min_quad_with_fixed_refactor(
+  const Eigen::SparseMatrix<T>& A2,
+  min_quad_with_fixed_data<T> & data)
+{
+  using namespace Eigen;
+  using namespace std;
+  const int n = data.n;
+  assert(A2.rows() == n && "A should match precomputed size");
+  assert(A2.cols() == n && "A should match precomputed size");
+  VectorXi outer,inner;
+  min_quad_with_fixed_helpers::sparsity_pattern(A2,outer,inner);
+  if(A2.rows() != n || A2.cols() != n ||
+    outer.size() != data.A_outer.size() ||
+    inner.size() != data.A_inner.size() ||
+    outer != data.A_outer || inner != data.A_inner)
+  {
+    cerr<<"Error: sparsity pattern of A changed since precompute."<<endl;
+    return false;
+  }
+  if(data.border.size() + data.fixed_in_base.size() > 0)
+  {
+    cerr<<"Error: known variables changed since precompute."<<endl;
+    return false;
+  }
+  const SparseMatrix<T> A = 0.5*A2;
+  const int kr = data.known.size();
+  SparseMatrix<T> Auu;
+  slice(A,data.unknown,data.unknown,Auu);
+
+  switch(data.solver_type)
+  {
+    case min_quad_with_fixed_data<T>::LLT:
+    {
+      // No lagrange multipliers: new_A is just A
+      if(kr > 0)
+      {
+        SparseMatrix<T> Auk;
+        slice(A,data.unknown,data.known,Auk);
+        data.preY = Auk*2;
+      }
+      if(!min_quad_with_fixed_helpers::factor_pd(Auu,false,true,data))
+      {
+        return false;
+      }
+      break;
+    }
+    case min_quad_with_fixed_data<T>::LDLT:
+    case min_quad_with_fixed_data<T>::LU:
+    {
+      const int neq = data.lagrange.size();
+      SparseMatrix<T> AeqT = data.Aeq.transpose();
+      SparseMatrix<T> Z(neq,neq);
+      const SparseMatrix<T> new_A = cat(1, cat(2,        A, AeqT ),
+                                           cat(2, data.Aeq,    Z ));
+      if(kr > 0)
+      {
+        SparseMatrix<T> Aulk,Akul;
+        slice(new_A,data.unknown_lagrange,data.known,Aulk);
+        if(data.Auu_sym)
+        {
+          data.preY = Aulk*2;
+        }else
+        {
+          slice(new_A,data.known,data.unknown_lagrange,Akul);
+          SparseMatrix<T> AkulT = Akul.transpose();
+          data.preY = Aulk + AkulT;
+        }
+      }
+      slice(new_A,data.unknown_lagrange,data.unknown_lagrange,data.NA);
+      if(data.solver_type == min_quad_with_fixed_data<T>::LDLT)
+      {
+        data.ldlt.factorize(data.NA);
+        if(data.ldlt.info() != Eigen::Success)
+        {
+          cerr<<"Error: Numerical issue."<<endl;
+          return false;
+        }
+        break;
+      }
+      data.lu.factorize(data.NA);
+      switch(data.lu.info())
+      {
+        case Eigen::Success:
+          break;
+        case Eigen::NumericalIssue:
+          cerr<<"Error: Numerical issue."<<endl;
+          return false;
+        case Eigen::InvalidInput:
+          cerr<<"Error: Invalid Input."<<endl;
+          return false;
+        default:
+          cerr<<"Error: Other."<<endl;
+          return false;
+      }
+      break;
+    }
+    case min_quad_with_fixed_data<T>::QR_LLT:
+    {
+      // Null space of the constraints does not depend on A
+      SparseMatrix<T> QRAuu = data.AeqTQ2T * Auu * data.AeqTQ2;
+      if(!min_quad_with_fixed_helpers::factor_pd(QRAuu,false,false,data))
+      {
+        return false;
+      }
+      SparseMatrix<T> Auk;
+      slice(A,data.unknown,data.known,Auk);
+      SparseMatrix<T> Aku;
+      slice(A,data.known,data.unknown,Aku);
+      SparseMatrix<T> AkuT = Aku.transpose();
+      data.preY = Auk + AkuT;
+      data.Auu = Auu;
+      break;
+    }
+    default:
+      cerr<<"Error: Unknown solver type."<<endl;
+      return false;
+  }
+  return true;
+}
+
+
+template <typename T, typename Derivedknown>
+IGL_INLINE bool igl::min_quad_with_fixed_update_known(
+  const Eigen::SparseMatrix<T>& A2,
+  const Eigen::MatrixBase<Derivedknown> & known,
+  min_quad_with_fixed_data<T> & data)
+{
+  using namespace Eigen;
+  using namespace std;
+  typedef Matrix<T,Dynamic,1> VectorXT;
+  typedef Matrix<T,Dynamic,Dynamic> MatrixXT;
+  if(data.solver_type != min_quad_with_fixed_data<T>::LLT)
+  {
+    cerr<<"Error: updating known variables requires a positive definite "
+      "system without equality constraints."<<endl;
+    return false;
+  }
+  const int n = data.n;
+  assert(A2.rows() == n && A2.cols() == n && "A should match precomputed size");
+  const int kr = known.size();
+  assert((kr == 0 || known.minCoeff() >= 0)&& "known indices should be in [0,n)");
+  assert((kr == 0 || known.maxCoeff() < n) && "known indices should be in [0,n)");
+
+  // Classify variables with respect to the factored system
+  const int n0 = data.base_unknown.size();
+  vector<int> base_pos(n,-1);
+  for(int i = 0;i<n0;i++)
+  {
+    base_pos[data.base_unknown(i)] = i;
+  }
+  vector<bool> known_mask(n,false);
+  vector<int> fixed_in_base,fixed_in_known,border;
+  for(int j = 0;j<kr;j++)
+  {
+    known_mask[known(j)] = true;
+    if(base_pos[known(j)] >= 0)
+    {
+      fixed_in_base.push_back(base_pos[known(j)]);
+      fixed_in_known.push_back(j);
+    }
+  }
+  for(int i = 0;i<n;i++)
+  {
+    if(base_pos[i] < 0 && !known_mask[i])
+    {
+      border.push_back(i);
+    }
+  }
+  const int r = border.size();
+  const int a = fixed_in_base.size();
+  data.known = known.template cast<int>();
+  data.unknown.resize(n-kr);
+  for(int i = 0,u = 0;i<n;i++)
+  {
+    if(!known_mask[i])
+    {
+      data.unknown(u++) = i;
+    }
+  }
+  data.unknown_lagrange = data.unknown;
+  data.border = Map<VectorXi>(border.data(),r);
+  data.fixed_in_base = Map<VectorXi>(fixed_in_base.data(),a);
+  data.fixed_in_known = Map<VectorXi>(fixed_in_known.data(),a);
+
+  const SparseMatrix<T> A = 0.5*A2;
+  // Variables of the bordered system: [base_unknown;border]
+  VectorXi BU(n0+r);
+  BU.head(n0) = data.base_unknown;
+  BU.tail(r) = data.border;
+  if(kr > 0)
+  {
+    // Newly known variables enter through the constraints instead
+    SparseMatrix<T> Ak;
+    slice(A,BU,data.known,Ak);
+    VectorXT w = VectorXT::Constant(kr,2);
+    for(int j = 0;j<a;j++)
+    {
+      w(fixed_in_known[j]) = 0;
+    }
+    data.preY = Ak*w.asDiagonal();
+  }else
+  {
+    data.preY.resize(n0+r,0);
+  }
+
+  // Coupling of the factored system with the border variables and with the
+  // constraints fixing the newly known ones
+  SparseMatrix<T> Aur;
+  slice(A,data.base_unknown,data.border,Aur);
+  vector<Triplet<T> > IJV;
+  IJV.reserve(Aur.nonZeros()+a);
+  for(int k = 0;k<Aur.outerSize();k++)
+  {
+    for(typename SparseMatrix<T>::InnerIterator it(Aur,k);it;++it)
+    {
+      IJV.emplace_back(it.row(),it.col(),it.value());
+    }
+  }
+  for(int j = 0;j<a;j++)
+  {
+    IJV.emplace_back(fixed_in_base[j],r+j,1);
+  }
+  if(r+a == 0)
+  {
+    // Back to the factored system
+    data.border_B.resize(n0,0);
+    data.border_W.resize(n0,0);
+    return true;
+  }
+  data.border_B.resize(n0,r+a);
+  data.border_B.setFromTriplets(IJV.begin(),IJV.end());
+  MatrixXT D = MatrixXT::Zero(r+a,r+a);
+  if(r > 0)
+  {
+    SparseMatrix<T> Arr;
+    slice(A,data.border,data.border,Arr);
+    D.topLeftCorner(r,r) = MatrixXT(Arr);
+  }
+  if(!min_quad_with_fixed_helpers::factored_solve(
+    data,MatrixXT(data.border_B),MatrixXT(),data.border_W))
+  {
+    return false;
+  }
+  data.border_S.compute(D - data.border_B.transpose()*data.border_W);
+  if(!data.border_S.isInvertible())
+  {
+    cerr<<"Error: Numerical issue."<<endl;
+    return false;
+  }
+  return true;
+}
+
 template <
   typename T,
   typename DerivedB,
@@ -409,6 +936,26 @@ IGL_INLINE bool igl::min_quad_with_fixed_solve(
   assert(B.cols() == 1 || B.cols() == cols);
   assert(Beq.size() == 0 || Beq.cols() == 1 || Beq.cols() == cols);
 
+  // Initial guess for iterative backends (sol = -2*Z(unknown))
+  MatrixXT guess;
+  if(data.cg_warm_start &&
+    data.solver_type == min_quad_with_fixed_data<T>::LLT &&
+    (data.backend == min_quad_with_fixed_data<T>::CONJUGATE_GRADIENT ||
+     data.backend == min_quad_with_fixed_data<T>::MULTIGRID) &&
+    Z.rows() == data.n && Z.cols() == cols)
+  {
+    guess.resize(data.base_unknown.size(),cols);
+    for(int i = 0;i<data.base_unknown.size();i++)
+    {
+      guess.row(i) = -2.0*Z.row(data.base_unknown(i)).template cast<T>();
+    }
+  }
+  const auto & factored_solve =
+    [&data,&guess](const MatrixXT & RHS, MatrixXT & X)->bool
+  {
+    return min_quad_with_fixed_helpers::factored_solve(data,RHS,guess,X);
+  };
+
   // resize output
   Z.resize(data.n,cols);
   // Set known values
@@ -420,7 +967,67 @@ IGL_INLINE bool igl::min_quad_with_fixed_solve(
     }
   }
 
-  if(data.Aeq_li)
+  if(data.border.size() + data.fixed_in_base.size() > 0)
+  {
+    // Known variables changed since precompute: solve the factored system
+    // bordered by the released variables and by constraints fixing the newly
+    // known ones, via the Schur complement
+    const int n0 = data.base_unknown.size();
+    const int r = data.border.size();
+    const int a = data.fixed_in_base.size();
+    MatrixXT BB = MatrixXT::Zero(data.n,cols);
+    if(B.size() > 0)
+    {
+      BB = B.replicate(1,B.cols()==cols?1:cols);
+    }
+    MatrixXT NB(n0+r,cols);
+    for(int i = 0;i<n0;i++)
+    {
+      NB.row(i) = BB.row(data.base_unknown(i));
+    }
+    for(int i = 0;i<r;i++)
+    {
+      NB.row(n0+i) = BB.row(data.border(i));
+    }
+    if(kr > 0)
+    {
+      NB += data.preY * Y;
+    }
+    // As below, solve for sol/-0.5
+    MatrixXT x;
+    if(!factored_solve(NB.topRows(n0),x))
+    {
+      return false;
+    }
+    MatrixXT g(r+a,cols);
+    g.topRows(r) = NB.bottomRows(r);
+    for(int j = 0;j<a;j++)
+    {
+      g.row(r+j) = -2.0*Y.row(data.fixed_in_known(j));
+    }
+    g -= data.border_B.transpose()*x;
+    const MatrixXT z = data.border_S.solve(g);
+    x -= data.border_W*z;
+    for(int i = 0;i<n0;i++)
+    {
+      Z.row(data.base_unknown(i)) = -0.5*x.row(i);
+    }
+    for(int i = 0;i<r;i++)
+    {
+      Z.row(data.border(i)) = -0.5*z.row(i);
+    }
+    // Newly known values are only met up to round-off
+    for(int j = 0;j<a;j++)
+    {
+      Z.row(data.base_unknown(data.fixed_in_base(j))) =
+        Y.row(data.fixed_in_known(j));
+    }
+    sol.resize(data.unknown.size(),cols);
+    for(int i = 0;i<data.unknown.size();i++)
+    {
+      sol.row(i) = Z.row(data.unknown(i));
+    }
+  }else if(data.Aeq_li)
   {
     // number of lagrange multipliers aka linear equality constraints
     int neq = data.lagrange.size();
@@ -449,21 +1056,13 @@ IGL_INLINE bool igl::min_quad_with_fixed_solve(
 
     //std::cout<<"NB=["<<std::endl<<NB<<std::endl<<"];"<<std::endl;
     //cout<<matlab_format(NB,"NB")<<endl;
-    switch(data.solver_type)
     {
-      case igl::min_quad_with_fixed_data<T>::LLT:
-        sol = data.llt.solve(NB);
-        break;
-      case igl::min_quad_with_fixed_data<T>::LDLT:
-        sol = data.ldlt.solve(NB);
-        break;
-      case igl::min_quad_with_fixed_data<T>::LU:
-        // Not a bottleneck
-        sol = data.lu.solve(NB);
-        break;
-      default:
-        cerr<<"Error: invalid solver type"<<endl;
+      MatrixXT X;
+      if(!factored_solve(NB,X))
+      {
         return false;
+      }
+      sol = X;
     }
     //std::cout<<"sol=["<<std::endl<<sol<<std::endl<<"];"<<std::endl;
     // Now sol contains sol/-0.5
@@ -501,8 +1100,11 @@ IGL_INLINE bool igl::min_quad_with_fixed_solve(
     //cout<<matlab_format(lambda_0,"lambda_0")<<endl;
     MatrixXT QRB;
     QRB = -data.AeqTQ2T * (data.Auu * lambda_0) + data.AeqTQ2T * NB;
-    Derivedsol lambda;
-    lambda = data.llt.solve(QRB);
+    MatrixXT lambda;
+    if(!factored_solve(QRB,lambda))
+    {
+      return false;
+    }
     // prepare output
     Derivedsol solu;
     solu = data.AeqTQ2 * lambda + lambda_0;
@@ -582,6 +1184,8 @@ IGL_INLINE bool igl::min_quad_with_fixed(
 
 #ifdef IGL_STATIC_LIBRARY
 // Explicit template instantiation
+template bool igl::min_quad_with_fixed_update_known<double, Eigen::Matrix<int, -1, 1, 0, -1, 1> >(Eigen::SparseMatrix<double, 0, int> const&, Eigen::MatrixBase<Eigen::Matrix<int, -1, 1, 0, -1, 1> > const&, igl::min_quad_with_fixed_data<double>&);
+template bool igl::min_quad_with_fixed_refactor<double>(Eigen::SparseMatrix<double, 0, int> const&, igl::min_quad_with_fixed_data<double>&);
 // generated by autoexplicit.sh
 template bool igl::min_quad_with_fixed<double, Eigen::Matrix<int, -1, 1, 0, -1, 1>, Eigen::Matrix<double, -1, 1, 0, -1, 1>, Eigen::Matrix<double, -1, -1, 0, -1, -1>, Eigen::Matrix<double, -1, 1, 0, -1, 1>, Eigen::Matrix<double, -1, -1, 0, -1, -1> >(Eigen::SparseMatrix<double, 0, int> const&, Eigen::MatrixBase<Eigen::Matrix<double, -1, 1, 0, -1, 1> > const&, Eigen::MatrixBase<Eigen::Matrix<int, -1, 1, 0, -1, 1> > const&, Eigen::MatrixBase<Eigen::Matrix<double, -1, -1, 0, -1, -1> > const&, Eigen::SparseMatrix<double, 0, int> const&, Eigen::MatrixBase<Eigen::Matrix<double, -1, 1, 0, -1, 1> > const&, bool, Eigen::PlainObjectBase<Eigen::Matrix<double, -1, -1, 0, -1, -1> >&);
 template bool igl::min_quad_with_fixed_solve<double, Eigen::Matrix<double, -1, 1, 0, -1, 1>, Eigen::Matrix<double, -1, 1, 0, -1, 1>, Eigen::Matrix<double, -1, 1, 0, -1, 1>, Eigen::Matrix<double, -1, 1, 0, -1, 1> >(igl::min_quad_with_fixed_data<double> const&, Eigen::MatrixBase<Eigen::Matrix<double, -1, 1, 0, -1, 1> > const&, Eigen::MatrixBase<Eigen::Matrix<double, -1, 1, 0, -1, 1> > const&, Eigen::MatrixBase<Eigen::Matrix<double, -1, 1, 0, -1, 1> > const&, Eigen::PlainObjectBase<Eigen::Matrix<double, -1, 1, 0, -1, 1> >&);
@@ -8,6 +8,7 @@
 #ifndef IGL_MIN_QUAD_WITH_FIXED_H
 #define IGL_MIN_QUAD_WITH_FIXED_H
 #include "igl_inline.h"
+#include "AlgebraicMultigrid.h"
 
 #define EIGEN_YES_I_KNOW_SPARSE_MODULE_IS_NOT_STABLE_YET
 #include <Eigen/Core>
@@ -16,6 +17,9 @@
 // Bug in unsupported/Eigen/SparseExtra needs iostream first
 #include <iostream>
 #include <unsupported/Eigen/SparseExtra>
+#ifdef CHOLMOD
+#include <Eigen/CholmodSupport>
+#endif
 
 namespace igl
 {
@@ -59,6 +63,51 @@ namespace igl
     const bool pd,
     min_quad_with_fixed_data<T> & data
     );
+  // Refactor a system previously prepared with min_quad_with_fixed_precompute
+  // after the values of A changed but not its sparsity pattern (e.g. new
+  // weights in a reweighted least squares loop, a new time step or
+  // stiffness). The known/unknown partition, the QR of Aeq and the symbolic
+  // analysis of the solver (fill-reducing ordering and elimination tree) are
+  // reused; only the numeric factorization is recomputed.
+  //
+  // Inputs:
+  //   A  n by n matrix of quadratic coefficients with the same sparsity
+  //     pattern as the one passed to min_quad_with_fixed_precompute
+  //   data  factorization struct from min_quad_with_fixed_precompute (its
+  //     backend should not have changed since)
+  // Outputs:
+  //   data  updated factorization struct
+  // Returns true on success, false on error (e.g. if the sparsity pattern of
+  // A changed)
+  template <typename T>
+  IGL_INLINE bool min_quad_with_fixed_refactor(
+    const Eigen::SparseMatrix<T>& A,
+    min_quad_with_fixed_data<T> & data);
+  // Update a system previously prepared with min_quad_with_fixed_precompute to
+  // a new list of known variables without refactoring it. Variables that
+  // became known are fixed with lagrange multipliers and previously known
+  // variables that became unknown border the factored system, so that only the
+  // small dense Schur complement of this bordered system needs to be factored.
+  // This costs one solve with the cached factorization per changed variable
+  // and is meant for small changes (e.g. grabbing or releasing a handle).
+  // Changes are always taken relative to the known list given to precompute,
+  // so call min_quad_with_fixed_precompute again once many variables changed.
+  // Only supported for positive definite systems without linear equality
+  // constraints (solver_type LLT).
+  //
+  // Inputs:
+  //   A  n by n matrix of quadratic coefficients as passed to
+  //     min_quad_with_fixed_precompute
+  //   known  list of indices to known rows in Z
+  //   data  factorization struct from min_quad_with_fixed_precompute
+  // Outputs:
+  //   data  updated struct to be used with min_quad_with_fixed_solve
+  // Returns true on success, false on error
+  template <typename T, typename Derivedknown>
+  IGL_INLINE bool min_quad_with_fixed_update_known(
+    const Eigen::SparseMatrix<T>& A,
+    const Eigen::MatrixBase<Derivedknown> & known,
+    min_quad_with_fixed_data<T> & data);
   // Solves a system previously factored using min_quad_with_fixed_precompute
   //
   // Template:
@@ -71,7 +120,8 @@ namespace igl
   //   Y  b by k list of constant fixed values
   //   Beq  m by k list of linear equality constraint constant values
   // Outputs:
-  //   Z  n by k solution
+  //   Z  n by k solution (on input, initial guess for iterative backends if
+  //     data.cg_warm_start)
   //   sol  #unknowns+#lagrange by k solution to linear system
   // Returns true on success, false on error
   template <
@@ -124,6 +174,12 @@ struct igl::min_quad_with_fixed_data
 {
   // Size of original system: number of unknowns + number of knowns
   int n;
+  // Sparsity pattern of A (compressed outer and inner indices), checked by
+  // refactor
+  Eigen::VectorXi A_outer;
+  Eigen::VectorXi A_inner;
+  // Linear equality constraints
+  Eigen::SparseMatrix<T> Aeq;
   // Whether A(unknown,unknown) is positive definite
   bool Auu_pd;
   // Whether A(unknown,unknown) is symmetric
@@ -146,8 +202,39 @@ struct igl::min_quad_with_fixed_data
     QR_LLT = 3,
     NUM_SOLVER_TYPES = 4
   } solver_type;
+  // Backend used for the positive definite systems (solver_type LLT and
+  // QR_LLT). Set before calling min_quad_with_fixed_precompute.
+  //   EIGEN_SIMPLICIAL  Eigen::SimplicialLLT
+  //   SUPERNODAL  CHOLMOD's supernodal Cholesky if compiled with -DCHOLMOD,
+  //     otherwise falls back to EIGEN_SIMPLICIAL
+  //   CONJUGATE_GRADIENT  Jacobi preconditioned conjugate gradient, for
+  //     systems whose factorization does not fit in memory. Only used for
+  //     solver_type LLT (falls back to EIGEN_SIMPLICIAL otherwise).
+  //   MULTIGRID  conjugate gradient preconditioned with igl::AlgebraicMultigrid
+  //     (parameters in amg), otherwise like CONJUGATE_GRADIENT. Needs far
+  //     fewer iterations on large meshes.
+  enum Backend
+  {
+    EIGEN_SIMPLICIAL = 0,
+    SUPERNODAL = 1,
+    CONJUGATE_GRADIENT = 2,
+    MULTIGRID = 3,
+    NUM_BACKENDS = 4
+  } backend;
+  // Relative residual tolerance and maximum number of iterations (0 means
+  // 2*#unknowns) of CONJUGATE_GRADIENT and MULTIGRID
+  T cg_tolerance;
+  int cg_max_iter;
+  // Whether CONJUGATE_GRADIENT and MULTIGRID start from the Z passed to
+  // min_quad_with_fixed_solve (if it has the right size) instead of zero
+  bool cg_warm_start;
   // Solvers
   Eigen::SimplicialLLT <Eigen::SparseMatrix<T > > llt;
+#ifdef CHOLMOD
+  Eigen::CholmodSupernodalLLT<Eigen::SparseMatrix<T > > cholmod;
+#endif
+  Eigen::DiagonalPreconditioner<T> cg_precond;
+  igl::AlgebraicMultigrid<T> amg;
   Eigen::SimplicialLDLT<Eigen::SparseMatrix<T > > ldlt;
   Eigen::SparseLU<Eigen::SparseMatrix<T, Eigen::ColMajor>, Eigen::COLAMDOrdering<int> >   lu;
   // QR factorization
@@ -167,9 +254,30 @@ struct igl::min_quad_with_fixed_data
   Eigen::SparseMatrix<T> AeqTR1T;
   Eigen::SparseMatrix<T> AeqTE;
   Eigen::SparseMatrix<T> AeqTET;
+  // Updates of the known variables since precompute (see
+  // min_quad_with_fixed_update_known)
+  // Indices of unknown variables of the factored system
+  Eigen::VectorXi base_unknown;
+  // Indices of previously known variables that are now unknown
+  Eigen::VectorXi border;
+  // Positions of newly known variables in base_unknown and in known
+  Eigen::VectorXi fixed_in_base;
+  Eigen::VectorXi fixed_in_known;
+  // Coupling of the factored system to the border and newly known variables,
+  // the factored system's inverse applied to it and the factored Schur
+  // complement
+  Eigen::SparseMatrix<T> border_B;
+  Eigen::Matrix<T,Eigen::Dynamic,Eigen::Dynamic> border_W;
+  Eigen::FullPivLU<Eigen::Matrix<T,Eigen::Dynamic,Eigen::Dynamic> > border_S;
   // Debug
   Eigen::SparseMatrix<T> NA;
   Eigen::Matrix<T,Eigen::Dynamic,Eigen::Dynamic> NB;
+  min_quad_with_fixed_data():
+    backend(EIGEN_SIMPLICIAL),
+    cg_tolerance(1e-10),
+    cg_max_iter(0),
+    cg_warm_start(false)
+  {}
 };
 
 #ifndef IGL_STATIC_LIBRARY
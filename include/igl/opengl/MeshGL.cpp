@@ -10,6 +10,9 @@
 #include "bind_vertex_attrib_array.h"
 #include "create_shader_program.h"
 #include "destroy_shader_program.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
 #include <iostream>
 
 IGL_INLINE void igl::opengl::MeshGL::init_buffers()
@@ -24,22 +27,21 @@ IGL_INLINE void igl::opengl::MeshGL::init_buffers()
   glGenBuffers(1, &vbo_V_specular);
   glGenBuffers(1, &vbo_V_uv);
   glGenBuffers(1, &vbo_F);
+  glGenBuffers(1, &vbo_instance_transforms);
+  glGenBuffers(1, &vbo_instance_colors);
   glGenTextures(1, &vbo_tex);
 
   // Line overlay
   glGenVertexArrays(1, &vao_overlay_lines);
   glBindVertexArray(vao_overlay_lines);
-  glGenBuffers(1, &vbo_lines_F);
-  glGenBuffers(1, &vbo_lines_V);
-  glGenBuffers(1, &vbo_lines_V_colors);
-  glGenBuffers(1, &vbo_lines_V_normals);
+  glGenBuffers(1, &lines_buffer.vbo);
+  lines_buffer.uploaded = lines_buffer.gpu_capacity = 0;
 
   // Point overlay
   glGenVertexArrays(1, &vao_overlay_points);
   glBindVertexArray(vao_overlay_points);
-  glGenBuffers(1, &vbo_points_F);
-  glGenBuffers(1, &vbo_points_V);
-  glGenBuffers(1, &vbo_points_V_colors);
+  glGenBuffers(1, &points_buffer.vbo);
+  points_buffer.uploaded = points_buffer.gpu_capacity = 0;
 
   // Laser overlay
   glGenVertexArrays(1, &vao_laser_points);
@@ -52,9 +54,8 @@ IGL_INLINE void igl::opengl::MeshGL::init_buffers()
   // Linestrip overlay
   glGenVertexArrays(1, &vao_overlay_strip);
   glBindVertexArray(vao_overlay_strip);
-  glGenBuffers(1, &vbo_overlay_strip_F);
-  glGenBuffers(1, &vbo_overlay_strip_V);
-  glGenBuffers(1, &vbo_overlay_strip_V_colors);
+  glGenBuffers(1, &overlay_strip_buffer.vbo);
+  overlay_strip_buffer.uploaded = overlay_strip_buffer.gpu_capacity = 0;
 
   // Hand marker overlay
   glGenVertexArrays(1, &vao_hand_point);
@@ -84,19 +85,14 @@ IGL_INLINE void igl::opengl::MeshGL::free_buffers()
     glDeleteBuffers(1, &vbo_V_specular);
     glDeleteBuffers(1, &vbo_V_uv);
     glDeleteBuffers(1, &vbo_F);
-    glDeleteBuffers(1, &vbo_lines_F);
-    glDeleteBuffers(1, &vbo_lines_V);
-    glDeleteBuffers(1, &vbo_lines_V_colors);
-	glDeleteBuffers(1, &vbo_lines_V_normals);
-    glDeleteBuffers(1, &vbo_points_F);
-    glDeleteBuffers(1, &vbo_points_V);
-    glDeleteBuffers(1, &vbo_points_V_colors);
+    glDeleteBuffers(1, &vbo_instance_transforms);
+    glDeleteBuffers(1, &vbo_instance_colors);
+    glDeleteBuffers(1, &lines_buffer.vbo);
+    glDeleteBuffers(1, &points_buffer.vbo);
 	glDeleteBuffers(1, &vbo_laser_points_V);
 	glDeleteBuffers(1, &vbo_laser_points_F);
 	glDeleteBuffers(1, &vbo_laser_V_colors);
-	glDeleteBuffers(1, &vbo_overlay_strip_F);
-	glDeleteBuffers(1, &vbo_overlay_strip_V);
-	glDeleteBuffers(1, &vbo_overlay_strip_V_colors);
+	glDeleteBuffers(1, &overlay_strip_buffer.vbo);
 	glDeleteBuffers(1, &vbo_hand_point_F);
 	glDeleteBuffers(1, &vbo_hand_point_V);
 	glDeleteBuffers(1, &vbo_hand_point_V_colors);
@@ -105,16 +101,177 @@ IGL_INLINE void igl::opengl::MeshGL::free_buffers()
   }
 }
 
+IGL_INLINE void igl::opengl::MeshGL::compact_vertex_buffers()
+{
+  // Round to nearest, flushing denormals to zero
+  const auto float_to_half = [](float f)->unsigned short
+  {
+    uint32_t x;
+    std::memcpy(&x, &f, sizeof(float));
+    const unsigned short sign = (x >> 16) & 0x8000;
+    const int exponent = int((x >> 23) & 0xFF) - 127 + 15;
+    uint32_t mantissa = x & 0x7FFFFF;
+    if (((x >> 23) & 0xFF) == 0xFF)
+      return sign | 0x7C00 | (mantissa ? 0x200 : 0);
+    if (exponent >= 0x1F)
+      return sign | 0x7C00;
+    if (exponent <= 0)
+      return sign;
+    unsigned short h = sign | (exponent << 10) | (mantissa >> 13);
+    if (mantissa & 0x1000)
+      h++;
+    return h;
+  };
+  const auto to_unorm8 = [](const RowMatrixXf & X, RowMatrixXuc & Y)
+  {
+    Y.resize(X.rows(), X.cols());
+    for (int i = 0; i < X.size(); ++i)
+      Y.data()[i] = (unsigned char)std::round(std::min(std::max(X.data()[i], 0.0f), 1.0f) * 255.0f);
+  };
+
+  if (dirty & MeshGL::DIRTY_POSITION)
+  {
+    V_vbo_compact.resize(V_vbo.rows(), 4);
+    if (V_vbo.rows() > 0)
+    {
+      V_vbo_min = V_vbo.colwise().minCoeff();
+      V_vbo_extent = V_vbo.colwise().maxCoeff() - V_vbo_min;
+      for (int d = 0; d < 3; ++d)
+        if (V_vbo_extent(d) <= 0)
+          V_vbo_extent(d) = 1;
+      for (int i = 0; i < V_vbo.rows(); ++i)
+      {
+        for (int d = 0; d < 3; ++d)
+          V_vbo_compact(i, d) = (unsigned short)std::round((V_vbo(i, d) - V_vbo_min(d)) / V_vbo_extent(d) * 65535.0f);
+        V_vbo_compact(i, 3) = 0;
+      }
+    }
+    V_vbo.resize(0, 0);
+  }
+  if (dirty & MeshGL::DIRTY_NORMAL)
+  {
+    // Octahedral encoding [Meyer et al. 2010]
+    V_normals_vbo_compact.resize(V_normals_vbo.rows(), 2);
+    for (int i = 0; i < V_normals_vbo.rows(); ++i)
+    {
+      Eigen::RowVector3f n = V_normals_vbo.row(i);
+      const float l1 = n.cwiseAbs().sum();
+      if (l1 > 0)
+        n /= l1;
+      float x = n(0), y = n(1);
+      if (n(2) < 0)
+      {
+        x = (1.0f - std::abs(n(1))) * (n(0) >= 0 ? 1.0f : -1.0f);
+        y = (1.0f - std::abs(n(0))) * (n(1) >= 0 ? 1.0f : -1.0f);
+      }
+      V_normals_vbo_compact(i, 0) = (short)std::round(std::min(std::max(x, -1.0f), 1.0f) * 32767.0f);
+      V_normals_vbo_compact(i, 1) = (short)std::round(std::min(std::max(y, -1.0f), 1.0f) * 32767.0f);
+    }
+    V_normals_vbo.resize(0, 0);
+  }
+  if (dirty & MeshGL::DIRTY_AMBIENT)
+  {
+    to_unorm8(V_ambient_vbo, V_ambient_vbo_compact);
+    V_ambient_vbo.resize(0, 0);
+  }
+  if (dirty & MeshGL::DIRTY_DIFFUSE)
+  {
+    to_unorm8(V_diffuse_vbo, V_diffuse_vbo_compact);
+    V_diffuse_vbo.resize(0, 0);
+  }
+  if (dirty & MeshGL::DIRTY_SPECULAR)
+  {
+    to_unorm8(V_specular_vbo, V_specular_vbo_compact);
+    V_specular_vbo.resize(0, 0);
+  }
+  if (dirty & MeshGL::DIRTY_UV)
+  {
+    V_uv_vbo_compact.resize(V_uv_vbo.rows(), V_uv_vbo.cols());
+    for (int i = 0; i < V_uv_vbo.size(); ++i)
+      V_uv_vbo_compact.data()[i] = float_to_half(V_uv_vbo.data()[i]);
+    V_uv_vbo.resize(0, 0);
+  }
+}
+
+IGL_INLINE igl::opengl::MeshGL::GLuint igl::opengl::MeshGL::active_shader_mesh() const
+{
+  return compact_vertex_format ? shader_mesh_compact : shader_mesh;
+}
+
 IGL_INLINE void igl::opengl::MeshGL::bind_mesh()
 {
   glBindVertexArray(vao_mesh);
-  glUseProgram(shader_mesh);
-  bind_vertex_attrib_array(shader_mesh,"position", vbo_V, V_vbo, dirty & MeshGL::DIRTY_POSITION);
-  bind_vertex_attrib_array(shader_mesh,"normal", vbo_V_normals, V_normals_vbo, dirty & MeshGL::DIRTY_NORMAL);
-  bind_vertex_attrib_array(shader_mesh,"Ka", vbo_V_ambient, V_ambient_vbo, dirty & MeshGL::DIRTY_AMBIENT);
-  bind_vertex_attrib_array(shader_mesh,"Kd", vbo_V_diffuse, V_diffuse_vbo, dirty & MeshGL::DIRTY_DIFFUSE);
-  bind_vertex_attrib_array(shader_mesh,"Ks", vbo_V_specular, V_specular_vbo, dirty & MeshGL::DIRTY_SPECULAR);
-  bind_vertex_attrib_array(shader_mesh,"texcoord", vbo_V_uv, V_uv_vbo, dirty & MeshGL::DIRTY_UV);
+  if (compact_vertex_format)
+  {
+    glUseProgram(shader_mesh_compact);
+    bind_vertex_attrib_array(shader_mesh_compact,"position", vbo_V, V_vbo_compact, GL_UNSIGNED_SHORT, GL_TRUE, dirty & MeshGL::DIRTY_POSITION);
+    bind_vertex_attrib_array(shader_mesh_compact,"normal", vbo_V_normals, V_normals_vbo_compact, GL_SHORT, GL_TRUE, dirty & MeshGL::DIRTY_NORMAL);
+    bind_vertex_attrib_array(shader_mesh_compact,"Ka", vbo_V_ambient, V_ambient_vbo_compact, GL_UNSIGNED_BYTE, GL_TRUE, dirty & MeshGL::DIRTY_AMBIENT);
+    bind_vertex_attrib_array(shader_mesh_compact,"Kd", vbo_V_diffuse, V_diffuse_vbo_compact, GL_UNSIGNED_BYTE, GL_TRUE, dirty & MeshGL::DIRTY_DIFFUSE);
+    bind_vertex_attrib_array(shader_mesh_compact,"Ks", vbo_V_specular, V_specular_vbo_compact, GL_UNSIGNED_BYTE, GL_TRUE, dirty & MeshGL::DIRTY_SPECULAR);
+    bind_vertex_attrib_array(shader_mesh_compact,"texcoord", vbo_V_uv, V_uv_vbo_compact, GL_HALF_FLOAT, GL_FALSE, dirty & MeshGL::DIRTY_UV);
+    glUniform3fv(glGetUniformLocation(shader_mesh_compact,"position_min"), 1, V_vbo_min.data());
+    glUniform3fv(glGetUniformLocation(shader_mesh_compact,"position_extent"), 1, V_vbo_extent.data());
+  }
+  else
+  {
+    glUseProgram(shader_mesh);
+    bind_vertex_attrib_array(shader_mesh,"position", vbo_V, V_vbo, dirty & MeshGL::DIRTY_POSITION);
+    bind_vertex_attrib_array(shader_mesh,"normal", vbo_V_normals, V_normals_vbo, dirty & MeshGL::DIRTY_NORMAL);
+    bind_vertex_attrib_array(shader_mesh,"Ka", vbo_V_ambient, V_ambient_vbo, dirty & MeshGL::DIRTY_AMBIENT);
+    bind_vertex_attrib_array(shader_mesh,"Kd", vbo_V_diffuse, V_diffuse_vbo, dirty & MeshGL::DIRTY_DIFFUSE);
+    bind_vertex_attrib_array(shader_mesh,"Ks", vbo_V_specular, V_specular_vbo, dirty & MeshGL::DIRTY_SPECULAR);
+    bind_vertex_attrib_array(shader_mesh,"texcoord", vbo_V_uv, V_uv_vbo, dirty & MeshGL::DIRTY_UV);
+  }
+
+
+  // Per-instance attributes advance once per instance (attribute divisor).
+  // Without instances the arrays are disabled and the constant attribute
+  // values (identity transformation, white) are used instead.
+  {
+    const GLuint shader = active_shader_mesh();
+    const bool is_dirty = dirty & MeshGL::DIRTY_INSTANCES;
+    const GLint transformi = glGetAttribLocation(shader, "instance_transform");
+    const GLint colori = glGetAttribLocation(shader, "instance_color");
+    if (transformi >= 0)
+    {
+      glBindBuffer(GL_ARRAY_BUFFER, vbo_instance_transforms);
+      if (is_dirty)
+        glBufferData(GL_ARRAY_BUFFER, sizeof(float)*instance_transforms_vbo.size(), instance_transforms_vbo.data(), GL_DYNAMIC_DRAW);
+      for (int j = 0; j < 4; ++j)
+      {
+        if (instance_transforms_vbo.rows() > 0)
+        {
+          glVertexAttribPointer(transformi + j, 3, GL_FLOAT, GL_FALSE, 12 * sizeof(float), (const void *)(3 * j * sizeof(float)));
+          glVertexAttribDivisor(transformi + j, 1);
+          glEnableVertexAttribArray(transformi + j);
+        }
+        else
+        {
+          glDisableVertexAttribArray(transformi + j);
+          glVertexAttrib3f(transformi + j, j == 0, j == 1, j == 2);
+        }
+      }
+    }
+    if (colori >= 0)
+    {
+      glBindBuffer(GL_ARRAY_BUFFER, vbo_instance_colors);
+      if (is_dirty)
+        glBufferData(GL_ARRAY_BUFFER, sizeof(float)*instance_colors_vbo.size(), instance_colors_vbo.data(), GL_DYNAMIC_DRAW);
+      if (instance_colors_vbo.rows() > 0)
+      {
+        glVertexAttribPointer(colori, 4, GL_FLOAT, GL_FALSE, 0, 0);
+        glVertexAttribDivisor(colori, 1);
+        glEnableVertexAttribArray(colori);
+      }
+      else
+      {
+        glDisableVertexAttribArray(colori);
+        glVertexAttrib4f(colori, 1, 1, 1, 1);
+      }
+    }
+    dirty &= ~MeshGL::DIRTY_INSTANCES;
+  }
 
   glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, vbo_F);
   if (dirty & MeshGL::DIRTY_FACE)
@@ -133,41 +290,91 @@ IGL_INLINE void igl::opengl::MeshGL::bind_mesh()
     glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
     glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, tex_u, tex_v, 0, GL_RGBA, GL_UNSIGNED_BYTE, tex.data());
   }
-  glUniform1i(glGetUniformLocation(shader_mesh,"tex"), 0);
+  glUniform1i(glGetUniformLocation(active_shader_mesh(),"tex"), 0);
   dirty &= ~MeshGL::DIRTY_MESH;
+  clusters_culled = false;
 }
 
-IGL_INLINE void igl::opengl::MeshGL::bind_overlay_lines()
+IGL_INLINE void igl::opengl::MeshGL::OverlayBuffer::clear()
+{
+  rows = 0;
+  uploaded = 0;
+}
+
+IGL_INLINE void igl::opengl::MeshGL::OverlayBuffer::append(const Eigen::Ref<const Eigen::Matrix<double,Eigen::Dynamic,Eigen::Dynamic,Eigen::RowMajor> > & X)
 {
-  bool is_dirty = dirty & MeshGL::DIRTY_OVERLAY_LINES;
+  const int n = X.rows();
+  if (n <= 0)
+    return;
+  if (data.cols() != X.cols())
+  {
+    data.resize(0, X.cols());
+    rows = uploaded = gpu_capacity = 0;
+  }
+  if (rows + n > data.rows())
+    data.conservativeResize(std::max(rows + n, 2 * (int)data.rows()), X.cols());
+  data.middleRows(rows, n) = X.cast<float>();
+  rows += n;
+}
 
-  glBindVertexArray(vao_overlay_lines);
-  glUseProgram(shader_overlay_lines);
- bind_vertex_attrib_array(shader_overlay_lines,"position", vbo_lines_V, lines_V_vbo, is_dirty);
- bind_vertex_attrib_array(shader_overlay_lines,"color", vbo_lines_V_colors, lines_V_colors_vbo, is_dirty);
+IGL_INLINE void igl::opengl::MeshGL::OverlayBuffer::bind()
+{
+  glBindBuffer(GL_ARRAY_BUFFER, vbo);
+  if (rows > gpu_capacity)
+  {
+    // Reallocate with the whole CPU capacity so that the next appends fit
+    gpu_capacity = data.rows();
+    glBufferData(GL_ARRAY_BUFFER, sizeof(float)*data.size(), data.data(), GL_DYNAMIC_DRAW);
+    uploaded = rows;
+  }
+  else if (rows > uploaded)
+  {
+    glBufferSubData(GL_ARRAY_BUFFER, sizeof(float)*uploaded*data.cols(), sizeof(float)*(rows - uploaded)*data.cols(), data.row(uploaded).data());
+    uploaded = rows;
+  }
+}
 
-  glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, vbo_lines_F);
-  if (is_dirty)
-    glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(unsigned)*lines_F_vbo.size(), lines_F_vbo.data(), GL_DYNAMIC_DRAW);
+IGL_INLINE void igl::opengl::MeshGL::bind_overlay_lines()
+{
+  glBindVertexArray(vao_overlay_lines);
+  glUseProgram(shader_overlay_thick_lines);
+  lines_buffer.bind();
+
+  // One instance per line: both endpoints and the color are fetched per
+  // instance, the quad corners are generated from gl_VertexID
+  const GLsizei stride = sizeof(float)*lines_buffer.data.cols();
+  const char * names[3] = { "start", "end", "color" };
+  for (int i = 0; i < 3; ++i)
+  {
+    GLint id = glGetAttribLocation(shader_overlay_thick_lines, names[i]);
+    if (id < 0)
+      continue;
+    glVertexAttribPointer(id, 3, GL_FLOAT, GL_FALSE, stride, reinterpret_cast<const void*>(sizeof(float)*3*i));
+    glEnableVertexAttribArray(id);
+    glVertexAttribDivisor(id, 1);
+  }
 
-  dirty &= ~MeshGL::DIRTY_OVERLAY_LINES;
+  dirty &= ~(MeshGL::DIRTY_OVERLAY_LINES | MeshGL::DIRTY_OVERLAY_LINES_APPEND);
 }
 
 IGL_INLINE void igl::opengl::MeshGL::bind_overlay_points()
 {
-  bool is_dirty = dirty & MeshGL::DIRTY_OVERLAY_POINTS;
-
   glBindVertexArray(vao_overlay_points);
   glUseProgram(shader_overlay_points);
+  points_buffer.bind();
 
- bind_vertex_attrib_array(shader_overlay_points,"position", vbo_points_V, points_V_vbo, is_dirty);
- bind_vertex_attrib_array(shader_overlay_points,"color", vbo_points_V_colors, points_V_colors_vbo, is_dirty);
-
-  glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, vbo_points_F);
-  if (is_dirty)
-    glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(unsigned)*points_F_vbo.size(), points_F_vbo.data(), GL_DYNAMIC_DRAW);
+  const GLsizei stride = sizeof(float)*points_buffer.data.cols();
+  const char * names[2] = { "position", "color" };
+  for (int i = 0; i < 2; ++i)
+  {
+    GLint id = glGetAttribLocation(shader_overlay_points, names[i]);
+    if (id < 0)
+      continue;
+    glVertexAttribPointer(id, 3, GL_FLOAT, GL_FALSE, stride, reinterpret_cast<const void*>(sizeof(float)*3*i));
+    glEnableVertexAttribArray(id);
+  }
 
-  dirty &= ~MeshGL::DIRTY_OVERLAY_POINTS;
+  dirty &= ~(MeshGL::DIRTY_OVERLAY_POINTS | MeshGL::DIRTY_OVERLAY_POINTS_APPEND);
 }
 
 IGL_INLINE void igl::opengl::MeshGL::bind_laser() {
@@ -188,20 +395,21 @@ IGL_INLINE void igl::opengl::MeshGL::bind_laser() {
 }
 
 IGL_INLINE void igl::opengl::MeshGL::bind_overlay_linestrip() {
-	bool is_dirty = dirty & MeshGL::DIRTY_OVERLAY_STRIP;
-
 	glBindVertexArray(vao_overlay_strip);
 	glUseProgram(shader_overlay_lines);
-
-	bind_vertex_attrib_array(shader_overlay_lines, "position", vbo_overlay_strip_V, overlay_strip_V_vbo, is_dirty);
-	bind_vertex_attrib_array(shader_overlay_lines, "color", vbo_overlay_strip_V_colors, overlay_strip_V_colors_vbo, is_dirty);
-
-	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, vbo_overlay_strip_F);
-	if (is_dirty) {
-		glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(unsigned)*overlay_strip_F_vbo.size(), overlay_strip_F_vbo.data(), GL_DYNAMIC_DRAW);
+	overlay_strip_buffer.bind();
+
+	const GLsizei stride = sizeof(float)*overlay_strip_buffer.data.cols();
+	const char * names[2] = { "position", "color" };
+	for (int i = 0; i < 2; ++i) {
+		GLint id = glGetAttribLocation(shader_overlay_lines, names[i]);
+		if (id < 0)
+			continue;
+		glVertexAttribPointer(id, 3, GL_FLOAT, GL_FALSE, stride, reinterpret_cast<const void*>(sizeof(float)*3*i));
+		glEnableVertexAttribArray(id);
 	}
 
-	dirty &= ~MeshGL::DIRTY_OVERLAY_STRIP;
+	dirty &= ~(MeshGL::DIRTY_OVERLAY_STRIP | MeshGL::DIRTY_OVERLAY_STRIP_APPEND);
 }
 
 IGL_INLINE void igl::opengl::MeshGL::bind_hand_point()
@@ -236,20 +444,88 @@ IGL_INLINE void igl::opengl::MeshGL::draw_mesh(bool solid)
 	  glEnable(GL_POLYGON_OFFSET_LINE);
 	  glPolygonOffset(0.5, 0.5); //Pushes the wireframe back as well, but slightly less than the filled triangles. Used to avoid z-buffer fighting with overlay lines (stroke) that are placed on top of the wireframes
   }
-  glDrawElements(GL_TRIANGLES, 3*F_vbo.rows(), GL_UNSIGNED_INT, 0);
+  if (instance_transforms_vbo.rows() > 0)
+    glDrawElementsInstanced(GL_TRIANGLES, 3*F_vbo.rows(), GL_UNSIGNED_INT, 0, instance_transforms_vbo.rows());
+  else if (clusters_culled)
+  {
+    if (!cluster_draw_count.empty())
+      glMultiDrawElements(GL_TRIANGLES, cluster_draw_count.data(), GL_UNSIGNED_INT, cluster_draw_first.data(), cluster_draw_count.size());
+  }
+  else
+    glDrawElements(GL_TRIANGLES, 3*F_vbo.rows(), GL_UNSIGNED_INT, 0);
 
   glDisable(GL_POLYGON_OFFSET_FILL);
   glPolygonMode(GL_FRONT_AND_BACK, GL_FILL);
 }
 
+IGL_INLINE void igl::opengl::MeshGL::cull_clusters(
+  const Eigen::Matrix4f & model,
+  const Eigen::Matrix4f & view,
+  const Eigen::Matrix4f & proj,
+  const bool backface)
+{
+  cluster_draw_count.clear();
+  cluster_draw_first.clear();
+  const int nc = cluster_offsets.size() - 1;
+  if (nc <= 0)
+  {
+    clusters_culled = false;
+    return;
+  }
+
+  // Frustum planes in model coordinates (Gribb & Hartmann), normalized so that
+  // they measure distances in model units
+  const Eigen::Matrix4f clip = proj * view * model;
+  Eigen::Matrix<float, 6, 4> planes;
+  for (int i = 0; i < 3; ++i)
+  {
+    planes.row(2 * i + 0) = clip.row(3) + clip.row(i);
+    planes.row(2 * i + 1) = clip.row(3) - clip.row(i);
+  }
+  for (int p = 0; p < 6; ++p)
+    planes.row(p) /= planes.row(p).head<3>().norm();
+  // Eye position in model coordinates
+  const Eigen::Vector3f eye = (view * model).inverse().col(3).head<3>();
+
+  int last_end = -1;
+  for (int c = 0; c < nc; ++c)
+  {
+    const Eigen::Vector3f center = cluster_spheres.row(c).head<3>().transpose();
+    const float radius = cluster_spheres(c, 3);
+    bool visible = true;
+    for (int p = 0; p < 6 && visible; ++p)
+      visible = planes.row(p).head<3>().dot(center) + planes(p, 3) >= -radius;
+    if (visible && backface)
+    {
+      const Eigen::Vector3f d = center - eye;
+      const Eigen::Vector3f axis = cluster_cones.row(c).head<3>().transpose();
+      visible = d.dot(axis) < cluster_cones(c, 3) * d.norm() + radius;
+    }
+    if (!visible)
+      continue;
+    const int first = 3 * cluster_offsets(c);
+    const int count = 3 * (cluster_offsets(c + 1) - cluster_offsets(c));
+    // Merge with the previous range if contiguous
+    if (first == last_end)
+      cluster_draw_count.back() += count;
+    else
+    {
+      cluster_draw_count.push_back(count);
+      cluster_draw_first.push_back(reinterpret_cast<const void *>(sizeof(unsigned) * first));
+    }
+    last_end = first + count;
+  }
+  clusters_culled = true;
+}
+
 IGL_INLINE void igl::opengl::MeshGL::draw_overlay_lines()
 {
-  glDrawElements(GL_LINES, lines_F_vbo.rows(), GL_UNSIGNED_INT, 0);
+  glDrawArraysInstanced(GL_TRIANGLE_STRIP, 0, 4, lines_buffer.rows);
 }
 
 IGL_INLINE void igl::opengl::MeshGL::draw_overlay_points()
 {
-  glDrawElements(GL_POINTS, points_F_vbo.rows(), GL_UNSIGNED_INT, 0);
+  glDrawArrays(GL_POINTS, 0, points_buffer.rows);
 }
 
 IGL_INLINE void igl::opengl::MeshGL::draw_laser()
@@ -258,7 +534,7 @@ IGL_INLINE void igl::opengl::MeshGL::draw_laser()
 }
 
 IGL_INLINE void igl::opengl::MeshGL::draw_overlay_linestrip() {
-	glDrawElements(GL_LINE_STRIP, overlay_strip_F_vbo.rows(), GL_UNSIGNED_INT, 0);
+	glDrawArrays(GL_LINE_STRIP, 0, overlay_strip_buffer.rows);
 }
 
 IGL_INLINE void igl::opengl::MeshGL::draw_hand_point()
@@ -291,15 +567,63 @@ R"(#version 150
   out vec4 Kai;
   out vec4 Kdi;
   out vec4 Ksi;
+  in mat4x3 instance_transform;
+  in vec4 instance_color;
 
   void main()
   {
-    position_eye = vec3 (view * model * vec4 (position, 1.0));
-    normal_eye = vec3 (view * model * vec4 (normal, 0.0));
+    position_eye = vec3 (view * model * vec4 (instance_transform * vec4 (position, 1.0), 1.0));
+    normal_eye = vec3 (view * model * vec4 (instance_transform * vec4 (normal, 0.0), 0.0));
     normal_eye = normalize(normal_eye);
     gl_Position = proj * vec4 (position_eye, 1.0); //proj * view * model * vec4(position, 1.0);
-    Kai = Ka;
-    Kdi = Kd;
+    Kai = Ka * instance_color;
+    Kdi = Kd * instance_color;
+    Ksi = Ks;
+    texcoordi = texcoord;
+  }
+)";
+
+  // Same as above, decoding the compact vertex format
+  std::string mesh_compact_vertex_shader_string =
+R"(#version 150
+  uniform mat4 model;
+  uniform mat4 view;
+  uniform mat4 proj;
+  uniform vec3 position_min;
+  uniform vec3 position_extent;
+  in vec4 position;
+  in vec2 normal;
+  out vec3 position_eye;
+  out vec3 normal_eye;
+  in vec4 Ka;
+  in vec4 Kd;
+  in vec4 Ks;
+  in vec2 texcoord;
+  out vec2 texcoordi;
+  out vec4 Kai;
+  out vec4 Kdi;
+  out vec4 Ksi;
+  in mat4x3 instance_transform;
+  in vec4 instance_color;
+
+  vec3 octahedron_decode(vec2 e)
+  {
+    vec3 n = vec3(e, 1.0 - abs(e.x) - abs(e.y));
+    float t = max(-n.z, 0.0);
+    n.x += n.x >= 0.0 ? -t : t;
+    n.y += n.y >= 0.0 ? -t : t;
+    return normalize(n);
+  }
+
+  void main()
+  {
+    vec3 p = position_min + position.xyz * position_extent;
+    position_eye = vec3 (view * model * vec4 (instance_transform * vec4 (p, 1.0), 1.0));
+    normal_eye = vec3 (view * model * vec4 (instance_transform * vec4 (octahedron_decode(normal), 0.0), 0.0));
+    normal_eye = normalize(normal_eye);
+    gl_Position = proj * vec4 (position_eye, 1.0);
+    Kai = Ka * instance_color;
+    Kdi = Kd * instance_color;
     Ksi = Ks;
     texcoordi = texcoord;
   }
@@ -365,6 +689,34 @@ R"(#version 150
   }
 )";
 
+  // Expands each line into a quad of line_width pixels in screen space
+  std::string overlay_thick_lines_vertex_shader_string =
+R"(#version 150
+  uniform mat4 model;
+  uniform mat4 view;
+  uniform mat4 proj;
+  uniform vec2 viewport_size;
+  uniform float line_width;
+  in vec3 start;
+  in vec3 end;
+  in vec3 color;
+  out vec3 color_frag;
+
+  void main()
+  {
+    vec4 a = proj * view * model * vec4 (start, 1.0);
+    vec4 b = proj * view * model * vec4 (end, 1.0);
+    vec2 d = (b.xy / max(abs(b.w), 1e-6) - a.xy / max(abs(a.w), 1e-6)) * viewport_size;
+    float len = length(d);
+    vec2 n = len > 0.0 ? vec2(-d.y, d.x) / len : vec2(0.0, 1.0);
+    vec4 p = gl_VertexID < 2 ? a : b;
+    float side = (gl_VertexID % 2) == 0 ? -1.0 : 1.0;
+    p.xy += side * line_width * n / viewport_size * p.w;
+    gl_Position = p;
+    color_frag = color;
+  }
+)";
+
   std::string overlay_fragment_shader_string =
 R"(#version 150
   in vec3 color_frag;
@@ -393,11 +745,21 @@ R"(#version 150
     mesh_fragment_shader_string,
     {},
     shader_mesh);
+  create_shader_program(
+    mesh_compact_vertex_shader_string,
+    mesh_fragment_shader_string,
+    {},
+    shader_mesh_compact);
   create_shader_program(
     overlay_vertex_shader_string,
     overlay_fragment_shader_string,
     {},
     shader_overlay_lines);
+  create_shader_program(
+    overlay_thick_lines_vertex_shader_string,
+    overlay_fragment_shader_string,
+    {},
+    shader_overlay_thick_lines);
   create_shader_program(
     overlay_vertex_shader_string,
     overlay_point_fragment_shader_string,
@@ -420,7 +782,9 @@ IGL_INLINE void igl::opengl::MeshGL::free()
   if (is_initialized)
   {
     free(shader_mesh);
+    free(shader_mesh_compact);
     free(shader_overlay_lines);
+    free(shader_overlay_thick_lines);
     free(shader_overlay_points);
     free_buffers();
   }
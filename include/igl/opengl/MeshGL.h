@@ -14,6 +14,7 @@
 
 #include <igl/igl_inline.h>
 #include <Eigen/Core>
+#include <vector>
 
 namespace igl
 {
@@ -42,9 +43,13 @@ public:
 	DIRTY_LASER			 = 0x0400,
 	DIRTY_HAND_POINT	 = 0x0800,
 	DIRTY_OVERLAY_STRIP  = 0x1000,
-	//DIRTY_VOLUMETRIC_LINES = 0x2000,
-	DIRTY_ALL			 = 0x1FFF,
-	//DIRTY_ALL			 = 0x3FFF
+	DIRTY_INSTANCES      = 0x2000,
+	DIRTY_ALL			 = 0x3FFF,
+	// Rows were only appended to the overlay since the last update (implied by
+	// the corresponding full flag above)
+	DIRTY_OVERLAY_LINES_APPEND  = 0x4000,
+	DIRTY_OVERLAY_POINTS_APPEND = 0x8000,
+	DIRTY_OVERLAY_STRIP_APPEND  = 0x10000
   };
 
   bool is_initialized = false;
@@ -56,7 +61,9 @@ public:
   GLuint vao_hand_point;
 
   GLuint shader_mesh;
+  GLuint shader_mesh_compact; // Decodes the compact vertex format
   GLuint shader_overlay_lines;
+  GLuint shader_overlay_thick_lines; // Line segments as instanced screen-space quads
   GLuint shader_overlay_points;
 
   GLuint vbo_V; // Vertices of the current mesh (#V x 3)
@@ -67,21 +74,13 @@ public:
   GLuint vbo_V_specular; // Specular material  (#V x 3)
 
   GLuint vbo_F; // Faces of the mesh (#F x 3)
+  GLuint vbo_instance_transforms; // Per-instance affine transformations (#I x 12)
+  GLuint vbo_instance_colors; // Per-instance colors (#I x 4)
   GLuint vbo_tex; // Texture
 
-  GLuint vbo_lines_F;         // Indices of the line overlay
-  GLuint vbo_lines_V;         // Vertices of the line overlay
-  GLuint vbo_lines_V_colors;  // Color values of the line overlay
-  GLuint vbo_lines_V_normals;
-  GLuint vbo_points_F;        // Indices of the point overlay
-  GLuint vbo_points_V;        // Vertices of the point overlay
-  GLuint vbo_points_V_colors; // Color values of the point overlay
   GLuint vbo_laser_points_F;	  // Indices of the laser overlay
   GLuint vbo_laser_points_V;	  // Vertices of the laser overlay
   GLuint vbo_laser_V_colors;
-  GLuint vbo_overlay_strip_F; //Indices of the linestrip overlay
-  GLuint vbo_overlay_strip_V; //Vertices of the linestrip overlay
-  GLuint vbo_overlay_strip_V_colors;
   GLuint vbo_hand_point_F;
   GLuint vbo_hand_point_V;
   GLuint vbo_hand_point_V_colors;
@@ -96,30 +95,73 @@ public:
   RowMatrixXf V_diffuse_vbo;
   RowMatrixXf V_specular_vbo;
   RowMatrixXf V_uv_vbo;
-  RowMatrixXf lines_V_vbo;
-  RowMatrixXf lines_V_colors_vbo;
-  RowMatrixXf lines_V_normals_vbo;
-  RowMatrixXf points_V_vbo;
-  RowMatrixXf points_V_colors_vbo;
+  RowMatrixXf instance_transforms_vbo; // columns of the 3x4 affine matrices
+  RowMatrixXf instance_colors_vbo;
 
   RowMatrixXf laser_points_V_vbo;
   RowMatrixXf laser_V_colors_vbo;
-  RowMatrixXf overlay_strip_V_vbo;
-  RowMatrixXf overlay_strip_V_colors_vbo;
   RowMatrixXf hand_point_V_vbo;
   RowMatrixXf hand_point_V_colors_vbo;
 
+  // Compact vertex format (enabled with compact_vertex_format): positions are
+  // quantized to 16 bits relative to their bounding box, normals are
+  // octahedron-encoded in 2x16 bits, colors are RGBA8 and UVs half floats.
+  // When enabled, the corresponding float buffers above are left empty.
+  typedef Eigen::Matrix<unsigned short,Eigen::Dynamic,Eigen::Dynamic,Eigen::RowMajor> RowMatrixXus;
+  typedef Eigen::Matrix<short,Eigen::Dynamic,Eigen::Dynamic,Eigen::RowMajor> RowMatrixXs;
+  typedef Eigen::Matrix<unsigned char,Eigen::Dynamic,Eigen::Dynamic,Eigen::RowMajor> RowMatrixXuc;
+  bool compact_vertex_format = false;
+  RowMatrixXus V_vbo_compact;          // #V by 4 (w unused, for alignment)
+  Eigen::RowVector3f V_vbo_min;        // Dequantization: min + q * extent
+  Eigen::RowVector3f V_vbo_extent;
+  RowMatrixXs V_normals_vbo_compact;   // #V by 2
+  RowMatrixXuc V_ambient_vbo_compact;  // #V by 4
+  RowMatrixXuc V_diffuse_vbo_compact;  // #V by 4
+  RowMatrixXuc V_specular_vbo_compact; // #V by 4
+  RowMatrixXus V_uv_vbo_compact;       // #V by 2
+
+  // Interleaved vertex buffer of an overlay (one row per point, line or strip
+  // vertex). The CPU copy grows geometrically and only the rows appended since
+  // the last upload are sent to the GPU, so streaming many small additions
+  // per frame stays cheap.
+  struct OverlayBuffer
+  {
+    GLuint vbo = 0;
+    RowMatrixXf data;     // capacity by #columns, only the first rows are used
+    int rows = 0;         // Number of rows in use
+    int uploaded = 0;     // Number of rows already on the GPU
+    int gpu_capacity = 0; // Number of rows allocated on the GPU
+
+    // Remove all rows
+    IGL_INLINE void clear();
+    // Append the rows of X, converted to float
+    IGL_INLINE void append(const Eigen::Ref<const Eigen::Matrix<double,Eigen::Dynamic,Eigen::Dynamic,Eigen::RowMajor> > & X);
+    // Bind the buffer to GL_ARRAY_BUFFER, uploading the appended rows
+    IGL_INLINE void bind();
+  };
+  OverlayBuffer lines_buffer;         // #lines by 9 (start, end, color)
+  OverlayBuffer points_buffer;        // #points by 6 (position, color)
+  OverlayBuffer overlay_strip_buffer; // #vertices by 6 (position, color)
+
   int tex_u;
   int tex_v;
   Eigen::Matrix<char,Eigen::Dynamic,1> tex;
 
   Eigen::Matrix<unsigned, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor> F_vbo;
-  Eigen::Matrix<unsigned, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor> lines_F_vbo;
-  Eigen::Matrix<unsigned, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor> points_F_vbo;
   Eigen::Matrix<unsigned, Eigen::Dynamic, Eigen::Dynamic> laser_points_F_vbo;
-  Eigen::Matrix<unsigned, Eigen::Dynamic, Eigen::Dynamic> overlay_strip_F_vbo;
   Eigen::Matrix<unsigned, Eigen::Dynamic, Eigen::Dynamic> hand_point_F_vbo;
 
+  // Cluster-based culling (see igl::meshlets). If cluster_offsets is non-empty
+  // the rows of F_vbo are stored contiguously per cluster: cluster c spans rows
+  // cluster_offsets(c),...,cluster_offsets(c+1)-1 of F_vbo
+  Eigen::VectorXi cluster_faces;   // #F permutation of the faces of the mesh
+  Eigen::VectorXi cluster_offsets; // #C+1 offsets into F_vbo
+  RowMatrixXf cluster_spheres;     // #C by 4 bounding spheres (center, radius)
+  RowMatrixXf cluster_cones;       // #C by 4 normal cones (axis, cutoff)
+  // Face ranges of F_vbo that survived the last call to cull_clusters
+  bool clusters_culled = false;
+  std::vector<int> cluster_draw_count;
+  std::vector<const void *> cluster_draw_first;
 
   // Marks dirty buffers that need to be uploaded to OpenGL
   uint32_t dirty;
@@ -133,16 +175,40 @@ public:
   // Create a new set of OpenGL buffer objects
   IGL_INLINE void init_buffers();
 
+  // Convert the dirty per-vertex float buffers of the mesh to the compact
+  // vertex format (releasing the float copies)
+  IGL_INLINE void compact_vertex_buffers();
+
+  // Shader program used to draw the mesh, depending on the vertex format
+  IGL_INLINE GLuint active_shader_mesh() const;
+
   // Bind the underlying OpenGL buffer objects for subsequent mesh draw calls
   IGL_INLINE void bind_mesh();
 
-  /// Draw the currently buffered mesh (either solid or wireframe)
+  /// Draw the currently buffered mesh (either solid or wireframe). If the
+  /// clusters have been culled since the last bind_mesh, only the visible
+  /// clusters are drawn (using a single multi-draw call). If instances are
+  /// buffered, all of them are drawn with a single instanced draw call
   IGL_INLINE void draw_mesh(bool solid);
 
+  // Determine which clusters of the mesh are visible, i.e., intersect the
+  // view frustum and (optionally) are not entirely back-facing
+  //
+  // Inputs:
+  //   model  4 by 4 model matrix
+  //   view  4 by 4 view matrix
+  //   proj  4 by 4 projection matrix
+  //   backface  whether to also cull back-facing clusters
+  IGL_INLINE void cull_clusters(
+    const Eigen::Matrix4f & model,
+    const Eigen::Matrix4f & view,
+    const Eigen::Matrix4f & proj,
+    const bool backface);
+
   // Bind the underlying OpenGL buffer objects for subsequent line overlay draw calls
   IGL_INLINE void bind_overlay_lines();
 
-  /// Draw the currently buffered line overlay
+  /// Draw the currently buffered line overlay (one instanced quad per line)
   IGL_INLINE void draw_overlay_lines();
 
   // Bind the underlying OpenGL buffer objects for subsequent point overlay draw calls
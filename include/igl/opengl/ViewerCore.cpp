@@ -189,19 +189,19 @@ IGL_INLINE void igl::opengl::ViewerCore::draw(
 
 
 	// Send transformations to the GPU
-	GLint modeli = glGetUniformLocation(data.meshgl.shader_mesh, "model");
-	GLint viewi = glGetUniformLocation(data.meshgl.shader_mesh, "view");
-	GLint proji = glGetUniformLocation(data.meshgl.shader_mesh, "proj");
+	GLint modeli = glGetUniformLocation(data.meshgl.active_shader_mesh(), "model");
+	GLint viewi = glGetUniformLocation(data.meshgl.active_shader_mesh(), "view");
+	GLint proji = glGetUniformLocation(data.meshgl.active_shader_mesh(), "proj");
 	glUniformMatrix4fv(modeli, 1, GL_FALSE, model.data());
 	glUniformMatrix4fv(viewi, 1, GL_FALSE, view.data());
 	glUniformMatrix4fv(proji, 1, GL_FALSE, proj.data());
 
 	// Light parameters
-	GLint specular_exponenti = glGetUniformLocation(data.meshgl.shader_mesh, "specular_exponent");
-	GLint light_position_worldi = glGetUniformLocation(data.meshgl.shader_mesh, "light_position_world");
-	GLint lighting_factori = glGetUniformLocation(data.meshgl.shader_mesh, "lighting_factor");
-	GLint fixed_colori = glGetUniformLocation(data.meshgl.shader_mesh, "fixed_color");
-	GLint texture_factori = glGetUniformLocation(data.meshgl.shader_mesh, "texture_factor");
+	GLint specular_exponenti = glGetUniformLocation(data.meshgl.active_shader_mesh(), "specular_exponent");
+	GLint light_position_worldi = glGetUniformLocation(data.meshgl.active_shader_mesh(), "light_position_world");
+	GLint lighting_factori = glGetUniformLocation(data.meshgl.active_shader_mesh(), "lighting_factor");
+	GLint fixed_colori = glGetUniformLocation(data.meshgl.active_shader_mesh(), "fixed_color");
+	GLint texture_factori = glGetUniformLocation(data.meshgl.active_shader_mesh(), "texture_factor");
 
 	glUniform1f(specular_exponenti, data.shininess);
 	Eigen::Vector3f rev_light = -1.*light_position;
@@ -211,6 +211,10 @@ IGL_INLINE void igl::opengl::ViewerCore::draw(
 
 	if (data.V.rows() > 0)
 	{
+		// Skip the clusters outside of the view frustum or facing away
+		if (data.cluster_culling && data.instance_transforms.rows() == 0)
+			data.meshgl.cull_clusters(model, view, proj, data.cluster_backface_culling && !data.invert_normals);
+
 		// Render fill
 		if (data.show_faces)
 		{
@@ -240,24 +244,27 @@ IGL_INLINE void igl::opengl::ViewerCore::draw(
 		else
 			glDisable(GL_DEPTH_TEST);
 
-		if (data.lines.rows() > 0)
+		if (data.meshgl.lines_buffer.rows > 0)
 		{
 			data.meshgl.bind_overlay_lines();
-			modeli = glGetUniformLocation(data.meshgl.shader_overlay_lines, "model");
-			viewi = glGetUniformLocation(data.meshgl.shader_overlay_lines, "view");
-			proji = glGetUniformLocation(data.meshgl.shader_overlay_lines, "proj");
+			modeli = glGetUniformLocation(data.meshgl.shader_overlay_thick_lines, "model");
+			viewi = glGetUniformLocation(data.meshgl.shader_overlay_thick_lines, "view");
+			proji = glGetUniformLocation(data.meshgl.shader_overlay_thick_lines, "proj");
+			GLint viewport_sizei = glGetUniformLocation(data.meshgl.shader_overlay_thick_lines, "viewport_size");
+			GLint line_widthi = glGetUniformLocation(data.meshgl.shader_overlay_thick_lines, "line_width");
 
 			glUniformMatrix4fv(modeli, 1, GL_FALSE, model.data());
 			glUniformMatrix4fv(viewi, 1, GL_FALSE, view.data());
 			glUniformMatrix4fv(proji, 1, GL_FALSE, proj.data());
-			// This must be enabled, otherwise glLineWidth has no effect
-			glEnable(GL_LINE_SMOOTH);
-			glLineWidth(data.overlay_line_width);
+			// Lines are expanded to quads in the shader: glLineWidth is not
+			// needed (and is capped at 1 in core profiles)
+			glUniform2f(viewport_sizei, viewport(2), viewport(3));
+			glUniform1f(line_widthi, data.overlay_line_width);
 
 			data.meshgl.draw_overlay_lines();
 		}
 
-		if (data.points.rows() > 0){
+		if (data.meshgl.points_buffer.rows > 0){
 			data.meshgl.bind_overlay_points();
 			modeli = glGetUniformLocation(data.meshgl.shader_overlay_points, "model");
 			viewi = glGetUniformLocation(data.meshgl.shader_overlay_points, "view");
@@ -286,11 +293,11 @@ IGL_INLINE void igl::opengl::ViewerCore::draw(
 			data.meshgl.draw_hand_point();
 		}
 
-		if (data.linestrip.rows() > 0) {
+		if (data.meshgl.overlay_strip_buffer.rows > 0) {
 			data.meshgl.bind_overlay_linestrip();
-			modeli = glGetUniformLocation(data.meshgl.shader_overlay_points, "model");
-			viewi = glGetUniformLocation(data.meshgl.shader_overlay_points, "view");
-			proji = glGetUniformLocation(data.meshgl.shader_overlay_points, "proj");
+			modeli = glGetUniformLocation(data.meshgl.shader_overlay_lines, "model");
+			viewi = glGetUniformLocation(data.meshgl.shader_overlay_lines, "view");
+			proji = glGetUniformLocation(data.meshgl.shader_overlay_lines, "proj");
 
 			glUniformMatrix4fv(modeli, 1, GL_FALSE, model.data());
 			glUniformMatrix4fv(viewi, 1, GL_FALSE, view.data());
@@ -8,17 +8,25 @@
 
 #include "ViewerData.h"
 
-#include "../per_face_normals.h"
 #include "../material_colors.h"
 #include "../parula.h"
-#include "../per_vertex_normals.h"
 #include "../quat_to_mat.h"
+#include "../meshlets.h"
+#include "../meshlet_bounds.h"
+#include "../optimize_vertex_cache.h"
+#include "../parallel_for.h"
 
 #include <iostream>
+#include <vector>
 
 
 IGL_INLINE igl::opengl::ViewerData::ViewerData()
 	: dirty(MeshGL::DIRTY_ALL),
+	cluster_culling(false),
+	cluster_backface_culling(true),
+	cluster_size(128),
+	vertex_cache_optimization(false),
+	compact_vertex_format(false),
 	show_faces(true),
 	show_lines(true),
 	invert_normals(false),
@@ -56,6 +64,40 @@ IGL_INLINE void igl::opengl::ViewerData::set_face_based(bool newvalue)
 	}
 }
 
+IGL_INLINE void igl::opengl::ViewerData::set_cluster_culling(bool newvalue, int size)
+{
+	std::unique_lock<std::recursive_mutex> lck(mu_base);
+
+	if (cluster_culling != newvalue || (newvalue && cluster_size != size))
+	{
+		cluster_culling = newvalue;
+		cluster_size = size;
+		dirty |= MeshGL::DIRTY_FACE | MeshGL::DIRTY_POSITION;
+	}
+}
+
+IGL_INLINE void igl::opengl::ViewerData::set_vertex_cache_optimization(bool newvalue)
+{
+	std::unique_lock<std::recursive_mutex> lck(mu_base);
+
+	if (vertex_cache_optimization != newvalue)
+	{
+		vertex_cache_optimization = newvalue;
+		dirty |= MeshGL::DIRTY_FACE;
+	}
+}
+
+IGL_INLINE void igl::opengl::ViewerData::set_compact_vertex_format(bool newvalue)
+{
+	std::unique_lock<std::recursive_mutex> lck(mu_base);
+
+	if (compact_vertex_format != newvalue)
+	{
+		compact_vertex_format = newvalue;
+		dirty |= MeshGL::DIRTY_MESH;
+	}
+}
+
 IGL_INLINE void igl::opengl::ViewerData::set_mesh_translation() {
 	std::unique_lock<std::mutex> lck(mu_translations);
 	mesh_translation = -V.colwise().mean().eval().cast<float>();
@@ -88,6 +130,7 @@ IGL_INLINE void igl::opengl::ViewerData::set_mesh(
 	{
 		V = V_temp;
 		F = _F;
+		normals_engine.init(F, V.rows());
 
 		//See answer 3 on https://stackoverflow.com/questions/2415082/when-to-use-recursive-mutex for an alternative, non-recursive mutex implementation
 		compute_normals();
@@ -103,6 +146,7 @@ IGL_INLINE void igl::opengl::ViewerData::set_mesh(
 		{
 			V = V_temp;
 			F = _F;
+			normals_engine.init(F, V.rows());
 		}
 		else
 			cerr << "ERROR (set_mesh): The new mesh has a different number of vertices/faces. Please clear the mesh before plotting." << endl;
@@ -342,7 +386,9 @@ IGL_INLINE void igl::opengl::ViewerData::set_points(
 	std::unique_lock<std::recursive_mutex> lck(mu_overlay);
 
 	points.resize(0, 0);
+	points_pending.clear();
 	add_points(P, C);
+	dirty |= MeshGL::DIRTY_OVERLAY_POINTS;
 }
 
 IGL_INLINE void igl::opengl::ViewerData::add_points(const Eigen::MatrixXd& P, const Eigen::MatrixXd& C)
@@ -360,11 +406,16 @@ IGL_INLINE void igl::opengl::ViewerData::add_points(const Eigen::MatrixXd& P, co
 	else{
 		P_temp = P;
 	}
-	int lastid = points.rows();
-	points.conservativeResize(points.rows() + P_temp.rows(), 6);
+	points_pending.reserve(points_pending.size() + 6 * P_temp.rows());
 	for (unsigned i = 0; i < P_temp.rows(); ++i)
-		points.row(lastid + i) << P_temp.row(i), i < C.rows() ? C.row(i) : C.row(C.rows() - 1);
-	dirty |= MeshGL::DIRTY_OVERLAY_POINTS;
+	{
+		const int c = i < C.rows() ? i : C.rows() - 1;
+		for (int j = 0; j < 3; ++j)
+			points_pending.push_back(P_temp(i, j));
+		for (int j = 0; j < 3; ++j)
+			points_pending.push_back(C(c, j));
+	}
+	dirty |= MeshGL::DIRTY_OVERLAY_POINTS_APPEND;
 }
 
 IGL_INLINE void igl::opengl::ViewerData::set_laser_points(const Eigen::MatrixXd& LP, const Eigen::MatrixXd& C) {
@@ -404,12 +455,11 @@ IGL_INLINE void igl::opengl::ViewerData::set_linestrip(const Eigen::MatrixXd& LP
 	std::unique_lock<std::recursive_mutex> lck(mu_overlay);
 
 	linestrip.resize(0, 0);
+	linestrip_pending.clear();
 	if (LP.rows() > 0) {
 		add_linestrip(LP, C); //Will take care of unlocking
 	}
-	else {
-		dirty |= MeshGL::DIRTY_OVERLAY_STRIP;
-	}
+	dirty |= MeshGL::DIRTY_OVERLAY_STRIP;
 }
 
 IGL_INLINE void igl::opengl::ViewerData::add_linestrip(const Eigen::MatrixXd& LP, const Eigen::MatrixXd& C) {
@@ -424,13 +474,16 @@ IGL_INLINE void igl::opengl::ViewerData::add_linestrip(const Eigen::MatrixXd& LP
 	else {
 		LP_temp = LP;
 	}
-	int lastid = linestrip.rows();
-	linestrip.conservativeResize(linestrip.rows() + LP_temp.rows(), 6);
+	linestrip_pending.reserve(linestrip_pending.size() + 6 * LP_temp.rows());
 	for (unsigned i = 0; i < LP_temp.rows(); ++i) {
-		linestrip.row(lastid + i) << LP_temp.row(i), i < C.rows() ? C.row(i) : C.row(C.rows() - 1);
+		const int c = i < C.rows() ? i : C.rows() - 1;
+		for (int j = 0; j < 3; ++j)
+			linestrip_pending.push_back(LP_temp(i, j));
+		for (int j = 0; j < 3; ++j)
+			linestrip_pending.push_back(C(c, j));
 	}
 
-	dirty |= MeshGL::DIRTY_OVERLAY_STRIP;
+	dirty |= MeshGL::DIRTY_OVERLAY_STRIP_APPEND;
 }
 
 IGL_INLINE void igl::opengl::ViewerData::set_hand_point(
@@ -477,6 +530,7 @@ IGL_INLINE void igl::opengl::ViewerData::set_edges(
 	std::unique_lock<std::recursive_mutex> lck(mu_overlay);
 
 	lines.resize(E.rows(), 9);
+	lines_pending.clear();
 	assert(C.cols() == 3);
 	for (int e = 0; e < E.rows(); e++)
 	{
@@ -514,12 +568,19 @@ IGL_INLINE void igl::opengl::ViewerData::add_edges(const Eigen::MatrixXd& P1, co
 		P2_temp = P2;
 	}
 
-	int lastid = lines.rows();
-	lines.conservativeResize(lines.rows() + P1_temp.rows(), 9);
+	lines_pending.reserve(lines_pending.size() + 9 * P1_temp.rows());
 	for (unsigned i = 0; i < P1_temp.rows(); ++i)
-		lines.row(lastid + i) << P1_temp.row(i), P2_temp.row(i), i < C.rows() ? C.row(i) : C.row(C.rows() - 1);
+	{
+		const int c = i < C.rows() ? i : C.rows() - 1;
+		for (int j = 0; j < 3; ++j)
+			lines_pending.push_back(P1_temp(i, j));
+		for (int j = 0; j < 3; ++j)
+			lines_pending.push_back(P2_temp(i, j));
+		for (int j = 0; j < 3; ++j)
+			lines_pending.push_back(C(c, j));
+	}
 
-	dirty |= MeshGL::DIRTY_OVERLAY_LINES;
+	dirty |= MeshGL::DIRTY_OVERLAY_LINES_APPEND;
 }
 
 IGL_INLINE void igl::opengl::ViewerData::add_label(const Eigen::VectorXd& P, const std::string& str)
@@ -537,10 +598,55 @@ IGL_INLINE void igl::opengl::ViewerData::add_label(const Eigen::VectorXd& P, con
 	else
 		P_temp = P;
 
-	int lastid = labels_positions.rows();
-	labels_positions.conservativeResize(lastid + 1, 3);
-	labels_positions.row(lastid) = P_temp;
-	labels_strings.push_back(str);
+	for (int j = 0; j < 3; ++j)
+		labels_pending.push_back(P_temp(j));
+	labels_strings_pending.push_back(str);
+}
+
+IGL_INLINE void igl::opengl::ViewerData::flush_overlays()
+{
+	std::unique_lock<std::recursive_mutex> lck(mu_overlay);
+
+	typedef Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor> RowMatrixXd;
+	const auto flush = [](std::vector<double>& pending, Eigen::MatrixXd& X, const int cols)
+	{
+		if (pending.empty())
+			return;
+		const int n = pending.size() / cols;
+		const int lastid = X.rows();
+		X.conservativeResize(lastid + n, cols);
+		X.bottomRows(n) = Eigen::Map<const RowMatrixXd>(pending.data(), n, cols);
+		pending.clear();
+	};
+	flush(points_pending, points, 6);
+	flush(lines_pending, lines, 9);
+	flush(linestrip_pending, linestrip, 6);
+	flush(labels_pending, labels_positions, 3);
+	labels_strings.insert(labels_strings.end(), labels_strings_pending.begin(), labels_strings_pending.end());
+	labels_strings_pending.clear();
+}
+
+IGL_INLINE void igl::opengl::ViewerData::set_instances(const Eigen::MatrixXd& T, const Eigen::MatrixXd& C)
+{
+	using namespace std;
+	std::unique_lock<std::recursive_mutex> lck(mu_base);
+
+	if (T.rows() % 4 != 0 || (T.rows() > 0 && T.cols() != 3))
+	{
+		cerr << "ERROR (set_instances): Please provide a #I*4 by 3 stack of transposed affine transformations." << endl;
+		return;
+	}
+	const int n = T.rows() / 4;
+	if (n > 0 && C.rows() > 0 && ((C.rows() != 1 && C.rows() != n) || (C.cols() != 3 && C.cols() != 4)))
+	{
+		cerr << "ERROR (set_instances): Please provide a single color, or a color per instance, with 3 or 4 channels." << endl;
+		return;
+	}
+	instance_transforms = T;
+	instance_colors.setOnes(n, 4);
+	for (int i = 0; i < n && C.rows() > 0; ++i)
+		instance_colors.row(i).head(C.cols()) = C.row(C.rows() == 1 ? 0 : i);
+	dirty |= MeshGL::DIRTY_INSTANCES;
 }
 
 IGL_INLINE void igl::opengl::ViewerData::clear()
@@ -562,6 +668,7 @@ IGL_INLINE void igl::opengl::ViewerData::clear()
 
 	F_normals = Eigen::MatrixXd(0, 3);
 	V_normals = Eigen::MatrixXd(0, 3);
+	normals_engine = igl::MeshNormals();
 
 	V_uv = Eigen::MatrixXd(0, 2);
 	F_uv = Eigen::MatrixXi(0, 3);
@@ -572,10 +679,17 @@ IGL_INLINE void igl::opengl::ViewerData::clear()
 	laser_points = Eigen::MatrixXd(0, 3);
 	hand_point = Eigen::MatrixXd(0, 3);
 	linestrip = Eigen::MatrixXd(0, 3);
+	instance_transforms = Eigen::MatrixXd(0, 3);
+	instance_colors = Eigen::MatrixXd(0, 4);
 	mesh_trackball_angle = Eigen::Quaternionf::Identity();
 	mesh_translation = Eigen::Vector3f::Zero();
 	mesh_model_translation = Eigen::Matrix4f::Identity();
 	labels_strings.clear();
+	points_pending.clear();
+	lines_pending.clear();
+	linestrip_pending.clear();
+	labels_pending.clear();
+	labels_strings_pending.clear();
 
 	face_based = false;
 }
@@ -585,8 +699,17 @@ IGL_INLINE void igl::opengl::ViewerData::compute_normals()
 	std::unique_lock<std::recursive_mutex> lck(mu_base);
 
 
-	igl::per_face_normals(V, F, F_normals);
-	igl::per_vertex_normals(V, F, F_normals, V_normals);
+	// The incident faces of each vertex are only gathered again if the faces
+	// changed (also if F was assigned directly), so this is cheap to call
+	// every frame after set_vertices
+	const auto& NF = normals_engine.faces();
+	if (normals_engine.num_vertices() != V.rows() ||
+		NF.rows() != F.rows() || NF.cols() != F.cols() || NF != F)
+		normals_engine.init(F, V.rows());
+	normals_engine.update(V);
+	// Take the results without copying them, update overwrites the buffers
+	F_normals.swap(normals_engine.FN);
+	V_normals.swap(normals_engine.VN);
 	dirty |= MeshGL::DIRTY_NORMAL;
 }
 
@@ -703,6 +826,34 @@ IGL_INLINE void igl::opengl::ViewerData::updateGL(
 
 	meshgl.dirty |= data.dirty;
 
+	// Clusters for culling: the partition depends only on the faces, the
+	// bounds have to follow the vertices
+	if (!data.cluster_culling)
+	{
+		meshgl.cluster_faces.resize(0);
+		meshgl.cluster_offsets.resize(0);
+	}
+	else
+	{
+		if ((meshgl.dirty & MeshGL::DIRTY_FACE) || meshgl.cluster_offsets.size() == 0)
+		{
+			igl::meshlets(data.F, data.cluster_size, meshgl.cluster_faces, meshgl.cluster_offsets);
+			meshgl.dirty |= MeshGL::DIRTY_FACE | MeshGL::DIRTY_POSITION;
+		}
+		if (meshgl.dirty & MeshGL::DIRTY_POSITION)
+		{
+			Eigen::MatrixXd B, N;
+			Eigen::VectorXd R, A;
+			igl::meshlet_bounds(data.V, data.F, meshgl.cluster_faces, meshgl.cluster_offsets, B, R, N, A);
+			meshgl.cluster_spheres.resize(B.rows(), 4);
+			meshgl.cluster_spheres.leftCols(3) = B.cast<float>();
+			meshgl.cluster_spheres.col(3) = R.cast<float>();
+			meshgl.cluster_cones.resize(N.rows(), 4);
+			meshgl.cluster_cones.leftCols(3) = N.cast<float>();
+			meshgl.cluster_cones.col(3) = A.cast<float>();
+		}
+	}
+
 	// Input:
 	//   X  #F by dim quantity
 	// Output:
@@ -879,6 +1030,90 @@ IGL_INLINE void igl::opengl::ViewerData::updateGL(
 		}
 	}
 
+	// Store the faces of each cluster contiguously and/or reorder them for the
+	// vertex cache (within each cluster, to keep them contiguous). Reordering is
+	// pointless if every corner has its own vertex.
+	const bool shared_vertices = !data.face_based && !(per_corner_uv || per_corner_normals);
+	if ((meshgl.dirty & MeshGL::DIRTY_FACE) &&
+		(data.cluster_culling || (data.vertex_cache_optimization && shared_vertices)))
+	{
+		Eigen::VectorXi order, offsets;
+		if (data.cluster_culling)
+		{
+			order = meshgl.cluster_faces;
+			offsets = meshgl.cluster_offsets;
+		}
+		else
+		{
+			order = Eigen::VectorXi::LinSpaced(data.F.rows(), 0, data.F.rows() - 1);
+			offsets.resize(2);
+			offsets << 0, data.F.rows();
+		}
+		if (data.vertex_cache_optimization && shared_vertices)
+		{
+			// optimize_vertex_cache allocates per vertex index, so each cluster
+			// is remapped to local vertex indices first. The global to local map
+			// of each thread is reset after each cluster.
+			std::vector<std::vector<int> > local;
+			igl::parallel_for(offsets.size() - 1, [&](const size_t nt)
+			{
+				local.resize(nt);
+			}, [&](const int c, const size_t t)
+			{
+				std::vector<int> & L = local[t];
+				if (L.empty())
+					L.resize(data.V.rows(), -1);
+				const int nc = offsets(c + 1) - offsets(c);
+				Eigen::MatrixXi Fc(nc, 3), FFc;
+				std::vector<int> global;
+				for (int i = 0; i < nc; ++i)
+					for (int j = 0; j < 3; ++j)
+					{
+						const int v = data.F(order(offsets(c) + i), j);
+						if (L[v] < 0)
+						{
+							L[v] = global.size();
+							global.push_back(v);
+						}
+						Fc(i, j) = L[v];
+					}
+				for (const int v : global)
+					L[v] = -1;
+				Eigen::VectorXi Ic;
+				igl::optimize_vertex_cache(Fc, FFc, Ic);
+				const Eigen::VectorXi block = order.segment(offsets(c), nc);
+				for (int i = 0; i < nc; ++i)
+					order(offsets(c) + i) = block(Ic(i));
+			}, [](const size_t) {}, 2);
+		}
+		const Eigen::Matrix<unsigned, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor> F_vbo = meshgl.F_vbo;
+		for (unsigned i = 0; i < order.rows(); ++i)
+			meshgl.F_vbo.row(i) = F_vbo.row(order(i));
+	}
+
+	if (meshgl.dirty & MeshGL::DIRTY_INSTANCES)
+	{
+		const int n = data.instance_transforms.rows() / 4;
+		meshgl.instance_transforms_vbo.resize(n, 12);
+		for (int i = 0; i < n; ++i)
+			for (int j = 0; j < 4; ++j)
+				meshgl.instance_transforms_vbo.block<1, 3>(i, 3 * j) = data.instance_transforms.row(4 * i + j).cast<float>();
+		meshgl.instance_colors_vbo = data.instance_colors.cast<float>();
+	}
+
+	meshgl.compact_vertex_format = data.compact_vertex_format;
+	if (data.compact_vertex_format)
+		meshgl.compact_vertex_buffers();
+	else if (meshgl.V_vbo_compact.size() > 0)
+	{
+		meshgl.V_vbo_compact.resize(0, 0);
+		meshgl.V_normals_vbo_compact.resize(0, 0);
+		meshgl.V_ambient_vbo_compact.resize(0, 0);
+		meshgl.V_diffuse_vbo_compact.resize(0, 0);
+		meshgl.V_specular_vbo_compact.resize(0, 0);
+		meshgl.V_uv_vbo_compact.resize(0, 0);
+	}
+
 	if (meshgl.dirty & MeshGL::DIRTY_TEXTURE)
 	{
 		meshgl.tex_u = data.texture_R.rows();
@@ -893,34 +1128,26 @@ IGL_INLINE void igl::opengl::ViewerData::updateGL(
 		}
 	}
 
-	if (meshgl.dirty & MeshGL::DIRTY_OVERLAY_LINES)
+	// Overlays: the rows of X followed by the staged rows (see
+	// flush_overlays). Rebuild the buffer when the rows were replaced,
+	// otherwise only append the rows added since the last update.
+	typedef Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor> RowMatrixXd;
+	const auto update_overlay = [&](const Eigen::MatrixXd& X, const std::vector<double>& pending, const int cols, const uint32_t full, const uint32_t append, MeshGL::OverlayBuffer& buffer)
 	{
-		meshgl.lines_V_vbo.resize(data.lines.rows() * 2, 3);
-		meshgl.lines_V_colors_vbo.resize(data.lines.rows() * 2, 3);
-		meshgl.lines_F_vbo.resize(data.lines.rows() * 2, 1);
-		for (unsigned i = 0; i < data.lines.rows(); ++i)
-		{
-			meshgl.lines_V_vbo.row(2 * i + 0) = data.lines.block<1, 3>(i, 0).cast<float>();
-			meshgl.lines_V_vbo.row(2 * i + 1) = data.lines.block<1, 3>(i, 3).cast<float>();
-			meshgl.lines_V_colors_vbo.row(2 * i + 0) = data.lines.block<1, 3>(i, 6).cast<float>();
-			meshgl.lines_V_colors_vbo.row(2 * i + 1) = data.lines.block<1, 3>(i, 6).cast<float>();
-			meshgl.lines_F_vbo(2 * i + 0) = 2 * i + 0;
-			meshgl.lines_F_vbo(2 * i + 1) = 2 * i + 1;
-		}
-	}
-
-	if (meshgl.dirty & MeshGL::DIRTY_OVERLAY_POINTS)
-	{
-		meshgl.points_V_vbo.resize(data.points.rows(), 3);
-		meshgl.points_V_colors_vbo.resize(data.points.rows(), 3);
-		meshgl.points_F_vbo.resize(data.points.rows(), 1);
-		for (unsigned i = 0; i < data.points.rows(); ++i)
-		{
-			meshgl.points_V_vbo.row(i) = data.points.block<1, 3>(i, 0).cast<float>();
-			meshgl.points_V_colors_vbo.row(i) = data.points.block<1, 3>(i, 3).cast<float>();
-			meshgl.points_F_vbo(i) = i;
-		}
-	}
+		if (meshgl.dirty & full)
+			buffer.clear();
+		else if (!(meshgl.dirty & append))
+			return;
+		if (buffer.rows < X.rows())
+			buffer.append(X.bottomRows(X.rows() - buffer.rows));
+		const Eigen::Map<const RowMatrixXd> P(pending.data(), pending.size() / cols, cols);
+		const int first = buffer.rows - X.rows();
+		if (first < P.rows())
+			buffer.append(P.bottomRows(P.rows() - first));
+	};
+	update_overlay(data.lines, data.lines_pending, 9, MeshGL::DIRTY_OVERLAY_LINES, MeshGL::DIRTY_OVERLAY_LINES_APPEND, meshgl.lines_buffer);
+	update_overlay(data.points, data.points_pending, 6, MeshGL::DIRTY_OVERLAY_POINTS, MeshGL::DIRTY_OVERLAY_POINTS_APPEND, meshgl.points_buffer);
+	update_overlay(data.linestrip, data.linestrip_pending, 6, MeshGL::DIRTY_OVERLAY_STRIP, MeshGL::DIRTY_OVERLAY_STRIP_APPEND, meshgl.overlay_strip_buffer);
 
 	if (meshgl.dirty & MeshGL::DIRTY_LASER) {
 		meshgl.laser_points_V_vbo.resize(data.laser_points.rows(), 3);
@@ -944,16 +1171,6 @@ IGL_INLINE void igl::opengl::ViewerData::updateGL(
 		}
 	}
 
-	if (meshgl.dirty & MeshGL::DIRTY_OVERLAY_STRIP) {
-		meshgl.overlay_strip_V_vbo.resize(data.linestrip.rows(), 3);
-		meshgl.overlay_strip_F_vbo.resize(data.linestrip.rows(), 1);
-		meshgl.overlay_strip_V_colors_vbo.resize(data.linestrip.rows(), 3);
-		for (unsigned i = 0; i < data.linestrip.rows(); ++i) {
-			meshgl.overlay_strip_V_vbo.row(i) = data.linestrip.block<1, 3>(i, 0).transpose().cast<float>();
-			meshgl.overlay_strip_F_vbo(i) = i;
-			meshgl.overlay_strip_V_colors_vbo.row(i) = data.linestrip.block<1, 3>(i, 3).transpose().cast<float>();
-		}
-	}
 }
 
 IGL_INLINE void igl::opengl::ViewerData::rotate() { //Takes the trackball rotation as parameter to ensure it has been updated
@@ -9,6 +9,7 @@
 #define IGL_VIEWERDATA_H
 
 #include "../igl_inline.h"
+#include "../MeshNormals.h"
 #include "MeshGL.h"
 #include <cassert>
 #include <cstdint>
@@ -48,6 +49,7 @@ public:
 	  F = other.F;
 	  F_normals = other.F_normals;
 	  V_normals = other.V_normals;
+	  normals_engine = other.normals_engine;
 
 	  F_material_ambient = other.F_material_ambient;
 	  F_material_diffuse = other.F_material_diffuse;
@@ -65,9 +67,16 @@ public:
 	  linestrip = other.linestrip;
 	  labels_positions = other.labels_positions;
 	  labels_strings = other.labels_strings;
+	  points_pending = other.points_pending;
+	  lines_pending = other.lines_pending;
+	  linestrip_pending = other.linestrip_pending;
+	  labels_pending = other.labels_pending;
+	  labels_strings_pending = other.labels_strings_pending;
 
 	  laser_points = other.laser_points;
 	  hand_point = other.hand_point;
+	  instance_transforms = other.instance_transforms;
+	  instance_colors = other.instance_colors;
 
 	  texture_R = other.texture_R;
 	  texture_G = other.texture_G;
@@ -76,6 +85,11 @@ public:
 
 	  dirty = other.dirty;
 	  face_based = other.face_based;
+	  cluster_culling = other.cluster_culling;
+	  cluster_backface_culling = other.cluster_backface_culling;
+	  cluster_size = other.cluster_size;
+	  vertex_cache_optimization = other.vertex_cache_optimization;
+	  compact_vertex_format = other.compact_vertex_format;
 
 	  show_overlay = other.show_overlay;
 	  show_overlay_depth = other.show_overlay_depth;
@@ -119,6 +133,7 @@ public:
 	  F = other.F;
 	  F_normals = other.F_normals;
 	  V_normals = other.V_normals;
+	  normals_engine = other.normals_engine;
 
 	  F_material_ambient = other.F_material_ambient;
 	  F_material_diffuse = other.F_material_diffuse;
@@ -136,9 +151,16 @@ public:
 	  linestrip = other.linestrip;
 	  labels_positions = other.labels_positions;
 	  labels_strings = other.labels_strings;
+	  points_pending = other.points_pending;
+	  lines_pending = other.lines_pending;
+	  linestrip_pending = other.linestrip_pending;
+	  labels_pending = other.labels_pending;
+	  labels_strings_pending = other.labels_strings_pending;
 
 	  laser_points = other.laser_points;
 	  hand_point = other.hand_point;
+	  instance_transforms = other.instance_transforms;
+	  instance_colors = other.instance_colors;
 
 	  texture_R = other.texture_R;
 	  texture_G = other.texture_G;
@@ -147,6 +169,11 @@ public:
 
 	  dirty = other.dirty;
 	  face_based = other.face_based;
+	  cluster_culling = other.cluster_culling;
+	  cluster_backface_culling = other.cluster_backface_culling;
+	  cluster_size = other.cluster_size;
+	  vertex_cache_optimization = other.vertex_cache_optimization;
+	  compact_vertex_format = other.compact_vertex_format;
 
 	  show_overlay = other.show_overlay;
 	  show_overlay_depth = other.show_overlay_depth;
@@ -185,6 +212,23 @@ public:
   // Change the visualization mode, invalidating the cache if necessary
   IGL_INLINE void set_face_based(bool newvalue);
 
+  // Enable or disable cluster-based culling, invalidating the cache if
+  // necessary (see igl::meshlets)
+  //
+  // Inputs:
+  //   newvalue  whether to split the mesh into clusters that are culled
+  //     individually against the view frustum
+  //   size  maximum number of faces per cluster
+  IGL_INLINE void set_cluster_culling(bool newvalue, int size = 128);
+
+  // Enable or disable reordering the faces for the post-transform vertex
+  // cache before uploading them (see igl::optimize_vertex_cache)
+  IGL_INLINE void set_vertex_cache_optimization(bool newvalue);
+
+  // Enable or disable uploading the mesh in a compact vertex format (16-bit
+  // quantized positions, octahedral normals, RGBA8 colors, half float UVs)
+  IGL_INLINE void set_compact_vertex_format(bool newvalue);
+
   // Helpers that can draw the most common meshes
   IGL_INLINE void set_mesh(const Eigen::MatrixXd& V, const Eigen::MatrixXi& F);
   IGL_INLINE void set_vertices(const Eigen::MatrixXd& V);
@@ -260,6 +304,15 @@ public:
   IGL_INLINE void set_linestrip(const Eigen::MatrixXd& LP, const Eigen::MatrixXd& C);
   IGL_INLINE void add_linestrip(const Eigen::MatrixXd& LP, const Eigen::MatrixXd& C);
 
+  // Move the rows staged by add_points, add_edges, add_linestrip and add_label
+  // into points, lines, linestrip and labels_positions. The add_* functions
+  // only append to the staging vectors, which grow geometrically, and the
+  // viewer draws the staged rows after the matrices (uploading only the new
+  // ones to the GPU), so streaming many small additions per frame never
+  // copies the matrices. Call it before reading or assigning the overlay
+  // matrices directly (serialization does).
+  IGL_INLINE void flush_overlays();
+
   // Sets hand point given a list of point vertices. In constrast to `add_points`
   // this will (purposefully) clober existing points.
   //
@@ -284,6 +337,16 @@ public:
   IGL_INLINE void add_edges (const Eigen::MatrixXd& P1, const Eigen::MatrixXd& P2, const Eigen::MatrixXd& C);
   IGL_INLINE void add_label (const Eigen::VectorXd& P,  const std::string& str);
 
+  // Draw the mesh several times (in a single draw call) with different
+  // transformations and colors. Call with empty T to draw the mesh once.
+  //
+  // Inputs:
+  //   T  #I*4 by 3 stack of transposed affine transformations (rotation and
+  //     uniform scale, followed by translation), one per instance
+  //   C  #I|1 by 3|4 color(s) modulating the mesh colors per instance (empty
+  //     for white)
+  IGL_INLINE void set_instances(const Eigen::MatrixXd& T, const Eigen::MatrixXd& C);
+
   // Computes the normals of the mesh
   IGL_INLINE void compute_normals();
 
@@ -323,6 +386,11 @@ public:
   // Per vertex attributes
   Eigen::MatrixXd V_normals; // One normal per vertex
 
+  // Incident faces of each vertex, kept to update F_normals and V_normals
+  // quickly when only the vertices change (see compute_normals). Its FN and
+  // VN are swapped into F_normals and V_normals.
+  igl::MeshNormals normals_engine;
+
   Eigen::MatrixXd V_material_ambient; // Per vertex ambient color
   Eigen::MatrixXd V_material_diffuse; // Per vertex diffuse color
   Eigen::MatrixXd V_material_specular; // Per vertex specular color
@@ -355,18 +423,48 @@ public:
   
   Eigen::MatrixXd linestrip;
 
+  // Instances of the mesh (see set_instances)
+  Eigen::MatrixXd instance_transforms; // #I*4 by 3
+  Eigen::MatrixXd instance_colors; // #I by 4
+
   // Text labels plotted over the scene
   // Textp contains, in the i-th row, the position in global coordinates where the i-th label should be anchored
   // Texts contains in the i-th position the text of the i-th label
   Eigen::MatrixXd           labels_positions;
   std::vector<std::string>  labels_strings;
 
+  // Rows staged by the add_* functions, in row-major order, drawn after the
+  // rows of the matrices above (see flush_overlays)
+  std::vector<double> points_pending;
+  std::vector<double> lines_pending;
+  std::vector<double> linestrip_pending;
+  std::vector<double> labels_pending;
+  std::vector<std::string> labels_strings_pending;
+
   // Marks dirty buffers that need to be uploaded to OpenGL
   uint32_t dirty;
 
   // Enable per-face or per-vertex properties
   bool face_based;
 
+  // Split the mesh into clusters of at most cluster_size faces which are
+  // culled against the view frustum, and, if cluster_backface_culling is
+  // set, when they are entirely back-facing (assumes a closed, consistently
+  // oriented mesh). Use set_cluster_culling to change these.
+  bool cluster_culling;
+  bool cluster_backface_culling;
+  int cluster_size;
+
+  // Reorder the uploaded faces (within each cluster) for the post-transform
+  // vertex cache. V and F themselves are left untouched. Only has an effect
+  // for per-vertex attributes, use set_vertex_cache_optimization to change.
+  bool vertex_cache_optimization;
+
+  // Upload the mesh in a compact vertex format (see MeshGL), roughly halving
+  // GPU memory and upload time at the cost of quantizing positions to 16
+  // bits of the bounding box. Use set_compact_vertex_format to change.
+  bool compact_vertex_format;
+
   // Visualization options
   bool show_overlay;
   bool show_overlay_depth;
@@ -443,8 +541,15 @@ namespace igl
 	  SERIALIZE_MEMBER(laser_points);
 	  SERIALIZE_MEMBER(hand_point);
 	  SERIALIZE_MEMBER(linestrip);
+      SERIALIZE_MEMBER(instance_transforms);
+      SERIALIZE_MEMBER(instance_colors);
       SERIALIZE_MEMBER(dirty);
       SERIALIZE_MEMBER(face_based);
+      SERIALIZE_MEMBER(cluster_culling);
+      SERIALIZE_MEMBER(cluster_backface_culling);
+      SERIALIZE_MEMBER(cluster_size);
+      SERIALIZE_MEMBER(vertex_cache_optimization);
+      SERIALIZE_MEMBER(compact_vertex_format);
       SERIALIZE_MEMBER(show_overlay);
       SERIALIZE_MEMBER(show_overlay_depth);
 	  SERIALIZE_MEMBER(show_texture);
@@ -469,12 +574,14 @@ namespace igl
     template<>
     inline void serialize(const igl::opengl::ViewerData& obj, std::vector<char>& buffer)
     {
+      const_cast<igl::opengl::ViewerData&>(obj).flush_overlays();
       serialization(true, const_cast<igl::opengl::ViewerData&>(obj), buffer);
     }
     template<>
     inline void deserialize(igl::opengl::ViewerData& obj, const std::vector<char>& buffer)
     {
       serialization(false, obj, const_cast<std::vector<char>&>(buffer));
+      obj.normals_engine = igl::MeshNormals();
       obj.dirty = igl::opengl::MeshGL::DIRTY_ALL;
     }
   }
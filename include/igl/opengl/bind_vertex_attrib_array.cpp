@@ -19,6 +19,45 @@ IGL_INLINE GLint igl::opengl::bind_vertex_attrib_array(
   if (refresh)
     glBufferData(GL_ARRAY_BUFFER, sizeof(float)*M.size(), M.data(), GL_DYNAMIC_DRAW);
   glVertexAttribPointer(id, M.cols(), GL_FLOAT, GL_FALSE, 0, 0);
+  // The location may have been used by a per-instance attribute of
+  // another program sharing the vertex array
+  glVertexAttribDivisor(id, 0);
   glEnableVertexAttribArray(id);
   return id;
 }
+
+template <typename Scalar>
+IGL_INLINE GLint igl::opengl::bind_vertex_attrib_array(
+  const GLuint program_shader,
+  const std::string &name, 
+  GLuint bufferID, 
+  const Eigen::Matrix<Scalar,Eigen::Dynamic,Eigen::Dynamic,Eigen::RowMajor> &M, 
+  GLenum type,
+  GLboolean normalized,
+  bool refresh)
+{
+  GLint id = glGetAttribLocation(program_shader, name.c_str());
+  if (id < 0)
+    return id;
+  if (M.size() == 0)
+  {
+    glDisableVertexAttribArray(id);
+    return id;
+  }
+  glBindBuffer(GL_ARRAY_BUFFER, bufferID);
+  if (refresh)
+    glBufferData(GL_ARRAY_BUFFER, sizeof(Scalar)*M.size(), M.data(), GL_DYNAMIC_DRAW);
+  glVertexAttribPointer(id, M.cols(), type, normalized, 0, 0);
+  // The location may have been used by a per-instance attribute of
+  // another program sharing the vertex array
+  glVertexAttribDivisor(id, 0);
+  glEnableVertexAttribArray(id);
+  return id;
+}
+
+#ifdef IGL_STATIC_LIBRARY
+// Explicit template instantiation
+template GLint igl::opengl::bind_vertex_attrib_array<unsigned short>(const GLuint, const std::string &, GLuint, const Eigen::Matrix<unsigned short,Eigen::Dynamic,Eigen::Dynamic,Eigen::RowMajor> &, GLenum, GLboolean, bool);
+template GLint igl::opengl::bind_vertex_attrib_array<short>(const GLuint, const std::string &, GLuint, const Eigen::Matrix<short,Eigen::Dynamic,Eigen::Dynamic,Eigen::RowMajor> &, GLenum, GLboolean, bool);
+template GLint igl::opengl::bind_vertex_attrib_array<unsigned char>(const GLuint, const std::string &, GLuint, const Eigen::Matrix<unsigned char,Eigen::Dynamic,Eigen::Dynamic,Eigen::RowMajor> &, GLenum, GLboolean, bool);
+#endif
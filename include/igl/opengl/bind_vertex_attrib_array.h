@@ -9,7 +9,7 @@ namespace igl
   namespace opengl
   {
     // Bind a per-vertex array attribute and refresh its contents from an Eigen
-    // matrix
+    // matrix. The attribute divisor is reset to 0 (per vertex).
     //
     // Inputs:
     //   program_shader  id of shader program
@@ -24,6 +24,23 @@ namespace igl
       GLuint bufferID, 
       const Eigen::Matrix<float,Eigen::Dynamic,Eigen::Dynamic,Eigen::RowMajor> &M, 
       bool refresh);
+    // Bind a per-vertex array attribute stored in a compact (non-float) format
+    //
+    // Inputs:
+    //   M  #V by dim matrix of per-vertex data
+    //   type  OpenGL type of the entries of M (e.g. GL_UNSIGNED_SHORT,
+    //     GL_SHORT, GL_UNSIGNED_BYTE or GL_HALF_FLOAT)
+    //   normalized  whether integer data is mapped to [0,1] (unsigned) or
+    //     [-1,1] (signed) when accessed in the shader
+    template <typename Scalar>
+    IGL_INLINE GLint bind_vertex_attrib_array(
+      const GLuint program_shader,
+      const std::string &name, 
+      GLuint bufferID, 
+      const Eigen::Matrix<Scalar,Eigen::Dynamic,Eigen::Dynamic,Eigen::RowMajor> &M, 
+      GLenum type,
+      GLboolean normalized,
+      bool refresh);
   }
 }
 #ifndef IGL_STATIC_LIBRARY
@@ -339,36 +339,60 @@ IGL_INLINE void ImGuiMenu::draw_labels_window()
 
 IGL_INLINE void ImGuiMenu::draw_labels(const igl::opengl::ViewerData &data)
 {
-  if (data.show_vertid)
+  // Gather the anchors of all labels and project them in a single batch
+  const int nv = data.show_vertid ? data.V.rows() : 0;
+  const int nf = data.show_faceid ? data.F.rows() : 0;
+  // Labels added since the last ViewerData::flush_overlays are still staged
+  const int nlf = data.labels_positions.rows();
+  const int nl = nlf + data.labels_pending.size() / 3;
+  if (nv + nf + nl == 0)
   {
-    for (int i = 0; i < data.V.rows(); ++i)
+    return;
+  }
+  const double offset = 0.005 * viewer->core.object_scale;
+  Eigen::MatrixXf P(nv + nf + nl, 3);
+  for (int i = 0; i < nv; ++i)
+  {
+    P.row(i) = (data.V.row(i) + offset * data.V_normals.row(i)).cast<float>();
+  }
+  for (int i = 0; i < nf; ++i)
+  {
+    Eigen::RowVector3d p = Eigen::RowVector3d::Zero();
+    for (int j = 0; j < data.F.cols(); ++j)
     {
-      draw_text(data.V.row(i), data.V_normals.row(i), std::to_string(i));
+      p += data.V.row(data.F(i,j));
     }
+    p /= (double) data.F.cols();
+    P.row(nv + i) = (p + offset * data.F_normals.row(i)).cast<float>();
   }
-
-  if (data.show_faceid)
+  if (nlf > 0)
   {
-    for (int i = 0; i < data.F.rows(); ++i)
+    P.middleRows(nv + nf, nlf) = data.labels_positions.cast<float>();
+  }
+  for (int i = nlf; i < nl; ++i)
+  {
+    for (int j = 0; j < 3; ++j)
     {
-      Eigen::RowVector3d p = Eigen::RowVector3d::Zero();
-      for (int j = 0; j < data.F.cols(); ++j)
-      {
-        p += data.V.row(data.F(i,j));
-      }
-      p /= (double) data.F.cols();
-
-      draw_text(p, data.F_normals.row(i), std::to_string(i));
+      P(nv + nf + i, j) = data.labels_pending[3 * (i - nlf) + j];
     }
   }
 
-  if (data.labels_positions.rows() > 0)
+  Eigen::MatrixXf coords;
+  igl::project(P, Eigen::Matrix4f(viewer->core.view * viewer->core.model),
+    viewer->core.proj, viewer->core.viewport, coords);
+
+  for (int i = 0; i < nv; ++i)
   {
-    for (int i = 0; i < data.labels_positions.rows(); ++i)
-    {
-      draw_text(data.labels_positions.row(i), Eigen::Vector3d(0.0,0.0,0.0),
-        data.labels_strings[i]);
-    }
+    draw_projected_text(coords.row(i), std::to_string(i));
+  }
+  for (int i = 0; i < nf; ++i)
+  {
+    draw_projected_text(coords.row(nv + i), std::to_string(i));
+  }
+  for (int i = 0; i < nl; ++i)
+  {
+    draw_projected_text(coords.row(nv + nf + i),
+      i < nlf ? data.labels_strings[i] : data.labels_strings_pending[i - nlf]);
   }
 }
 
@@ -378,7 +402,11 @@ IGL_INLINE void ImGuiMenu::draw_text(Eigen::Vector3d pos, Eigen::Vector3d normal
   pos += normal * 0.005f * viewer->core.object_scale;
   Eigen::Vector3f coord = igl::project(Eigen::Vector3f(pos.cast<float>()),
     view_matrix, viewer->core.proj, viewer->core.viewport);
+  draw_projected_text(coord, text);
+}
 
+IGL_INLINE void ImGuiMenu::draw_projected_text(const Eigen::Vector3f &coord, const std::string &text)
+{
   // Draw text labels slightly bigger than normal text
   ImDrawList* drawList = ImGui::GetWindowDrawList();
   drawList->AddText(ImGui::GetFont(), ImGui::GetFontSize() * 1.2,
@@ -108,6 +108,9 @@ public:
 
   IGL_INLINE void draw_text(Eigen::Vector3d pos, Eigen::Vector3d normal, const std::string &text);
 
+  // Draw text at screen coordinates returned by igl::project
+  IGL_INLINE void draw_projected_text(const Eigen::Vector3f &coord, const std::string &text);
+
   IGL_INLINE float pixel_ratio();
 
   IGL_INLINE float hidpi_scaling();
@@ -0,0 +1,195 @@
+// This file is part of libigl, a simple c++ geometry processing library.
+//
+// Copyright (C) 2018 Floor Verhoeven
+//
+// This Source Code Form is subject to the terms of the Mozilla Public License
+// v. 2.0. If a copy of the MPL was not distributed with this file, You can
+// obtain one at http://mozilla.org/MPL/2.0/.
+#include "optimize_vertex_cache.h"
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+template <typename DerivedF, typename DerivedFF, typename DerivedI>
+IGL_INLINE void igl::optimize_vertex_cache(
+  const Eigen::MatrixBase<DerivedF> & F,
+  const int cache_size,
+  Eigen::PlainObjectBase<DerivedFF> & FF,
+  Eigen::PlainObjectBase<DerivedI> & I)
+{
+  using namespace std;
+  assert(F.cols() == 3 && "F should contain triangles");
+  assert(cache_size > 3 && "cache_size should be larger than 3");
+  const int m = F.rows();
+  I.resize(m,1);
+  FF.resize(m,3);
+  if(m == 0)
+  {
+    return;
+  }
+  const int n = F.maxCoeff()+1;
+
+  // Vertex score as a function of its position in the LRU cache and of its
+  // number of remaining (not yet emitted) faces [Forsyth 2006]
+  const float cache_decay_power = 1.5f;
+  const float last_tri_score = 0.75f;
+  const float valence_boost_scale = 2.0f;
+  const float valence_boost_power = 0.5f;
+  const auto vertex_score = [&](const int pos, const int valence)->float
+  {
+    if(valence == 0)
+    {
+      return -1.f;
+    }
+    float score = 0.f;
+    if(pos >= 0)
+    {
+      if(pos < 3)
+      {
+        score = last_tri_score;
+      }else
+      {
+        const float scaler = 1.f/(cache_size-3);
+        score = pow(1.f-(pos-3)*scaler,cache_decay_power);
+      }
+    }
+    return score + valence_boost_scale*pow((float)valence,-valence_boost_power);
+  };
+
+  // Vertex-face adjacency in compressed form: the active (not yet emitted)
+  // faces of vertex v are VF[VFo[v]],...,VF[VFo[v]+valence[v]-1]
+  vector<int> valence(n,0);
+  for(int f = 0;f<m;f++)
+  {
+    for(int c = 0;c<3;c++)
+    {
+      valence[F(f,c)]++;
+    }
+  }
+  vector<int> VFo(n+1,0);
+  for(int v = 0;v<n;v++)
+  {
+    VFo[v+1] = VFo[v]+valence[v];
+  }
+  vector<int> VF(VFo[n]);
+  {
+    vector<int> fill(VFo.begin(),VFo.end()-1);
+    for(int f = 0;f<m;f++)
+    {
+      for(int c = 0;c<3;c++)
+      {
+        VF[fill[F(f,c)]++] = f;
+      }
+    }
+  }
+
+  vector<int> cache_pos(n,-1);
+  vector<float> vscore(n);
+  for(int v = 0;v<n;v++)
+  {
+    vscore[v] = vertex_score(-1,valence[v]);
+  }
+  vector<float> fscore(m);
+  vector<bool> emitted(m,false);
+  for(int f = 0;f<m;f++)
+  {
+    fscore[f] = vscore[F(f,0)]+vscore[F(f,1)]+vscore[F(f,2)];
+  }
+
+  // Start from the globally best face
+  int best = max_element(fscore.begin(),fscore.end())-fscore.begin();
+  vector<int> cache,new_cache;
+  cache.reserve(cache_size+3);
+  new_cache.reserve(cache_size+3);
+  int scan = 0;
+  for(int k = 0;k<m;k++)
+  {
+    if(best < 0)
+    {
+      // No face touches the cache: fall back to the next face in input order
+      while(emitted[scan]) scan++;
+      best = scan;
+    }
+    I(k) = best;
+    emitted[best] = true;
+    // Remove best from the active faces of its vertices
+    for(int c = 0;c<3;c++)
+    {
+      const int v = F(best,c);
+      int * begin = &VF[VFo[v]];
+      int * end = begin+valence[v];
+      int * it = find(begin,end,best);
+      if(it != end)
+      {
+        *it = *(end-1);
+        valence[v]--;
+      }
+    }
+    // Move the vertices of best to the front of the LRU cache
+    new_cache.clear();
+    for(int c = 0;c<3;c++)
+    {
+      const int v = F(best,c);
+      if(find(new_cache.begin(),new_cache.end(),v) == new_cache.end())
+      {
+        new_cache.push_back(v);
+      }
+    }
+    for(const int v : cache)
+    {
+      if(find(new_cache.begin(),new_cache.end(),v) == new_cache.end())
+      {
+        new_cache.push_back(v);
+      }
+    }
+    swap(cache,new_cache);
+    // Update the scores of the vertices in (or just evicted from) the cache
+    for(int p = 0;p<(int)cache.size();p++)
+    {
+      const int v = cache[p];
+      cache_pos[v] = p < cache_size ? p : -1;
+      vscore[v] = vertex_score(cache_pos[v],valence[v]);
+    }
+    // Update the scores of the active faces touching the cache and pick the
+    // best one
+    best = -1;
+    float best_score = -1.f;
+    for(const int v : cache)
+    {
+      for(int j = VFo[v];j<VFo[v]+valence[v];j++)
+      {
+        const int f = VF[j];
+        fscore[f] = vscore[F(f,0)]+vscore[F(f,1)]+vscore[F(f,2)];
+        if(fscore[f] > best_score)
+        {
+          best_score = fscore[f];
+          best = f;
+        }
+      }
+    }
+    if((int)cache.size() > cache_size)
+    {
+      cache.resize(cache_size);
+    }
+  }
+
+  for(int k = 0;k<m;k++)
+  {
+    FF.row(k) = F.row(I(k)).template cast<typename DerivedFF::Scalar>();
+  }
+}
+
+template <typename DerivedF, typename DerivedFF, typename DerivedI>
+IGL_INLINE void igl::optimize_vertex_cache(
+  const Eigen::MatrixBase<DerivedF> & F,
+  Eigen::PlainObjectBase<DerivedFF> & FF,
+  Eigen::PlainObjectBase<DerivedI> & I)
+{
+  return optimize_vertex_cache(F,32,FF,I);
+}
+
+#ifdef IGL_STATIC_LIBRARY
+// Explicit template instantiation
+template void igl::optimize_vertex_cache<Eigen::Matrix<int, -1, -1, 0, -1, -1>, Eigen::Matrix<int, -1, -1, 0, -1, -1>, Eigen::Matrix<int, -1, 1, 0, -1, 1> >(Eigen::MatrixBase<Eigen::Matrix<int, -1, -1, 0, -1, -1> > const&, int, Eigen::PlainObjectBase<Eigen::Matrix<int, -1, -1, 0, -1, -1> >&, Eigen::PlainObjectBase<Eigen::Matrix<int, -1, 1, 0, -1, 1> >&);
+template void igl::optimize_vertex_cache<Eigen::Matrix<int, -1, -1, 0, -1, -1>, Eigen::Matrix<int, -1, -1, 0, -1, -1>, Eigen::Matrix<int, -1, 1, 0, -1, 1> >(Eigen::MatrixBase<Eigen::Matrix<int, -1, -1, 0, -1, -1> > const&, Eigen::PlainObjectBase<Eigen::Matrix<int, -1, -1, 0, -1, -1> >&, Eigen::PlainObjectBase<Eigen::Matrix<int, -1, 1, 0, -1, 1> >&);
+#endif
@@ -0,0 +1,45 @@
+// This file is part of libigl, a simple c++ geometry processing library.
+//
+// Copyright (C) 2018 Floor Verhoeven
+//
+// This Source Code Form is subject to the terms of the Mozilla Public License
+// v. 2.0. If a copy of the MPL was not distributed with this file, You can
+// obtain one at http://mozilla.org/MPL/2.0/.
+#ifndef IGL_OPTIMIZE_VERTEX_CACHE_H
+#define IGL_OPTIMIZE_VERTEX_CACHE_H
+#include "igl_inline.h"
+#include <Eigen/Core>
+namespace igl
+{
+  // OPTIMIZE_VERTEX_CACHE Reorder the faces of a triangle mesh to improve the
+  // hit rate of the post-transform vertex cache of the GPU, following "Linear-
+  // Speed Vertex Cache Optimisation" [Forsyth 2006]. Vertices are scored by
+  // their position in a simulated LRU cache and by their number of remaining
+  // faces, and the face with the highest total score is emitted next.
+  //
+  // Inputs:
+  //   F  #F by 3 list of triangle indices
+  //   cache_size  size of the simulated cache (must be > 3) {32}
+  // Outputs:
+  //   FF  #F by 3 list of reordered triangle indices, FF = F(I,:)
+  //   I  #F list of face indices into F
+  //
+  // See also: optimize_vertex_fetch, vertex_cache_efficiency, sort_triangles
+  template <typename DerivedF, typename DerivedFF, typename DerivedI>
+  IGL_INLINE void optimize_vertex_cache(
+    const Eigen::MatrixBase<DerivedF> & F,
+    const int cache_size,
+    Eigen::PlainObjectBase<DerivedFF> & FF,
+    Eigen::PlainObjectBase<DerivedI> & I);
+  template <typename DerivedF, typename DerivedFF, typename DerivedI>
+  IGL_INLINE void optimize_vertex_cache(
+    const Eigen::MatrixBase<DerivedF> & F,
+    Eigen::PlainObjectBase<DerivedFF> & FF,
+    Eigen::PlainObjectBase<DerivedI> & I);
+}
+
+#ifndef IGL_STATIC_LIBRARY
+#  include "optimize_vertex_cache.cpp"
+#endif
+
+#endif
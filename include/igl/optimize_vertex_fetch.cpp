@@ -0,0 +1,85 @@
+// This file is part of libigl, a simple c++ geometry processing library.
+//
+// Copyright (C) 2018 Floor Verhoeven
+//
+// This Source Code Form is subject to the terms of the Mozilla Public License
+// v. 2.0. If a copy of the MPL was not distributed with this file, You can
+// obtain one at http://mozilla.org/MPL/2.0/.
+#include "optimize_vertex_fetch.h"
+
+template <
+  typename DerivedF,
+  typename DerivedNF,
+  typename DerivedIM,
+  typename DerivedJ>
+IGL_INLINE void igl::optimize_vertex_fetch(
+  const size_t n,
+  const Eigen::MatrixBase<DerivedF> & F,
+  Eigen::PlainObjectBase<DerivedNF> & NF,
+  Eigen::PlainObjectBase<DerivedIM> & IM,
+  Eigen::PlainObjectBase<DerivedJ> & J)
+{
+  typedef typename DerivedIM::Scalar Index;
+  IM.setConstant(n,1,-1);
+  J.resize(n,1);
+  Index next = 0;
+  // Faces are visited row by row to follow the drawing order
+  for(int f = 0;f<F.rows();f++)
+  {
+    for(int c = 0;c<F.cols();c++)
+    {
+      const auto v = F(f,c);
+      assert(v >= 0 && (size_t)v < n);
+      if(IM(v) < 0)
+      {
+        J(next) = v;
+        IM(v) = next++;
+      }
+    }
+  }
+  for(size_t v = 0;v<n;v++)
+  {
+    if(IM(v) < 0)
+    {
+      J(next) = v;
+      IM(v) = next++;
+    }
+  }
+  NF.resizeLike(F);
+  for(int f = 0;f<F.rows();f++)
+  {
+    for(int c = 0;c<F.cols();c++)
+    {
+      NF(f,c) = IM(F(f,c));
+    }
+  }
+}
+
+template <
+  typename DerivedV,
+  typename DerivedF,
+  typename DerivedNV,
+  typename DerivedNF,
+  typename DerivedIM,
+  typename DerivedJ>
+IGL_INLINE void igl::optimize_vertex_fetch(
+  const Eigen::MatrixBase<DerivedV> & V,
+  const Eigen::MatrixBase<DerivedF> & F,
+  Eigen::PlainObjectBase<DerivedNV> & NV,
+  Eigen::PlainObjectBase<DerivedNF> & NF,
+  Eigen::PlainObjectBase<DerivedIM> & IM,
+  Eigen::PlainObjectBase<DerivedJ> & J)
+{
+  optimize_vertex_fetch(V.rows(),F,NF,IM,J);
+  NV.resize(V.rows(),V.cols());
+  for(int i = 0;i<V.rows();i++)
+  {
+    NV.row(i) = V.row(J(i));
+  }
+}
+
+#ifdef IGL_STATIC_LIBRARY
+// Explicit template instantiation
+template void igl::optimize_vertex_fetch<Eigen::Matrix<int, -1, -1, 0, -1, -1>, Eigen::Matrix<int, -1, -1, 0, -1, -1>, Eigen::Matrix<int, -1, 1, 0, -1, 1>, Eigen::Matrix<int, -1, 1, 0, -1, 1> >(size_t, Eigen::MatrixBase<Eigen::Matrix<int, -1, -1, 0, -1, -1> > const&, Eigen::PlainObjectBase<Eigen::Matrix<int, -1, -1, 0, -1, -1> >&, Eigen::PlainObjectBase<Eigen::Matrix<int, -1, 1, 0, -1, 1> >&, Eigen::PlainObjectBase<Eigen::Matrix<int, -1, 1, 0, -1, 1> >&);
+template void igl::optimize_vertex_fetch<Eigen::Matrix<double, -1, -1, 0, -1, -1>, Eigen::Matrix<int, -1, -1, 0, -1, -1>, Eigen::Matrix<double, -1, -1, 0, -1, -1>, Eigen::Matrix<int, -1, -1, 0, -1, -1>, Eigen::Matrix<int, -1, 1, 0, -1, 1>, Eigen::Matrix<int, -1, 1, 0, -1, 1> >(Eigen::MatrixBase<Eigen::Matrix<double, -1, -1, 0, -1, -1> > const&, Eigen::MatrixBase<Eigen::Matrix<int, -1, -1, 0, -1, -1> > const&, Eigen::PlainObjectBase<Eigen::Matrix<double, -1, -1, 0, -1, -1> >&, Eigen::PlainObjectBase<Eigen::Matrix<int, -1, -1, 0, -1, -1> >&, Eigen::PlainObjectBase<Eigen::Matrix<int, -1, 1, 0, -1, 1> >&, Eigen::PlainObjectBase<Eigen::Matrix<int, -1, 1, 0, -1, 1> >&);
+#endif
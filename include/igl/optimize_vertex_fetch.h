@@ -0,0 +1,68 @@
+// This file is part of libigl, a simple c++ geometry processing library.
+//
+// Copyright (C) 2018 Floor Verhoeven
+//
+// This Source Code Form is subject to the terms of the Mozilla Public License
+// v. 2.0. If a copy of the MPL was not distributed with this file, You can
+// obtain one at http://mozilla.org/MPL/2.0/.
+#ifndef IGL_OPTIMIZE_VERTEX_FETCH_H
+#define IGL_OPTIMIZE_VERTEX_FETCH_H
+#include "igl_inline.h"
+#include <Eigen/Core>
+namespace igl
+{
+  // OPTIMIZE_VERTEX_FETCH Renumber the vertices of a mesh in the order in
+  // which they are first referenced by the faces, so that vertex data is
+  // fetched (nearly) sequentially from memory when drawing. Best applied
+  // after optimize_vertex_cache. Unreferenced vertices are moved to the end.
+  //
+  // Inputs:
+  //   n  number of vertices (e.g. V.rows())
+  //   F  #F by ss list of simplices
+  // Outputs:
+  //   NF  #F by ss list of renumbered simplices, NF = IM(F)
+  //   IM  n list of new vertex indices, so that NF(i,j) = IM(F(i,j))
+  //   J  n list of old vertex indices, so that NV = V(J,:) (e.g. using
+  //     igl::slice(V,J,1,NV))
+  //
+  // See also: optimize_vertex_cache, remove_unreferenced
+  template <
+    typename DerivedF,
+    typename DerivedNF,
+    typename DerivedIM,
+    typename DerivedJ>
+  IGL_INLINE void optimize_vertex_fetch(
+    const size_t n,
+    const Eigen::MatrixBase<DerivedF> & F,
+    Eigen::PlainObjectBase<DerivedNF> & NF,
+    Eigen::PlainObjectBase<DerivedIM> & IM,
+    Eigen::PlainObjectBase<DerivedJ> & J);
+  // Inputs:
+  //   V  #V by dim list of vertex positions
+  //   F  #F by ss list of simplices
+  // Outputs:
+  //   NV  #V by dim list of reordered vertex positions, NV = V(J,:)
+  //   NF  #F by ss list of renumbered simplices
+  //   IM  #V list of new vertex indices
+  //   J  #V list of old vertex indices
+  template <
+    typename DerivedV,
+    typename DerivedF,
+    typename DerivedNV,
+    typename DerivedNF,
+    typename DerivedIM,
+    typename DerivedJ>
+  IGL_INLINE void optimize_vertex_fetch(
+    const Eigen::MatrixBase<DerivedV> & V,
+    const Eigen::MatrixBase<DerivedF> & F,
+    Eigen::PlainObjectBase<DerivedNV> & NV,
+    Eigen::PlainObjectBase<DerivedNF> & NF,
+    Eigen::PlainObjectBase<DerivedIM> & IM,
+    Eigen::PlainObjectBase<DerivedJ> & J);
+}
+
+#ifndef IGL_STATIC_LIBRARY
+#  include "optimize_vertex_fetch.cpp"
+#endif
+
+#endif
@@ -6,6 +6,9 @@
 // v. 2.0. If a copy of the MPL was not distributed with this file, You can
 // obtain one at http://mozilla.org/MPL/2.0/.
 #include "per_vertex_attribute_smoothing.h"
+#include "parallel_for.h"
+#include "vertex_triangle_adjacency.h"
+#include <thread>
 #include <vector>
 
 template <typename DerivedV, typename DerivedF>
@@ -14,18 +17,36 @@ IGL_INLINE void igl::per_vertex_attribute_smoothing(
     const Eigen::PlainObjectBase<DerivedF>& F,
     Eigen::PlainObjectBase<DerivedV> & Aout)
 {
-    std::vector<double> denominator(Ain.rows(), 0);
     Aout = DerivedV::Zero(Ain.rows(), Ain.cols());
-    for (int i = 0; i < F.rows(); ++i) {
-        for (int j = 0; j < 3; ++j) {
-            int j1 = (j + 1) % 3;
-            int j2 = (j + 2) % 3;
-            Aout.row(F(i, j)) += Ain.row(F(i, j1)) + Ain.row(F(i, j2));
-            denominator[F(i, j)] += 2;
+    if (std::thread::hardware_concurrency() == 1 || Ain.rows() < 1000) {
+        // Without threads to share the gather, scattering is cheaper than
+        // building the adjacency
+        std::vector<double> denominator(Ain.rows(), 0);
+        for (int i = 0; i < F.rows(); ++i) {
+            for (int j = 0; j < 3; ++j) {
+                int j1 = (j + 1) % 3;
+                int j2 = (j + 2) % 3;
+                Aout.row(F(i, j)) += Ain.row(F(i, j1)) + Ain.row(F(i, j2));
+                denominator[F(i, j)] += 2;
+            }
         }
+        for (int i = 0; i < Ain.rows(); ++i)
+            Aout.row(i) /= denominator[i];
+        return;
     }
-    for (int i = 0; i < Ain.rows(); ++i)
-        Aout.row(i) /= denominator[i];
+    // Gather from the incident faces of each vertex (in the same order as
+    // the scatter, so the sums are the same)
+    Eigen::VectorXi VF, VFi, NI;
+    vertex_triangle_adjacency(F, Ain.rows(), VF, VFi, NI);
+    parallel_for(Ain.rows(), [&](const int v) {
+        for (int i = NI(v); i < NI(v + 1); ++i) {
+            const int f = VF(i);
+            const int j = VFi(i);
+            Aout.row(v) +=
+                Ain.row(F(f, (j + 1) % 3)) + Ain.row(F(f, (j + 2) % 3));
+        }
+        Aout.row(v) /= double(2 * (NI(v + 1) - NI(v)));
+    }, 1000);
 }
 
 #ifdef IGL_STATIC_LIBRARY
@@ -12,6 +12,8 @@
 #include "doublearea.h"
 #include "parallel_for.h"
 #include "internal_angles.h"
+#include "vertex_triangle_adjacency.h"
+#include <thread>
 
 template <
   typename DerivedV,
@@ -71,35 +73,35 @@ IGL_INLINE void igl::per_vertex_normals(
       break;
   }
 
-  // loop over faces
-  for(int i = 0;i<F.rows();i++)
+  if(std::thread::hardware_concurrency() == 1 || V.rows() < 1000)
   {
-    // throw normal at each corner
-    for(int j = 0; j < 3;j++)
+    // Without threads to share the gather, scattering is cheaper than
+    // building the adjacency
+    for(int i = 0;i<F.rows();i++)
     {
-      N.row(F(i,j)) += W(i,j) * FN.row(i);
+      // throw normal at each corner
+      for(int j = 0; j < 3;j++)
+      {
+        N.row(F(i,j)) += W(i,j) * FN.row(i);
+      }
     }
+  }else
+  {
+    // Gather over the incident corners of each vertex (in ascending face
+    // order as the scatter, so the sums are the same)
+    Eigen::VectorXi VF,VFi,NI;
+    vertex_triangle_adjacency(F,V.rows(),VF,VFi,NI);
+    parallel_for(V.rows(),[&](const int v)
+    {
+      Eigen::Matrix<typename DerivedN::Scalar,1,3> n(0,0,0);
+      for(int i = NI(v);i<NI(v+1);i++)
+      {
+        n += W(VF(i),VFi(i)) * FN.row(VF(i));
+      }
+      N.row(v) = n;
+    },1000);
   }
 
-  //// loop over faces
-  //std::mutex critical;
-  //std::vector<DerivedN> NN;
-  //parallel_for(
-  //  F.rows(),
-  //  [&NN,&N](const size_t n){ NN.resize(n,DerivedN::Zero(N.rows(),3));},
-  //  [&F,&W,&FN,&NN,&critical](const int i, const size_t t)
-  //  {
-  //    // throw normal at each corner
-  //    for(int j = 0; j < 3;j++)
-  //    {
-  //      // Q: Does this need to be critical?
-  //      // A: Yes. Different (i,j)'s could produce the same F(i,j)
-  //      NN[t].row(F(i,j)) += W(i,j) * FN.row(i);
-  //    }
-  //  },
-  //  [&N,&NN](const size_t t){ N += NN[t]; },
-  //  1000l);
-
   // take average via normalization
   N.rowwise().normalize();
 }
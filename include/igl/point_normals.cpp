@@ -0,0 +1,83 @@
+// This file is part of libigl, a simple c++ geometry processing library.
+//
+// Copyright (C) 2018 Floor Verhoeven
+//
+// This Source Code Form is subject to the terms of the Mozilla Public License
+// v. 2.0. If a copy of the MPL was not distributed with this file, You can
+// obtain one at http://mozilla.org/MPL/2.0/.
+#include "point_normals.h"
+#include "parallel_for.h"
+#include <Eigen/Eigenvalues>
+#include <cassert>
+#include <limits>
+#include <vector>
+
+template <typename DerivedP, typename DerivedN>
+IGL_INLINE void igl::point_normals(
+  const Eigen::MatrixBase<DerivedP> & P,
+  const int k,
+  Eigen::PlainObjectBase<DerivedN> & N)
+{
+  assert(P.cols() == 3 && "P must be 3D");
+  const igl::KDTree<typename DerivedP::Scalar,3> tree(P);
+  return point_normals(tree,k,N);
+}
+
+template <typename Scalar, typename DerivedN>
+IGL_INLINE void igl::point_normals(
+  const igl::KDTree<Scalar,3> & tree,
+  const int k,
+  Eigen::PlainObjectBase<DerivedN> & N)
+{
+  typedef typename DerivedN::Scalar ScalarN;
+  assert(k >= 3 && "k must be at least 3");
+  const int n = tree.num_points();
+  // Position of each input point in the leaf order of the tree, so that
+  // neighbours are read from the contiguous copy tree.P
+  Eigen::VectorXi J(n);
+  parallel_for(n,[&](const int j){ J(tree.I(j)) = j; },10000);
+  N.resize(n,3);
+  // Neighbour lists of each thread
+  std::vector<std::vector<int> > NI;
+  std::vector<std::vector<Scalar> > sqrD;
+  parallel_for(
+    n,
+    [&](const size_t nt)
+    {
+      NI.resize(nt);
+      sqrD.resize(nt);
+    },
+    [&](const int j, const size_t t)
+    {
+      tree.knn(
+        tree.P.row(j),k,std::numeric_limits<Scalar>::max(),NI[t],sqrD[t]);
+      // Covariance of the neighbourhood about its centroid
+      Eigen::RowVector3d c(0,0,0);
+      for(const int i : NI[t])
+      {
+        c += tree.P.row(J(i)).template cast<double>();
+      }
+      c /= double(NI[t].size());
+      Eigen::Matrix3d C = Eigen::Matrix3d::Zero();
+      for(const int i : NI[t])
+      {
+        const Eigen::RowVector3d d = tree.P.row(J(i)).template cast<double>()-c;
+        C += d.transpose()*d;
+      }
+      // Eigenvalues are sorted in increasing order
+      Eigen::SelfAdjointEigenSolver<Eigen::Matrix3d> es;
+      es.computeDirect(C);
+      N.row(tree.I(j)) =
+        es.eigenvectors().col(0).transpose().template cast<ScalarN>();
+    },
+    [](const size_t){},
+    1000);
+}
+
+#ifdef IGL_STATIC_LIBRARY
+// Explicit template instantiation
+template void igl::point_normals<Eigen::Matrix<double, -1, -1, 0, -1, -1>, Eigen::Matrix<double, -1, -1, 0, -1, -1> >(Eigen::MatrixBase<Eigen::Matrix<double, -1, -1, 0, -1, -1> > const&, int, Eigen::PlainObjectBase<Eigen::Matrix<double, -1, -1, 0, -1, -1> >&);
+template void igl::point_normals<Eigen::Matrix<float, -1, -1, 0, -1, -1>, Eigen::Matrix<float, -1, -1, 0, -1, -1> >(Eigen::MatrixBase<Eigen::Matrix<float, -1, -1, 0, -1, -1> > const&, int, Eigen::PlainObjectBase<Eigen::Matrix<float, -1, -1, 0, -1, -1> >&);
+template void igl::point_normals<double, Eigen::Matrix<double, -1, -1, 0, -1, -1> >(igl::KDTree<double, 3> const&, int, Eigen::PlainObjectBase<Eigen::Matrix<double, -1, -1, 0, -1, -1> >&);
+template void igl::point_normals<float, Eigen::Matrix<float, -1, -1, 0, -1, -1> >(igl::KDTree<float, 3> const&, int, Eigen::PlainObjectBase<Eigen::Matrix<float, -1, -1, 0, -1, -1> >&);
+#endif
@@ -0,0 +1,50 @@
+// This file is part of libigl, a simple c++ geometry processing library.
+//
+// Copyright (C) 2018 Floor Verhoeven
+//
+// This Source Code Form is subject to the terms of the Mozilla Public License
+// v. 2.0. If a copy of the MPL was not distributed with this file, You can
+// obtain one at http://mozilla.org/MPL/2.0/.
+#ifndef IGL_POINT_NORMALS_H
+#define IGL_POINT_NORMALS_H
+#include "igl_inline.h"
+#include "KDTree.h"
+#include <Eigen/Core>
+namespace igl
+{
+  // Estimate normals of a point cloud by principal component analysis of the
+  // k nearest neighbours of each point [Hoppe et al. 1992]: the normal is the
+  // direction of least variance of the neighbourhood. Points are processed in
+  // parallel, in the leaf order of the kd-tree so that neighbouring queries
+  // visit the same leaves.
+  //
+  // Inputs:
+  //   P  #P by 3 list of point positions
+  //   k  number of neighbours, including the point itself (at least 3)
+  // Outputs:
+  //   N  #P by 3 list of unit normals. Normals are not consistently oriented
+  //     (their sign is arbitrary).
+  //
+  // Example:
+  //   igl::KDTree<double,3> tree(P);
+  //   Eigen::MatrixXd N;
+  //   igl::point_normals(tree,10,N);
+  template <typename DerivedP, typename DerivedN>
+  IGL_INLINE void point_normals(
+    const Eigen::MatrixBase<DerivedP> & P,
+    const int k,
+    Eigen::PlainObjectBase<DerivedN> & N);
+  // Inputs:
+  //   tree  kd-tree built on P
+  template <typename Scalar, typename DerivedN>
+  IGL_INLINE void point_normals(
+    const igl::KDTree<Scalar,3> & tree,
+    const int k,
+    Eigen::PlainObjectBase<DerivedN> & N);
+}
+
+#ifndef IGL_STATIC_LIBRARY
+#  include "point_normals.cpp"
+#endif
+
+#endif
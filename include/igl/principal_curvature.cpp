@@ -23,6 +23,9 @@
 #include <igl/per_vertex_normals.h>
 #include <igl/avg_edge_length.h>
 #include <igl/vertex_triangle_adjacency.h>
+#include <igl/parallel_for.h>
+#include <algorithm>
+#include <atomic>
 
 typedef enum
 {
@@ -40,14 +43,29 @@ class CurvatureCalculator
 {
 public:
   /* Row number i represents the i-th vertex, whose columns are:
-   curv[i][0] : K2
-   curv[i][1] : K1
-   curvDir[i][0] : PD1
-   curvDir[i][1] : PD2
+   curv(i,0) : K2
+   curv(i,1) : K1
+   curvDir[0].row(i) : PD1
+   curvDir[1].row(i) : PD2
    */
-  std::vector< std::vector<double> > curv;
-  std::vector< std::vector<Eigen::Vector3d> > curvDir;
+  Eigen::MatrixXd curv;
+  Eigen::MatrixXd curvDir[2];
   bool curvatureComputed;
+  /* Per thread scratch space, reused across vertices */
+  struct Scratch
+  {
+    std::vector<int> vv;
+    std::vector<int> vvtmp;
+    /* Search front, candidates and visit stamps (vertex of the last search
+     that visited each vertex) */
+    std::vector<std::pair<int,int> > queue;
+    std::vector<std::pair<int,double> > candidates;
+    std::vector<int> visited;
+    std::vector<Eigen::Vector3d> points;
+    Eigen::MatrixXd A;
+    Eigen::MatrixXd b;
+    Eigen::JacobiSVD<Eigen::MatrixXd> svd;
+  };
   class Quadric
   {
   public:
@@ -105,7 +123,7 @@ public:
     }
 
 
-    IGL_INLINE static Quadric fit(const std::vector<Eigen::Vector3d> &VV)
+    IGL_INLINE static Quadric fit(const std::vector<Eigen::Vector3d> &VV, Scratch& s)
     {
       assert(VV.size() >= 5);
       if (VV.size() < 5)
@@ -114,9 +132,11 @@ public:
         exit(0);
       }
 
-      Eigen::MatrixXd A(VV.size(),5);
-      Eigen::MatrixXd b(VV.size(),1);
-      Eigen::MatrixXd sol(5,1);
+      Eigen::MatrixXd& A = s.A;
+      Eigen::MatrixXd& b = s.b;
+      A.resize(VV.size(),5);
+      b.resize(VV.size(),1);
+      Eigen::Matrix<double,5,1> sol;
 
       for(unsigned int c=0; c < VV.size(); ++c)
       {
@@ -133,7 +153,7 @@ public:
         b(c) = n;
       }
 
-      sol=A.jacobiSvd(Eigen::ComputeThinU | Eigen::ComputeThinV).solve(b);
+      sol=s.svd.compute(A, Eigen::ComputeThinU | Eigen::ComputeThinV).solve(b);
 
       return Quadric(sol(0),sol(1),sol(2),sol(3),sol(4));
     }
@@ -146,9 +166,11 @@ public:
   // The i-th row contains the indices of the vertices that forms the i-th face in ccw order
   Eigen::MatrixXi faces;
 
-  std::vector<std::vector<int> > vertex_to_vertices;
-  std::vector<std::vector<int> > vertex_to_faces;
-  std::vector<std::vector<int> > vertex_to_faces_index;
+  // Adjacent vertices and incident faces of each vertex in compressed form:
+  // those of vertex i are vertex_to_vertices(VVstart(i):VVstart(i+1)-1) and
+  // vertex_to_faces(VFstart(i):VFstart(i+1)-1)
+  Eigen::VectorXi vertex_to_vertices, VVstart;
+  Eigen::VectorXi vertex_to_faces, VFstart;
   Eigen::MatrixXd face_normals;
   Eigen::MatrixXd vertex_normals;
 
@@ -175,18 +197,26 @@ public:
 
   IGL_INLINE CurvatureCalculator();
   IGL_INLINE void init(const Eigen::MatrixXd& V, const Eigen::MatrixXi& F);
+  // Same as above reusing the adjacency stored in data
+  IGL_INLINE void init(
+    const Eigen::MatrixXd& V,
+    const Eigen::MatrixXi& F,
+    const igl::principal_curvature_data& data);
+  IGL_INLINE void computeNormals();
+  IGL_INLINE void setRadius(unsigned radius, bool useKring);
 
   IGL_INLINE void finalEigenStuff(int, const std::vector<Eigen::Vector3d>&, Quadric&);
-  IGL_INLINE void fitQuadric(const Eigen::Vector3d&, const std::vector<Eigen::Vector3d>& ref, const std::vector<int>& , Quadric *);
+  IGL_INLINE void fitQuadric(const Eigen::Vector3d&, const std::vector<Eigen::Vector3d>& ref, const std::vector<int>& , Quadric *, Scratch&);
   IGL_INLINE void applyProjOnPlane(const Eigen::Vector3d&, const std::vector<int>&, std::vector<int>&);
-  IGL_INLINE void getSphere(const int, const double, std::vector<int>&, int min);
-  IGL_INLINE void getKRing(const int, const double,std::vector<int>&);
+  IGL_INLINE void getSphere(const int, const double, std::vector<int>&, int min, Scratch&);
+  IGL_INLINE void getKRing(const int, const double,std::vector<int>&, Scratch&);
   IGL_INLINE Eigen::Vector3d project(const Eigen::Vector3d&, const Eigen::Vector3d&, const Eigen::Vector3d&);
   IGL_INLINE void computeReferenceFrame(int, const Eigen::Vector3d&, std::vector<Eigen::Vector3d>&);
   IGL_INLINE void getAverageNormal(int, const std::vector<int>&, Eigen::Vector3d&);
   IGL_INLINE void getProjPlane(int, const std::vector<int>&, Eigen::Vector3d&);
   IGL_INLINE void applyMontecarlo(const std::vector<int>&,std::vector<int>*);
-  IGL_INLINE void computeCurvature();
+  IGL_INLINE bool computeNeighborhoods(Eigen::VectorXi& N, Eigen::VectorXi& NI);
+  IGL_INLINE void computeCurvature(const Eigen::VectorXi& N, const Eigen::VectorXi& NI);
   IGL_INLINE void printCurvature(const std::string& outpath);
   IGL_INLINE double getAverageEdge();
 
@@ -325,16 +355,104 @@ IGL_INLINE void CurvatureCalculator::init(const Eigen::MatrixXd& V, const Eigen:
 //  vertices = vertices.array() * (1.0/igl::avg_edge_length(V,F));
 
   faces = F;
-  igl::adjacency_list(F, vertex_to_vertices);
-  igl::vertex_triangle_adjacency(V, F, vertex_to_faces, vertex_to_faces_index);
-  igl::per_face_normals(V, F, face_normals);
-  igl::per_vertex_normals(V, F, face_normals, vertex_normals);
+  igl::adjacency_list(F, vertex_to_vertices, VVstart);
+  igl::vertex_triangle_adjacency(F, V.rows(), vertex_to_faces, VFstart);
+  computeNormals();
+}
+
+IGL_INLINE void CurvatureCalculator::init(
+  const Eigen::MatrixXd& V,
+  const Eigen::MatrixXi& F,
+  const igl::principal_curvature_data& data)
+{
+  vertices = V;
+  faces = F;
+  vertex_to_vertices = data.vertex_to_vertices;
+  VVstart = data.VVstart;
+  vertex_to_faces = data.vertex_to_faces;
+  VFstart = data.VFstart;
+  computeNormals();
+}
+
+IGL_INLINE void CurvatureCalculator::computeNormals()
+{
+  igl::per_face_normals(vertices, faces, face_normals);
+  igl::per_vertex_normals(vertices, faces, face_normals, vertex_normals);
+}
+
+IGL_INLINE void CurvatureCalculator::setRadius(unsigned radius, bool useKring)
+{
+  if (radius < 2)
+  {
+    radius = 2;
+    std::cout << "WARNING: igl::principal_curvature needs a radius >= 2, fixing it to 2." << std::endl;
+  }
+  sphereRadius = radius;
+  if (useKring)
+  {
+    kRing = radius;
+    st = K_RING_SEARCH;
+  }
 }
 
-IGL_INLINE void CurvatureCalculator::fitQuadric(const Eigen::Vector3d& v, const std::vector<Eigen::Vector3d>& ref, const std::vector<int>& vv, Quadric *q)
+namespace igl
 {
-  std::vector<Eigen::Vector3d> points;
-  points.reserve (vv.size());
+  namespace principal_curvature_helpers
+  {
+    // Copy the curvature computed by cc to the outputs of principal_curvature
+    template <
+      typename DerivedPD1,
+      typename DerivedPD2,
+      typename DerivedPV1,
+      typename DerivedPV2>
+    IGL_INLINE void copy_curvature(
+      const CurvatureCalculator & cc,
+      Eigen::PlainObjectBase<DerivedPD1>& PD1,
+      Eigen::PlainObjectBase<DerivedPD2>& PD2,
+      Eigen::PlainObjectBase<DerivedPV1>& PV1,
+      Eigen::PlainObjectBase<DerivedPV2>& PV2)
+    {
+      const int n = cc.vertices.rows();
+      // Preallocate memory
+      PD1.resize(n,3);
+      PD2.resize(n,3);
+
+      // Preallocate memory
+      PV1.resize(n,1);
+      PV2.resize(n,1);
+
+      // Copy it back
+      for (int i=0; i<n; ++i)
+      {
+        PD1.row(i) = cc.curvDir[0].row(i).template cast<typename DerivedPD1::Scalar>();
+        PD2.row(i) = cc.curvDir[1].row(i).template cast<typename DerivedPD2::Scalar>();
+        PD1.row(i).normalize();
+        PD2.row(i).normalize();
+
+        if (std::isnan(PD1(i,0)) || std::isnan(PD1(i,1)) || std::isnan(PD1(i,2)) || std::isnan(PD2(i,0)) || std::isnan(PD2(i,1)) || std::isnan(PD2(i,2)))
+        {
+          PD1.row(i) << 0,0,0;
+          PD2.row(i) << 0,0,0;
+        }
+
+        PV1(i) = cc.curv(i,0);
+        PV2(i) = cc.curv(i,1);
+
+        if (PD1.row(i) * PD2.row(i).transpose() > 10e-6)
+        {
+          std::cerr << "PRINCIPAL_CURVATURE: Something is wrong with vertex: " << i << std::endl;
+          PD1.row(i) *= 0;
+          PD2.row(i) *= 0;
+        }
+      }
+    }
+  }
+}
+
+IGL_INLINE void CurvatureCalculator::fitQuadric(const Eigen::Vector3d& v, const std::vector<Eigen::Vector3d>& ref, const std::vector<int>& vv, Quadric *q, Scratch& s)
+{
+  std::vector<Eigen::Vector3d>& points = s.points;
+  points.clear();
 
   for (unsigned int i = 0; i < vv.size(); ++i) {
 
@@ -355,7 +473,7 @@ IGL_INLINE void CurvatureCalculator::fitQuadric(const Eigen::Vector3d& v, const
   }
   else
   {
-    *q = Quadric::fit (points);
+    *q = Quadric::fit (points, s);
   }
 }
 
@@ -424,107 +542,103 @@ IGL_INLINE void CurvatureCalculator::finalEigenStuff(int i, const std::vector<Ei
 
   if (c_val[0] > c_val[1])
   {
-    curv[i]=std::vector<double>(2);
-    curv[i][0]=c_val(1);
-    curv[i][1]=c_val(0);
-    curvDir[i]=std::vector<Eigen::Vector3d>(2);
-    curvDir[i][0]=v2global;
-    curvDir[i][1]=v1global;
+    curv(i,0)=c_val(1);
+    curv(i,1)=c_val(0);
+    curvDir[0].row(i)=v2global;
+    curvDir[1].row(i)=v1global;
   }
   else
   {
-    curv[i]=std::vector<double>(2);
-    curv[i][0]=c_val(0);
-    curv[i][1]=c_val(1);
-    curvDir[i]=std::vector<Eigen::Vector3d>(2);
-    curvDir[i][0]=v1global;
-    curvDir[i][1]=v2global;
+    curv(i,0)=c_val(0);
+    curv(i,1)=c_val(1);
+    curvDir[0].row(i)=v1global;
+    curvDir[1].row(i)=v2global;
   }
   // ---- end Eigen stuff
 }
 
-IGL_INLINE void CurvatureCalculator::getKRing(const int start, const double r, std::vector<int>&vv)
+IGL_INLINE void CurvatureCalculator::getKRing(const int start, const double r, std::vector<int>&vv, Scratch& s)
 {
-  int bufsize=vertices.rows();
-  vv.reserve(bufsize);
-  std::list<std::pair<int,int> > queue;
-  bool* visited = (bool*)calloc(bufsize,sizeof(bool));
+  std::vector<std::pair<int,int> >& queue = s.queue;
+  std::vector<int>& visited = s.visited;
+  visited.resize(vertices.rows(),-1);
+  queue.clear();
   queue.push_back(std::pair<int,int>(start,0));
-  visited[start]=true;
-  while (!queue.empty())
+  visited[start]=start;
+  for (size_t front=0; front<queue.size(); ++front)
   {
-    int toVisit=queue.front().first;
-    int distance=queue.front().second;
-    queue.pop_front();
+    int toVisit=queue[front].first;
+    int distance=queue[front].second;
     vv.push_back(toVisit);
     if (distance<(int)r)
     {
-      for (unsigned int i=0; i<vertex_to_vertices[toVisit].size(); ++i)
+      for (int i=VVstart(toVisit); i<VVstart(toVisit+1); ++i)
       {
-        int neighbor=vertex_to_vertices[toVisit][i];
-        if (!visited[neighbor])
+        int neighbor=vertex_to_vertices(i);
+        if (visited[neighbor]!=start)
         {
           queue.push_back(std::pair<int,int> (neighbor,distance+1));
-          visited[neighbor]=true;
+          visited[neighbor]=start;
         }
       }
     }
   }
-  free(visited);
-  return;
 }
 
 
-IGL_INLINE void CurvatureCalculator::getSphere(const int start, const double r, std::vector<int> &vv, int min)
+IGL_INLINE void CurvatureCalculator::getSphere(const int start, const double r, std::vector<int> &vv, int min, Scratch& s)
 {
-  int bufsize=vertices.rows();
-  vv.reserve(bufsize);
-  std::list<int>* queue= new std::list<int>();
-  bool* visited = (bool*)calloc(bufsize,sizeof(bool));
-  queue->push_back(start);
-  visited[start]=true;
+  std::vector<std::pair<int,int> >& queue = s.queue;
+  std::vector<int>& visited = s.visited;
+  visited.resize(vertices.rows(),-1);
+  queue.clear();
+  queue.push_back(std::pair<int,int>(start,0));
+  visited[start]=start;
   Eigen::Vector3d me=vertices.row(start);
-  std::priority_queue<std::pair<int, double>, std::vector<std::pair<int, double> >, comparer >* extra_candidates= new  std::priority_queue<std::pair<int, double>, std::vector<std::pair<int, double> >, comparer >();
-  while (!queue->empty())
+  /* Min-heap of candidates outside the sphere by distance */
+  std::vector<std::pair<int, double> >& extra_candidates = s.candidates;
+  extra_candidates.clear();
+  for (size_t front=0; front<queue.size(); ++front)
   {
-    int toVisit=queue->front();
-    queue->pop_front();
+    int toVisit=queue[front].first;
     vv.push_back(toVisit);
-    for (unsigned int i=0; i<vertex_to_vertices[toVisit].size(); ++i)
+    for (int i=VVstart(toVisit); i<VVstart(toVisit+1); ++i)
     {
-      int neighbor=vertex_to_vertices[toVisit][i];
-      if (!visited[neighbor])
+      int neighbor=vertex_to_vertices(i);
+      if (visited[neighbor]!=start)
       {
         Eigen::Vector3d neigh=vertices.row(neighbor);
         double distance=(me-neigh).norm();
         if (distance<r)
-          queue->push_back(neighbor);
+          queue.push_back(std::pair<int,int>(neighbor,0));
         else if ((int)vv.size()<min)
-          extra_candidates->push(std::pair<int,double>(neighbor,distance));
-        visited[neighbor]=true;
+        {
+          extra_candidates.push_back(std::pair<int,double>(neighbor,distance));
+          std::push_heap(extra_candidates.begin(),extra_candidates.end(),comparer());
+        }
+        visited[neighbor]=start;
       }
     }
   }
-  while (!extra_candidates->empty() && (int)vv.size()<min)
+  while (!extra_candidates.empty() && (int)vv.size()<min)
   {
-    std::pair<int, double> cand=extra_candidates->top();
-    extra_candidates->pop();
+    std::pop_heap(extra_candidates.begin(),extra_candidates.end(),comparer());
+    std::pair<int, double> cand=extra_candidates.back();
+    extra_candidates.pop_back();
     vv.push_back(cand.first);
-    for (unsigned int i=0; i<vertex_to_vertices[cand.first].size(); ++i)
+    for (int i=VVstart(cand.first); i<VVstart(cand.first+1); ++i)
     {
-      int neighbor=vertex_to_vertices[cand.first][i];
-      if (!visited[neighbor])
+      int neighbor=vertex_to_vertices(i);
+      if (visited[neighbor]!=start)
       {
         Eigen::Vector3d neigh=vertices.row(neighbor);
         double distance=(me-neigh).norm();
-        extra_candidates->push(std::pair<int,double>(neighbor,distance));
-        visited[neighbor]=true;
+        extra_candidates.push_back(std::pair<int,double>(neighbor,distance));
+        std::push_heap(extra_candidates.begin(),extra_candidates.end(),comparer());
+        visited[neighbor]=start;
       }
     }
   }
-  free(extra_candidates);
-  free(queue);
-  free(visited);
 }
 
 IGL_INLINE Eigen::Vector3d CurvatureCalculator::project(const Eigen::Vector3d& v, const Eigen::Vector3d& vp, const Eigen::Vector3d& ppn)
@@ -535,7 +649,7 @@ IGL_INLINE Eigen::Vector3d CurvatureCalculator::project(const Eigen::Vector3d& v
 IGL_INLINE void CurvatureCalculator::computeReferenceFrame(int i, const Eigen::Vector3d& normal, std::vector<Eigen::Vector3d>& ref )
 {
 
-  Eigen::Vector3d longest_v=Eigen::Vector3d(vertices.row(vertex_to_vertices[i][0]));
+  Eigen::Vector3d longest_v=Eigen::Vector3d(vertices.row(vertex_to_vertices(VVstart(i))));
 
   longest_v=(project(vertices.row(i),longest_v,normal)-Eigen::Vector3d(vertices.row(i))).normalized();
 
@@ -571,9 +685,9 @@ IGL_INLINE void CurvatureCalculator::getProjPlane(int j, const std::vector<int>&
 
   if (localMode)
   {
-    for (unsigned int i=0; i<vertex_to_faces.at(j).size(); ++i)
+    for (int i=VFstart(j); i<VFstart(j+1); ++i)
     {
-      Eigen::Vector3d faceNormal=face_normals.row(vertex_to_faces.at(j).at(i));
+      Eigen::Vector3d faceNormal=face_normals.row(vertex_to_faces(i));
       a += faceNormal[0];
       b += faceNormal[1];
       c += faceNormal[2];
@@ -650,97 +764,135 @@ IGL_INLINE void CurvatureCalculator::applyMontecarlo(const std::vector<int>& vin
   }
 }
 
-IGL_INLINE void CurvatureCalculator::computeCurvature()
+IGL_INLINE bool CurvatureCalculator::computeNeighborhoods(Eigen::VectorXi& N, Eigen::VectorXi& NI)
 {
-  //CHECK che esista la mesh
-  const size_t vertices_count=vertices.rows();
-
+  const int vertices_count=vertices.rows();
+  NI.setZero(vertices_count+1);
+  N.resize(0);
   if (vertices_count ==0)
-    return;
-
-  curvDir=std::vector< std::vector<Eigen::Vector3d> >(vertices_count);
-  curv=std::vector<std::vector<double> >(vertices_count);
+    return true;
 
+  scaledRadius=getAverageEdge()*sphereRadius;
 
+  // Gather chunks of consecutive vertices in parallel, then concatenate
+  const int chunk=1000;
+  const int nchunks=(vertices_count+chunk-1)/chunk;
+  std::vector<std::vector<int> > NC(nchunks);
+  std::vector<Scratch> scratch;
+  std::atomic<bool> valid(true);
+  igl::parallel_for(nchunks,
+    [&scratch](const size_t nt){ scratch.resize(nt); },
+    [&](const int c, const size_t t)
+    {
+      Scratch& s = scratch[t];
+      for (int i=c*chunk; i<std::min((c+1)*chunk,vertices_count); ++i)
+      {
+        s.vv.clear();
+        switch (st)
+        {
+          case SPHERE_SEARCH:
+            getSphere(i,scaledRadius,s.vv,6,s);
+            break;
+          case K_RING_SEARCH:
+            getKRing(i,kRing,s.vv,s);
+            break;
+        }
+        if (s.vv.size()<6)
+          valid=false;
+        NC[c].insert(NC[c].end(),s.vv.begin(),s.vv.end());
+        NI(i+1)=s.vv.size();
+      }
+    },
+    [](const size_t){},
+    1);
+  for (int i=0; i<vertices_count; ++i)
+    NI(i+1)+=NI(i);
+  N.resize(NI(vertices_count));
+  igl::parallel_for(nchunks,[&](const int c)
+  {
+    std::copy(NC[c].begin(),NC[c].end(),N.data()+NI(c*chunk));
+    std::vector<int>().swap(NC[c]);
+  },1);
+  if (!valid)
+  {
+    std::cerr << "Could not compute curvature of radius " << scaledRadius << std::endl;
+    return false;
+  }
+  return true;
+}
 
-  scaledRadius=getAverageEdge()*sphereRadius;
+IGL_INLINE void CurvatureCalculator::computeCurvature(const Eigen::VectorXi& N, const Eigen::VectorXi& NI)
+{
+  //CHECK che esista la mesh
+  const int vertices_count=vertices.rows();
 
-  std::vector<int> vv;
-  std::vector<int> vvtmp;
-  Eigen::Vector3d normal;
+  // Vertices whose curvature cannot be computed are left to zero
+  curvDir[0].setZero(vertices_count,3);
+  curvDir[1].setZero(vertices_count,3);
+  curv.setZero(vertices_count,2);
 
-  //double time_spent;
-  //double searchtime=0, ref_time=0, fit_time=0, final_time=0;
+  if (vertices_count ==0)
+    return;
 
-  for (size_t i=0; i<vertices_count; ++i)
-  {
-    vv.clear();
-    vvtmp.clear();
-    Eigen::Vector3d me=vertices.row(i);
-    switch (st)
+  // Vertices with too small neighborhoods were reported when gathering them
+  std::vector<Scratch> scratch;
+  igl::parallel_for(vertices_count,
+    [&scratch](const size_t nt){ scratch.resize(nt); },
+    [&](const int i, const size_t t)
     {
-      case SPHERE_SEARCH:
-        getSphere(i,scaledRadius,vv,6);
-        break;
-      case K_RING_SEARCH:
-        getKRing(i,kRing,vv);
-        break;
-      default:
-        fprintf(stderr,"Error: search type not recognized");
+      Scratch& s = scratch[t];
+      std::vector<int>& vv = s.vv;
+      std::vector<int>& vvtmp = s.vvtmp;
+      Eigen::Vector3d normal;
+      vv.assign(N.data()+NI(i),N.data()+NI(i+1));
+      vvtmp.clear();
+      Eigen::Vector3d me=vertices.row(i);
+
+      if (vv.size()<6)
         return;
-    }
-
-    if (vv.size()<6)
-    {
-      std::cerr << "Could not compute curvature of radius " << scaledRadius << std::endl;
-      return;
-    }
 
 
-    if (projectionPlaneCheck)
-    {
-      vvtmp.reserve (vv.size ());
-      applyProjOnPlane (vertex_normals.row(i), vv, vvtmp);
-      if (vvtmp.size() >= 6 && vvtmp.size()<vv.size())
-        vv = vvtmp;
-    }
+      if (projectionPlaneCheck)
+      {
+        vvtmp.reserve (vv.size ());
+        applyProjOnPlane (vertex_normals.row(i), vv, vvtmp);
+        if (vvtmp.size() >= 6 && vvtmp.size()<vv.size())
+          vv.swap(vvtmp);
+      }
 
 
-    switch (nt)
-    {
-      case AVERAGE:
-        getAverageNormal(i,vv,normal);
-        break;
-      case PROJ_PLANE:
-        getProjPlane(i,vv,normal);
-        break;
-      default:
-        fprintf(stderr,"Error: normal type not recognized");
+      switch (nt)
+      {
+        case AVERAGE:
+          getAverageNormal(i,vv,normal);
+          break;
+        case PROJ_PLANE:
+          getProjPlane(i,vv,normal);
+          break;
+      }
+      if (vv.size()<6)
         return;
-    }
-    if (vv.size()<6)
-    {
-      std::cerr << "Could not compute curvature of radius " << scaledRadius << std::endl;
-      return;
-    }
-    if (montecarlo)
-    {
-      if(montecarloN<6)
-        break;
-      vvtmp.reserve(vv.size());
-      applyMontecarlo(vv,&vvtmp);
-      vv=vvtmp;
-    }
+      if (montecarlo)
+      {
+        if(montecarloN<6)
+          return;
+        vvtmp.clear();
+        vvtmp.reserve(vv.size());
+        applyMontecarlo(vv,&vvtmp);
+        vv.swap(vvtmp);
+      }
 
-    if (vv.size()<6)
-      return;
-    std::vector<Eigen::Vector3d> ref(3);
-    computeReferenceFrame(i,normal,ref);
+      if (vv.size()<6)
+        return;
+      std::vector<Eigen::Vector3d> ref(3);
+      computeReferenceFrame(i,normal,ref);
 
-    Quadric q;
-    fitQuadric (me, ref, vv, &q);
-    finalEigenStuff(i,ref,q);
-  }
+      Quadric q;
+      fitQuadric (me, ref, vv, &q, s);
+      finalEigenStuff(i,ref,q);
+    },
+    [](const size_t){},
+    100);
 
   lastRadius=sphereRadius;
   curvatureComputed=true;
@@ -765,14 +917,34 @@ IGL_INLINE void CurvatureCalculator::printCurvature(const std::string& outpath)
   of << vertices_count << endl;
   for (int i=0; i<vertices_count; ++i)
   {
-    of << curv[i][0] << " " << curv[i][1] << " " << curvDir[i][0][0] << " " << curvDir[i][0][1] << " " << curvDir[i][0][2] << " " <<
-    curvDir[i][1][0] << " " << curvDir[i][1][1] << " " << curvDir[i][1][2] << endl;
+    of << curv(i,0) << " " << curv(i,1) << " " << curvDir[0](i,0) << " " << curvDir[0](i,1) << " " << curvDir[0](i,2) << " " <<
+    curvDir[1](i,0) << " " << curvDir[1](i,1) << " " << curvDir[1](i,2) << endl;
   }
 
   of.close();
 
 }
 
+template <typename DerivedV, typename DerivedF>
+IGL_INLINE bool igl::principal_curvature_precompute(
+  const Eigen::PlainObjectBase<DerivedV>& V,
+  const Eigen::PlainObjectBase<DerivedF>& F,
+  principal_curvature_data& data,
+  unsigned radius,
+  bool useKring)
+{
+  CurvatureCalculator cc;
+  cc.init(V.template cast<double>(),F.template cast<int>());
+  cc.setRadius(radius,useKring);
+
+  const bool ok = cc.computeNeighborhoods(data.N,data.NI);
+  data.vertex_to_vertices.swap(cc.vertex_to_vertices);
+  data.VVstart.swap(cc.VVstart);
+  data.vertex_to_faces.swap(cc.vertex_to_faces);
+  data.VFstart.swap(cc.VFstart);
+  return ok;
+}
+
 template <
   typename DerivedV,
   typename DerivedF,
@@ -783,66 +955,51 @@ template <
 IGL_INLINE void igl::principal_curvature(
   const Eigen::PlainObjectBase<DerivedV>& V,
   const Eigen::PlainObjectBase<DerivedF>& F,
+  const principal_curvature_data& data,
   Eigen::PlainObjectBase<DerivedPD1>& PD1,
   Eigen::PlainObjectBase<DerivedPD2>& PD2,
   Eigen::PlainObjectBase<DerivedPV1>& PV1,
-  Eigen::PlainObjectBase<DerivedPV2>& PV2,
-  unsigned radius,
-  bool useKring)
+  Eigen::PlainObjectBase<DerivedPV2>& PV2)
 {
-  if (radius < 2)
-  {
-    radius = 2;
-    std::cout << "WARNING: igl::principal_curvature needs a radius >= 2, fixing it to 2." << std::endl;
-  }
-
-  // Preallocate memory
-  PD1.resize(V.rows(),3);
-  PD2.resize(V.rows(),3);
+  assert(data.NI.size() == V.rows()+1 && "data must be precomputed for V");
+  assert(data.VVstart.size() == V.rows()+1 && "data must be precomputed for V");
 
-  // Preallocate memory
-  PV1.resize(V.rows(),1);
-  PV2.resize(V.rows(),1);
-
-  // Precomputation
+  // Only the normals depend on V
   CurvatureCalculator cc;
-  cc.init(V.template cast<double>(),F.template cast<int>());
-  cc.sphereRadius = radius;
-
-  if (useKring)
-  {
-    cc.kRing = radius;
-    cc.st = K_RING_SEARCH;
-  }
+  cc.init(V.template cast<double>(),F.template cast<int>(),data);
 
   // Compute
-  cc.computeCurvature();
-
-  // Copy it back
-  for (unsigned i=0; i<V.rows(); ++i)
-  {
-    PD1.row(i) << cc.curvDir[i][0][0], cc.curvDir[i][0][1], cc.curvDir[i][0][2];
-    PD2.row(i) << cc.curvDir[i][1][0], cc.curvDir[i][1][1], cc.curvDir[i][1][2];
-    PD1.row(i).normalize();
-    PD2.row(i).normalize();
-
-    if (std::isnan(PD1(i,0)) || std::isnan(PD1(i,1)) || std::isnan(PD1(i,2)) || std::isnan(PD2(i,0)) || std::isnan(PD2(i,1)) || std::isnan(PD2(i,2)))
-    {
-      PD1.row(i) << 0,0,0;
-      PD2.row(i) << 0,0,0;
-    }
-
-    PV1(i) = cc.curv[i][0];
-    PV2(i) = cc.curv[i][1];
+  cc.computeCurvature(data.N,data.NI);
+  principal_curvature_helpers::copy_curvature(cc,PD1,PD2,PV1,PV2);
+}
 
-    if (PD1.row(i) * PD2.row(i).transpose() > 10e-6)
-    {
-      std::cerr << "PRINCIPAL_CURVATURE: Something is wrong with vertex: " << i << std::endl;
-      PD1.row(i) *= 0;
-      PD2.row(i) *= 0;
-    }
-  }
+template <
+  typename DerivedV,
+  typename DerivedF,
+  typename DerivedPD1,
+  typename DerivedPD2,
+  typename DerivedPV1,
+  typename DerivedPV2>
+IGL_INLINE void igl::principal_curvature(
+  const Eigen::PlainObjectBase<DerivedV>& V,
+  const Eigen::PlainObjectBase<DerivedF>& F,
+  Eigen::PlainObjectBase<DerivedPD1>& PD1,
+  Eigen::PlainObjectBase<DerivedPD2>& PD2,
+  Eigen::PlainObjectBase<DerivedPV1>& PV1,
+  Eigen::PlainObjectBase<DerivedPV2>& PV2,
+  unsigned radius,
+  bool useKring)
+{
+  // Same as precompute followed by the fit, without building the adjacency
+  // and normals twice
+  CurvatureCalculator cc;
+  cc.init(V.template cast<double>(),F.template cast<int>());
+  cc.setRadius(radius,useKring);
 
+  Eigen::VectorXi N,NI;
+  cc.computeNeighborhoods(N,NI);
+  cc.computeCurvature(N,NI);
+  principal_curvature_helpers::copy_curvature(cc,PD1,PD2,PV1,PV2);
 }
 
 #ifdef IGL_STATIC_LIBRARY
@@ -851,4 +1008,8 @@ IGL_INLINE void igl::principal_curvature(
 template void igl::principal_curvature<Eigen::Matrix<double, -1, -1, 0, -1, -1>, Eigen::Matrix<int, -1, -1, 0, -1, -1>, Eigen::Matrix<double, -1, -1, 0, -1, -1>, Eigen::Matrix<double, -1, -1, 0, -1, -1>, Eigen::Matrix<double, -1, 1, 0, -1, 1>, Eigen::Matrix<double, -1, 1, 0, -1, 1> >(Eigen::PlainObjectBase<Eigen::Matrix<double, -1, -1, 0, -1, -1> > const&, Eigen::PlainObjectBase<Eigen::Matrix<int, -1, -1, 0, -1, -1> > const&, Eigen::PlainObjectBase<Eigen::Matrix<double, -1, -1, 0, -1, -1> >&, Eigen::PlainObjectBase<Eigen::Matrix<double, -1, -1, 0, -1, -1> >&, Eigen::PlainObjectBase<Eigen::Matrix<double, -1, 1, 0, -1, 1> >&, Eigen::PlainObjectBase<Eigen::Matrix<double, -1, 1, 0, -1, 1> >&, unsigned int, bool);
 template void igl::principal_curvature<Eigen::Matrix<double, -1, 3, 0, -1, 3>, Eigen::Matrix<int, -1, 3, 0, -1, 3>, Eigen::Matrix<double, -1, 3, 0, -1, 3>, Eigen::Matrix<double, -1, 3, 0, -1, 3>, Eigen::Matrix<double, -1, 1, 0, -1, 1>, Eigen::Matrix<double, -1, 1, 0, -1, 1> >(Eigen::PlainObjectBase<Eigen::Matrix<double, -1, 3, 0, -1, 3> > const&, Eigen::PlainObjectBase<Eigen::Matrix<int, -1, 3, 0, -1, 3> > const&, Eigen::PlainObjectBase<Eigen::Matrix<double, -1, 3, 0, -1, 3> >&, Eigen::PlainObjectBase<Eigen::Matrix<double, -1, 3, 0, -1, 3> >&, Eigen::PlainObjectBase<Eigen::Matrix<double, -1, 1, 0, -1, 1> >&, Eigen::PlainObjectBase<Eigen::Matrix<double, -1, 1, 0, -1, 1> >&, unsigned int, bool);
 template void igl::principal_curvature<Eigen::Matrix<double, -1, -1, 0, -1, -1>, Eigen::Matrix<int, -1, -1, 0, -1, -1>, Eigen::Matrix<double, -1, -1, 0, -1, -1>, Eigen::Matrix<double, -1, -1, 0, -1, -1>, Eigen::Matrix<double, -1, -1, 0, -1, -1>, Eigen::Matrix<double, -1, -1, 0, -1, -1> >(Eigen::PlainObjectBase<Eigen::Matrix<double, -1, -1, 0, -1, -1> > const&, Eigen::PlainObjectBase<Eigen::Matrix<int, -1, -1, 0, -1, -1> > const&, Eigen::PlainObjectBase<Eigen::Matrix<double, -1, -1, 0, -1, -1> >&, Eigen::PlainObjectBase<Eigen::Matrix<double, -1, -1, 0, -1, -1> >&, Eigen::PlainObjectBase<Eigen::Matrix<double, -1, -1, 0, -1, -1> >&, Eigen::PlainObjectBase<Eigen::Matrix<double, -1, -1, 0, -1, -1> >&, unsigned int, bool);
+template bool igl::principal_curvature_precompute<Eigen::Matrix<double, -1, -1, 0, -1, -1>, Eigen::Matrix<int, -1, -1, 0, -1, -1> >(Eigen::PlainObjectBase<Eigen::Matrix<double, -1, -1, 0, -1, -1> > const&, Eigen::PlainObjectBase<Eigen::Matrix<int, -1, -1, 0, -1, -1> > const&, igl::principal_curvature_data&, unsigned int, bool);
+template bool igl::principal_curvature_precompute<Eigen::Matrix<double, -1, 3, 0, -1, 3>, Eigen::Matrix<int, -1, 3, 0, -1, 3> >(Eigen::PlainObjectBase<Eigen::Matrix<double, -1, 3, 0, -1, 3> > const&, Eigen::PlainObjectBase<Eigen::Matrix<int, -1, 3, 0, -1, 3> > const&, igl::principal_curvature_data&, unsigned int, bool);
+template void igl::principal_curvature<Eigen::Matrix<double, -1, -1, 0, -1, -1>, Eigen::Matrix<int, -1, -1, 0, -1, -1>, Eigen::Matrix<double, -1, -1, 0, -1, -1>, Eigen::Matrix<double, -1, -1, 0, -1, -1>, Eigen::Matrix<double, -1, 1, 0, -1, 1>, Eigen::Matrix<double, -1, 1, 0, -1, 1> >(Eigen::PlainObjectBase<Eigen::Matrix<double, -1, -1, 0, -1, -1> > const&, Eigen::PlainObjectBase<Eigen::Matrix<int, -1, -1, 0, -1, -1> > const&, igl::principal_curvature_data const&, Eigen::PlainObjectBase<Eigen::Matrix<double, -1, -1, 0, -1, -1> >&, Eigen::PlainObjectBase<Eigen::Matrix<double, -1, -1, 0, -1, -1> >&, Eigen::PlainObjectBase<Eigen::Matrix<double, -1, 1, 0, -1, 1> >&, Eigen::PlainObjectBase<Eigen::Matrix<double, -1, 1, 0, -1, 1> >&);
+template void igl::principal_curvature<Eigen::Matrix<double, -1, 3, 0, -1, 3>, Eigen::Matrix<int, -1, 3, 0, -1, 3>, Eigen::Matrix<double, -1, 3, 0, -1, 3>, Eigen::Matrix<double, -1, 3, 0, -1, 3>, Eigen::Matrix<double, -1, 1, 0, -1, 1>, Eigen::Matrix<double, -1, 1, 0, -1, 1> >(Eigen::PlainObjectBase<Eigen::Matrix<double, -1, 3, 0, -1, 3> > const&, Eigen::PlainObjectBase<Eigen::Matrix<int, -1, 3, 0, -1, 3> > const&, igl::principal_curvature_data const&, Eigen::PlainObjectBase<Eigen::Matrix<double, -1, 3, 0, -1, 3> >&, Eigen::PlainObjectBase<Eigen::Matrix<double, -1, 3, 0, -1, 3> >&, Eigen::PlainObjectBase<Eigen::Matrix<double, -1, 1, 0, -1, 1> >&, Eigen::PlainObjectBase<Eigen::Matrix<double, -1, 1, 0, -1, 1> >&);
 #endif
@@ -21,6 +21,20 @@
 namespace igl
 {
 
+  // Neighborhoods used to fit the quadric of each vertex, in compressed form:
+  // those of vertex i are N(NI(i):NI(i+1)-1). They only depend on the
+  // connectivity for k-ring search, and are frozen at the precomputed
+  // geometry for sphere search. The adjacent vertices and incident faces of
+  // vertex i are vertex_to_vertices(VVstart(i):VVstart(i+1)-1) and
+  // vertex_to_faces(VFstart(i):VFstart(i+1)-1), so that only the normals
+  // are recomputed for new vertex positions.
+  struct principal_curvature_data
+  {
+    Eigen::VectorXi N, NI;
+    Eigen::VectorXi vertex_to_vertices, VVstart;
+    Eigen::VectorXi vertex_to_faces, VFstart;
+  };
+
   // Compute the principal curvature directions and magnitude of the given triangle mesh
   //   DerivedV derived from vertex positions matrix type: i.e. MatrixXd
   //   DerivedF derived from face indices matrix type: i.e. MatrixXi
@@ -35,6 +49,9 @@ namespace igl
   //   PV1 #V by 1 maximal curvature value for each vertex.
   //   PV2 #V by 1 minimal curvature value for each vertex.
   //
+  // Vertices are processed in parallel. Those with fewer than 6 vertices in
+  // their neighbourhood get zero curvature and directions.
+  //
   // See also: average_onto_faces, average_onto_vertices
   //
   // This function has been developed by: Nikolas De Giorgis, Luigi Rocca and Enrico Puppo.
@@ -58,6 +75,46 @@ IGL_INLINE void principal_curvature(
   Eigen::PlainObjectBase<DerivedPV2>& PV2,
   unsigned radius = 5,
   bool useKring = true);
+  // Gather the neighbourhoods of all vertices (in parallel), to compute the
+  // curvature of several deformations of the same mesh without gathering
+  // them again
+  //
+  // Inputs:
+  //   V  #V by 3 list of vertex positions
+  //   F  #F by 3 list of mesh faces (must be triangles)
+  //   radius  controls the size of the neighbourhood used, 1 = average edge length
+  //   useKring  whether to use k-ring (or sphere) search
+  // Outputs:
+  //   data  neighborhoods of all vertices
+  // Returns false if some neighbourhoods have fewer than 6 vertices
+template <typename DerivedV, typename DerivedF>
+IGL_INLINE bool principal_curvature_precompute(
+  const Eigen::PlainObjectBase<DerivedV>& V,
+  const Eigen::PlainObjectBase<DerivedF>& F,
+  principal_curvature_data& data,
+  unsigned radius = 5,
+  bool useKring = true);
+  // Same as above using precomputed neighbourhoods
+  //
+  // Inputs:
+  //   V  #V by 3 list of (possibly deformed) vertex positions
+  //   F  #F by 3 list of mesh faces, as passed to principal_curvature_precompute
+  //   data  neighbourhoods from principal_curvature_precompute
+template <
+  typename DerivedV, 
+  typename DerivedF,
+  typename DerivedPD1, 
+  typename DerivedPD2, 
+  typename DerivedPV1, 
+  typename DerivedPV2>
+IGL_INLINE void principal_curvature(
+  const Eigen::PlainObjectBase<DerivedV>& V,
+  const Eigen::PlainObjectBase<DerivedF>& F,
+  const principal_curvature_data& data,
+  Eigen::PlainObjectBase<DerivedPD1>& PD1,
+  Eigen::PlainObjectBase<DerivedPD2>& PD2,
+  Eigen::PlainObjectBase<DerivedPV1>& PV1,
+  Eigen::PlainObjectBase<DerivedPV2>& PV2);
 }
 
 
@@ -6,11 +6,83 @@
 // v. 2.0. If a copy of the MPL was not distributed with this file, You can 
 // obtain one at http://mozilla.org/MPL/2.0/.
 #include "remove_duplicate_vertices.h"
-#include "round.h"
-#include "unique_rows.h"
-#include "colon.h"
-#include "slice.h"
-#include <functional>
+#include "parallel_for.h"
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <thread>
+#include <vector>
+
+namespace igl
+{
+  namespace remove_duplicate_vertices_helpers
+  {
+    // Mix a cell coordinate into a hash
+    inline uint64_t hash_combine(const uint64_t h, const int64_t c)
+    {
+      return h ^ (uint64_t(c) + 0x9e3779b97f4a7c15ULL + (h<<6) + (h>>2));
+    }
+    // Spread the bits of a hash (murmur3 finalizer)
+    inline uint64_t hash_finalize(uint64_t h)
+    {
+      h ^= h>>33;
+      h *= 0xff51afd7ed558ccdULL;
+      h ^= h>>33;
+      h *= 0xc4ceb9fe1a85ec53ULL;
+      h ^= h>>33;
+      return h;
+    }
+    // Root of p in a union-find forest, halving the path on the way
+    inline int find(std::vector<std::atomic<int> > & P, int p)
+    {
+      while(true)
+      {
+        int q = P[p].load(std::memory_order_relaxed);
+        if(q == p)
+        {
+          return p;
+        }
+        const int r = P[q].load(std::memory_order_relaxed);
+        if(r != q)
+        {
+          // Grandparent is still an ancestor (possibly stale, then a no-op)
+          P[p].compare_exchange_weak(q,r,std::memory_order_relaxed);
+        }
+        p = r;
+      }
+    }
+    // Merge the sets of p and q (lock-free), always hanging the root with
+    // the larger key I below the other so that each root has the smallest key
+    // of its set
+    inline void unite(
+      const std::vector<int> & I,
+      std::vector<std::atomic<int> > & P,
+      int p,
+      int q)
+    {
+      while(true)
+      {
+        p = find(P,p);
+        q = find(P,q);
+        if(p == q)
+        {
+          return;
+        }
+        if(I[p] < I[q])
+        {
+          std::swap(p,q);
+        }
+        int expected = p;
+        if(P[p].compare_exchange_weak(expected,q))
+        {
+          return;
+        }
+      }
+    }
+  }
+}
 
 template <
   typename DerivedV, 
@@ -24,16 +96,287 @@ IGL_INLINE void igl::remove_duplicate_vertices(
   Eigen::PlainObjectBase<DerivedSVI>& SVI,
   Eigen::PlainObjectBase<DerivedSVJ>& SVJ)
 {
-  if(epsilon > 0)
+  using namespace std;
+  using namespace igl::remove_duplicate_vertices_helpers;
+  const int n = V.rows();
+  const int dim = V.cols();
+  const bool exact = !(epsilon > 0);
+  // Hash vertices on a grid: with cells of size h > 2*epsilon a vertex can
+  // only have neighbors in its own cell and, along each axis, in the one
+  // adjacent cell it is within epsilon of. Larger cells are visited less
+  // often but hold more vertices. With epsilon = 0 the "cells" are the exact
+  // coordinates. Cells are at least 2^-40 of the extent of V wide, so that
+  // an epsilon below the resolution of the coordinates (e.g. machine
+  // epsilon) does not ask for more cells than fit in an int64_t.
+  Eigen::Matrix<double,1,Eigen::Dynamic> lo = 
+    Eigen::Matrix<double,1,Eigen::Dynamic>::Zero(dim);
+  double extent = 0;
+  if(n > 0 && !exact)
+  {
+    lo = V.colwise().minCoeff().template cast<double>();
+    extent =
+      (V.colwise().maxCoeff().template cast<double>()-lo).maxCoeff();
+  }
+  const double h = std::max(8.0*epsilon,std::ldexp(extent,-40));
+  // Cell coordinates are still clamped for non-finite coordinates
+  const double max_cell = 1e15;
+  // Cell of coordinate x along dimension d and position in that cell in [0,1)
+  const auto cell = [&](const double x, const int d, double & t)->int64_t
+  {
+    if(exact)
+    {
+      // +0.0 folds -0.0 into 0.0
+      const double y = x+0.0;
+      int64_t b;
+      memcpy(&b,&y,sizeof(b));
+      t = 0.5;
+      return b;
+    }
+    const double s = (x-lo(d))/h;
+    const double c = std::floor(s);
+    if(!(c < max_cell))
+    {
+      t = 0.5;
+      return int64_t(max_cell);
+    }
+    t = s-c;
+    return int64_t(c);
+  };
+  const auto hash = [dim](const int64_t * C)->uint64_t
+  {
+    uint64_t k = 0;
+    for(int d = 0;d<dim;d++)
+    {
+      k = hash_combine(k,C[d]);
+    }
+    return hash_finalize(k);
+  };
+  // Table of at least n buckets indexed by the top bits of the cell hashes
+  int bits = 0;
+  while((int64_t(1)<<bits) < n)
   {
-    DerivedV rV,rSV;
-    round((V/(10.0*epsilon)).eval(),rV);
-    unique_rows(rV,rSV,SVI,SVJ);
-    slice(V,SVI,colon<int>(0,V.cols()-1),SV);
-  }else
+    bits++;
+  }
+  const int nb = 1<<bits;
+  // Bucket of the cell of the point x (C is scratch space)
+  const auto bucket = [&](const double * x, int64_t * C)->int
+  {
+    double t;
+    for(int d = 0;d<dim;d++)
+    {
+      C[d] = cell(x[d],d,t);
+    }
+    return bits == 0 ? 0 : int(hash(C)>>(64-bits));
+  };
+  // Sort the vertices and their coordinates into buckets, so that buckets
+  // are later scanned contiguously. Scattering directly into a table of #V
+  // buckets misses the cache on every vertex, so this is done in two passes:
+  // first into groups of buckets (sharing their top bits) in chunks of
+  // vertices, then each group into its own buckets.
+  const int gbits = std::min(bits,10);
+  const int ng = 1<<gbits;
+  const int nbg = nb>>gbits;
+  vector<int> I(n);
+  vector<double> X(size_t(n)*dim);
+  vector<int> start(nb+1);
+  start[nb] = n;
+  {
+    const int nchunks = std::max(1,std::min<int>(
+      std::thread::hardware_concurrency(),n/10000));
+    const auto chunk_begin = [&](const int t)
+    {
+      return int(int64_t(n)*t/nchunks);
+    };
+    // Group of each vertex and number of vertices of each (group,chunk)
+    vector<int> G(n);
+    vector<int> count(size_t(ng)*nchunks,0);
+    parallel_for(nchunks,[&](const int t)
+    {
+      vector<int64_t> C(dim);
+      vector<double> x(dim);
+      for(int i = chunk_begin(t);i<chunk_begin(t+1);i++)
+      {
+        for(int d = 0;d<dim;d++)
+        {
+          x[d] = double(V(i,d));
+        }
+        G[i] = bucket(x.data(),C.data())/nbg;
+        count[size_t(G[i])*nchunks+t]++;
+      }
+    },1);
+    vector<int> gstart(ng+1,0);
+    for(int g = 0,sum = 0;g<ng;g++)
+    {
+      gstart[g] = sum;
+      for(int t = 0;t<nchunks;t++)
+      {
+        const int c = count[size_t(g)*nchunks+t];
+        count[size_t(g)*nchunks+t] = sum;
+        sum += c;
+      }
+    }
+    gstart[ng] = n;
+    vector<int> I1(n);
+    vector<double> X1(size_t(n)*dim);
+    parallel_for(nchunks,[&](const int t)
+    {
+      for(int i = chunk_begin(t);i<chunk_begin(t+1);i++)
+      {
+        const int p = count[size_t(G[i])*nchunks+t]++;
+        I1[p] = i;
+        for(int d = 0;d<dim;d++)
+        {
+          X1[size_t(p)*dim+d] = double(V(i,d));
+        }
+      }
+    },1);
+    parallel_for(ng,[&](const int g)
+    {
+      vector<int64_t> C(dim);
+      const int p0 = gstart[g];
+      const int p1 = gstart[g+1];
+      // Buckets within the group
+      vector<int> B(p1-p0);
+      vector<int> next(nbg,0);
+      for(int p = p0;p<p1;p++)
+      {
+        B[p-p0] = bucket(&X1[size_t(p)*dim],C.data()) - g*nbg;
+        next[B[p-p0]]++;
+      }
+      for(int b = 0,sum = p0;b<nbg;b++)
+      {
+        start[g*nbg+b] = sum;
+        sum += next[b];
+        next[b] = start[g*nbg+b];
+      }
+      for(int p = p0;p<p1;p++)
+      {
+        const int q = next[B[p-p0]]++;
+        I[q] = I1[p];
+        std::copy(
+          X1.begin()+size_t(p)*dim,X1.begin()+size_t(p+1)*dim,
+          X.begin()+size_t(q)*dim);
+      }
+    },1);
+  }
+  // Union positions in the buckets of vertices within epsilon of each other
+  vector<atomic<int> > P(n);
+  parallel_for(n,[&](const int p){ P[p].store(p,memory_order_relaxed); },
+    10000);
+  const double eps2 = epsilon*epsilon;
+  const auto close = [&](const double * x, const double * y)->bool
   {
-    unique_rows(V,SV,SVI,SVJ);
+    double d2 = 0;
+    for(int d = 0;d<dim;d++)
+    {
+      d2 += (x[d]-y[d])*(x[d]-y[d]);
+    }
+    return d2 <= eps2;
+  };
+  // Slack on the position within a cell against rounding
+  const double near = exact ? 0 : epsilon/h + 1e-6;
+  {
+    // Per thread: cell of the vertex, direction (-1, 0, +1) of the adjacent
+    // cell to visit along each axis and current neighbor cell
+    vector<vector<int64_t> > C,D,N;
+    parallel_for(n,
+      [&](const size_t nt)
+      {
+        C.assign(nt,vector<int64_t>(dim));
+        D.assign(nt,vector<int64_t>(dim));
+        N.assign(nt,vector<int64_t>(dim));
+      },
+      [&](const int p, const size_t t)
+      {
+        const double * x = &X[size_t(p)*dim];
+        vector<int64_t> & c = C[t];
+        vector<int64_t> & dir = D[t];
+        vector<int64_t> & nc = N[t];
+        int nadj = 0;
+        for(int d = 0;d<dim;d++)
+        {
+          double s;
+          c[d] = cell(x[d],d,s);
+          dir[d] = s <= near ? -1 : (s >= 1.0-near ? 1 : 0);
+          nadj += dir[d] != 0;
+        }
+        // A vertex equal to a vertex with a smaller index has the same
+        // neighbors, which are linked from that vertex: one link is enough.
+        // This skips most of the work on triangle soups.
+        const int b0 = bits == 0 ? 0 : int(hash(c.data())>>(64-bits));
+        for(int q = start[b0];q<start[b0+1];q++)
+        {
+          if(I[q] < I[p] && std::equal(x,x+dim,&X[size_t(q)*dim]))
+          {
+            unite(I,P,p,q);
+            return;
+          }
+        }
+        if(exact)
+        {
+          return;
+        }
+        // Visit the own cell and each adjacent cell (subset of the adjacent
+        // directions) whose offset is lexicographically positive: a close
+        // pair in different cells is found from one side only.
+        for(int a = 0;a < (1<<nadj);a++)
+        {
+          int first = 0;
+          for(int d = 0,k = 0;d<dim;d++)
+          {
+            nc[d] = c[d];
+            if(dir[d] != 0 && (a>>k++ & 1))
+            {
+              nc[d] += dir[d];
+              first = first == 0 ? int(dir[d]) : first;
+            }
+          }
+          if(first < 0)
+          {
+            continue;
+          }
+          const int b = a == 0 ? b0 : int(hash(nc.data())>>(64-bits));
+          for(int q = start[b];q<start[b+1];q++)
+          {
+            // Within the own cell, from the vertex with the larger index
+            if((a != 0 || I[q] < I[p]) && close(x,&X[size_t(q)*dim]))
+            {
+              unite(I,P,p,q);
+            }
+          }
+        }
+      },
+      [](const size_t){},
+      1000);
+  }
+  // Number the sets by their smallest vertex. R(i) is the smallest vertex of
+  // the set of vertex i.
+  Eigen::VectorXi R(n);
+  parallel_for(n,[&](const int p){ R(I[p]) = I[find(P,p)]; },10000);
+  int nsv = 0;
+  SVI.resize(n,1);
+  SVJ.resize(n,1);
+  for(int i = 0;i<n;i++)
+  {
+    if(R(i) == i)
+    {
+      SVJ(i) = nsv;
+      SVI(nsv++) = i;
+    }
   }
+  SVI.conservativeResize(nsv,1);
+  parallel_for(n,[&](const int i)
+  {
+    if(R(i) != i)
+    {
+      SVJ(i) = SVJ(R(i));
+    }
+  },10000);
+  SV.resize(nsv,dim);
+  parallel_for(nsv,[&](const int s)
+  {
+    SV.row(s) = V.row(SVI(s));
+  },10000);
 }
 
 template <
@@ -56,13 +399,13 @@ IGL_INLINE void igl::remove_duplicate_vertices(
   using namespace std;
   remove_duplicate_vertices(V,epsilon,SV,SVI,SVJ);
   SF.resizeLike(F);
-  for(int f = 0;f<F.rows();f++)
+  parallel_for(F.rows(),[&](const int f)
   {
     for(int c = 0;c<F.cols();c++)
     {
       SF(f,c) = SVJ(F(f,c));
     }
-  }
+  },10000);
 }
 
 #ifdef IGL_STATIC_LIBRARY
@@ -14,14 +14,30 @@ namespace igl
   // REMOVE_DUPLICATE_VERTICES Remove duplicate vertices upto a uniqueness
   // tolerance (epsilon)
   //
+  // Vertices closer than epsilon (Euclidean distance) are welded, and so are,
+  // transitively, vertices connected by chains of such close pairs. A welded
+  // vertex can thus be farther than epsilon from the vertex representing its
+  // group, which is the one of smallest index: the result depends on the
+  // order of V, but not on thread scheduling. Vertices are hashed in parallel
+  // on a grid of cells 8*epsilon (but at least 2^-40 of the extent of V)
+  // wide. Memory is linear in #V, and so is time except that the distinct
+  // vertices of a cell (or of cells sharing a hash bucket) are compared
+  // pairwise, i.e. quadratic in their number.
+  //
+  // Note: this used to round coordinates to a grid of spacing 10*epsilon,
+  // which welded vertices up to about 10*epsilon apart per axis (if rounded
+  // to the same point) but never across grid cells. With the same epsilon,
+  // vertices closer than epsilon are now always welded and farther ones only
+  // through chains of close ones. Callers that relied on the coarser welding
+  // need a larger epsilon.
+  //
   // Inputs:
   //   V  #V by dim list of vertex positions
-  //   epsilon  uniqueness tolerance (significant digit), can probably think of
-  //     this as a tolerance on L1 distance
+  //   epsilon  uniqueness tolerance, 0 to only weld exactly equal vertices
   // Outputs:
   //   SV  #SV by dim new list of vertex positions
-  //   SVI #V by 1 list of indices so SV = V(SVI,:) 
-  //   SVJ #SV by 1 list of indices so V = SV(SVJ,:)
+  //   SVI #SV by 1 list of indices so SV = V(SVI,:) (sorted ascendingly)
+  //   SVJ #V by 1 list of indices so that vertex i is welded into SV(SVJ(i),:)
   //
   // Example:
   //   % Mesh in (V,F)
@@ -91,6 +91,21 @@ namespace igl
                                          const Eigen::PlainObjectBase<Derivedw>& wShape,
                                          const Eigen::PlainObjectBase<Derivedw>& wSmooth,
                                          ShapeupData & sudata);
+
+  //This function replaces the weights of the sets and of the smoothness terms of a previous shapeup_precomputation (e.g. to reweight between solves), and numerically refactors the system while reusing its symbolic analysis.
+
+  //input:
+  //  wShape,   #Set by 1
+  //  wSmooth   #E by 1       new weights for constraints from S and for the smoothness energy
+  //  sudata    struct ShapeupData from shapeup_precomputation
+
+  // Output:
+  //  sudata    updated system
+  template <
+  typename Derivedw>
+  IGL_INLINE bool shapeup_update_weights(const Eigen::PlainObjectBase<Derivedw>& wShape,
+                                         const Eigen::PlainObjectBase<Derivedw>& wSmooth,
+                                         ShapeupData & sudata);
     
     
     
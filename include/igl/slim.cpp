@@ -24,6 +24,7 @@
 #include "volume.h"
 #include "polar_svd.h"
 #include "flip_avoiding_line_search.h"
+#include "parallel_for.h"
 
 #include <iostream>
 #include <map>
@@ -126,9 +127,10 @@ namespace igl
       const double eps = 1e-8;
       double exp_f = s.exp_factor;
 
+      // Every face is independent: decompose the jacobians in parallel
       if (s.dim == 2)
       {
-        for (int i = 0; i < s.Ji.rows(); ++i)
+        igl::parallel_for(s.Ji.rows(), [&](const int i)
         {
           typedef Eigen::Matrix<double, 2, 2> Mat2;
           typedef Eigen::Matrix<double, 2, 1> Vec2;
@@ -235,18 +237,18 @@ namespace igl
           s.Ri(i, 1) = ri(1, 0);
           s.Ri(i, 2) = ri(0, 1);
           s.Ri(i, 3) = ri(1, 1);
-        }
+        }, 1000);
       }
       else
       {
         typedef Eigen::Matrix<double, 3, 1> Vec3;
         typedef Eigen::Matrix<double, 3, 3> Mat3;
-        Mat3 ji;
-        Vec3 m_sing_new;
-        Vec3 closest_sing_vec;
         const double sqrt_2 = sqrt(2);
-        for (int i = 0; i < s.Ji.rows(); ++i)
+        igl::parallel_for(s.Ji.rows(), [&](const int i)
         {
+          Mat3 ji;
+          Vec3 m_sing_new;
+          Vec3 closest_sing_vec;
           ji(0, 0) = s.Ji(i, 0);
           ji(0, 1) = s.Ji(i, 1);
           ji(0, 2) = s.Ji(i, 2);
@@ -385,7 +387,7 @@ namespace igl
           s.Ri(i, 6) = ri(0, 2);
           s.Ri(i, 7) = ri(1, 2);
           s.Ri(i, 8) = ri(2, 2);
-        } // for loop end
+        }, 1000);
 
       } // if dim end
 
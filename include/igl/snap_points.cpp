@@ -6,9 +6,56 @@
 // v. 2.0. If a copy of the MPL was not distributed with this file, You can 
 // obtain one at http://mozilla.org/MPL/2.0/.
 #include "snap_points.h"
+#include "KDTree.h"
+#include "parallel_for.h"
 #include <cassert>
 #include <limits>
 
+namespace igl
+{
+  namespace snap_points_helpers
+  {
+    // Closest points by querying a kd-tree on V (in parallel)
+    template <
+      int DIM,
+      typename DerivedC,
+      typename DerivedV,
+      typename DerivedI,
+      typename DerivedminD>
+    IGL_INLINE void snap_kdtree(
+      const Eigen::PlainObjectBase<DerivedC > & C,
+      const Eigen::PlainObjectBase<DerivedV > & V,
+      Eigen::PlainObjectBase<DerivedI > & I,
+      Eigen::PlainObjectBase<DerivedminD > & minD)
+    {
+      typedef typename DerivedV::Scalar Scalar;
+      typedef Eigen::Matrix<Scalar,Eigen::Dynamic,Eigen::Dynamic> MatrixXS;
+      const int m = C.rows();
+      const igl::KDTree<Scalar,DIM> tree(V);
+      // Copy coefficient-wise: C may have a fixed number of columns other than
+      // DIM in instantiations that never take this path
+      MatrixXS Q(m,DIM);
+      for(int c = 0;c<m;c++)
+      {
+        for(int d = 0;d<DIM;d++)
+        {
+          Q(c,d) = Scalar(C(c,d));
+        }
+      }
+      Eigen::MatrixXi NI;
+      MatrixXS sqrD;
+      tree.knn(Q,1,NI,sqrD);
+      I.resize(m,1);
+      minD.resize(m,1);
+      for(int c = 0;c<m;c++)
+      {
+        I(c,0) = NI(c,0);
+        minD(c,0) = sqrD(c,0);
+      }
+    }
+  }
+}
+
 template <
   typename DerivedC, 
   typename DerivedV, 
@@ -46,16 +93,23 @@ IGL_INLINE void igl::snap_points(
   const int n = V.rows();
   const int m = C.rows();
   assert(V.cols() == C.cols() && "Dimensions should match");
+  // Building a kd-tree costs about as much as a few brute force passes over
+  // V, so it only pays off for more than a few queries
+  if(n > 32 && m > 32 && V.cols() == 3)
+  {
+    return snap_points_helpers::snap_kdtree<3>(C,V,I,minD);
+  }
+  if(n > 32 && m > 32 && V.cols() == 2)
+  {
+    return snap_points_helpers::snap_kdtree<2>(C,V,I,minD);
+  }
   // O(m*n)
-  //
-  // I believe there should be a way to do this in O(m*log(n) + n) assuming
-  // reasonably distubed points.
   I.resize(m,1);
   typedef typename DerivedV::Scalar Scalar;
   minD.setConstant(m,1,numeric_limits<Scalar>::max());
-  for(int v = 0;v<n;v++)
+  parallel_for(m,[&](const int c)
   {
-    for(int c = 0;c<m;c++)
+    for(int v = 0;v<n;v++)
     {
       const Scalar d = (C.row(c) - V.row(v)).squaredNorm();
       if(d < minD(c))
@@ -64,7 +118,7 @@ IGL_INLINE void igl::snap_points(
         I(c,0) = v;
       }
     }
-  }
+  },64);
 }
 
 template <
@@ -16,6 +16,10 @@ namespace igl
   // SNAP_POINTS snap list of points C to closest of another list of points V
   //
   // [I,minD,VI] = snap_points(C,V)
+  //
+  // For 2D and 3D points and more than a few queries, the closest points are
+  // found with a KDTree on V, otherwise by brute force (both in parallel).
+  // Ties go to the smallest index in V either way.
   // 
   // Inputs:
   //   C  #C by dim list of query point positions
@@ -6,6 +6,7 @@
 // v. 2.0. If a copy of the MPL was not distributed with this file, You can
 // obtain one at http://mozilla.org/MPL/2.0/.
 #include "sparse_cached.h"
+#include "parallel_for.h"
 
 #include <iostream>
 #include <vector>
@@ -115,8 +116,49 @@ IGL_INLINE void igl::sparse_cached(
     *(X.valuePtr() + data[i]) += V[i];
 }
 
+template <typename Scalar>
+IGL_INLINE void igl::sparse_cached_precompute(
+  const std::vector<Eigen::Triplet<Scalar> >& triplets,
+  sparse_cached_data& data,
+  Eigen::SparseMatrix<Scalar>& X)
+{
+  sparse_cached_precompute(triplets,data.data,X);
+
+  // Counting sort of the triplets by the non-zero they contribute to
+  const int nnz = X.nonZeros();
+  data.offsets = Eigen::VectorXi::Zero(nnz+1);
+  for (int t = 0; t<data.data.size(); ++t)
+    data.offsets(data.data(t)+1)++;
+  for (int k = 0; k<nnz; ++k)
+    data.offsets(k+1) += data.offsets(k);
+  data.sources.resize(data.data.size());
+  std::vector<int> fill(data.offsets.data(),data.offsets.data()+nnz);
+  for (int t = 0; t<data.data.size(); ++t)
+    data.sources(fill[data.data(t)]++) = t;
+}
+
+template <typename DerivedV, typename Scalar>
+IGL_INLINE void igl::sparse_cached(
+  const Eigen::DenseBase<DerivedV>& V,
+  const sparse_cached_data& data,
+  Eigen::SparseMatrix<Scalar>& X)
+{
+  assert(V.size() == data.sources.size());
+  assert(X.nonZeros()+1 == data.offsets.size());
+
+  Scalar * values = X.valuePtr();
+  igl::parallel_for(X.nonZeros(),[&](const int k)
+  {
+    Scalar sum = 0;
+    for (int j = data.offsets(k); j<data.offsets(k+1); ++j)
+      sum += V.coeff(data.sources(j));
+    values[k] = sum;
+  },1000);
+}
 
 #ifdef IGL_STATIC_LIBRARY
 template void igl::sparse_cached<double>(std::vector<Eigen::Triplet<double, Eigen::SparseMatrix<double, 0, int>::Index>, std::allocator<Eigen::Triplet<double, Eigen::SparseMatrix<double, 0, int>::Index> > > const&, Eigen::Matrix<int, -1, 1, 0, -1, 1> const&, Eigen::SparseMatrix<double, 0, int>&);
 template void igl::sparse_cached_precompute<double>(std::vector<Eigen::Triplet<double, Eigen::SparseMatrix<double, 0, int>::Index>, std::allocator<Eigen::Triplet<double, Eigen::SparseMatrix<double, 0, int>::Index> > > const&, Eigen::Matrix<int, -1, 1, 0, -1, 1>&, Eigen::SparseMatrix<double, 0, int>&);
+template void igl::sparse_cached_precompute<double>(std::vector<Eigen::Triplet<double, int>, std::allocator<Eigen::Triplet<double, int> > > const&, igl::sparse_cached_data&, Eigen::SparseMatrix<double, 0, int>&);
+template void igl::sparse_cached<Eigen::Matrix<double, -1, -1, 0, -1, -1>, double>(Eigen::DenseBase<Eigen::Matrix<double, -1, -1, 0, -1, -1> > const&, igl::sparse_cached_data const&, Eigen::SparseMatrix<double, 0, int>&);
 #endif
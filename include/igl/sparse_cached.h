@@ -75,7 +75,46 @@ namespace igl
     const Eigen::VectorXi& data,
     Eigen::SparseMatrix<Scalar>& X
     );
-  
+
+  // Cached pattern for the parallel version of sparse_cached.
+  struct sparse_cached_data
+  {
+    // #triplets list of indices into X.valuePtr() (see above)
+    Eigen::VectorXi data;
+    // Inverse of data: the triplets summed into the k-th non-zero of X are
+    // sources(offsets(k)),...,sources(offsets(k+1)-1)
+    Eigen::VectorXi offsets;
+    Eigen::VectorXi sources;
+  };
+
+  // Same as above, but instead of scattering the triplets into X (which
+  // would race when several triplets hit the same entry), each non-zero of X
+  // gathers and sums its own triplets, in parallel.
+  //
+  // Example:
+  //   igl::sparse_cached_data A_data;
+  //   if (A.rows() == 0)
+  //   {
+  //     A = Eigen::SparseMatrix<double>(rows,cols);
+  //     igl::sparse_cached_precompute(IJV,A_data,A);
+  //   }
+  //   else
+  //     igl::sparse_cached(V,A_data,A);
+  //
+  // where V(t) (linearly indexed) is the value of the t-th triplet in IJV.
+  template <typename Scalar>
+  IGL_INLINE void sparse_cached_precompute(
+    const std::vector<Eigen::Triplet<Scalar> >& triplets,
+    sparse_cached_data& data,
+    Eigen::SparseMatrix<Scalar>& X
+    );
+
+  template <typename DerivedV, typename Scalar>
+  IGL_INLINE void sparse_cached(
+    const Eigen::DenseBase<DerivedV>& V,
+    const sparse_cached_data& data,
+    Eigen::SparseMatrix<Scalar>& X
+    );
 }
 
 #ifndef IGL_STATIC_LIBRARY
@@ -89,10 +89,46 @@ IGL_INLINE void igl::triangle_triangle_adjacency(
   Eigen::PlainObjectBase<DerivedTT>& TT,
   Eigen::PlainObjectBase<DerivedTTi>& TTi)
 {
-  std::vector<std::vector<int> > TTT;
-  triangle_triangle_adjacency_preprocess(F,TTT);
-  triangle_triangle_adjacency_extractTT(F,TTT,TT);
-  triangle_triangle_adjacency_extractTTi(F,TTT,TTi);
+  using namespace Eigen;
+  using namespace std;
+  if(F.cols() != 3)
+  {
+    std::vector<std::vector<int> > TTT;
+    triangle_triangle_adjacency_preprocess(F,TTT);
+    triangle_triangle_adjacency_extractTT(F,TTT,TT);
+    triangle_triangle_adjacency_extractTTi(F,TTT,TTi);
+    return;
+  }
+  Matrix<typename DerivedF::Scalar,Dynamic,2> E,uE;
+  VectorXi EMAP,uEC,uEE;
+  unique_edge_map(F,E,uE,EMAP,uEC,uEE);
+  const int m = F.rows();
+  TT.setConstant(m,3,-1);
+  TTi.setConstant(m,3,-1);
+  // Directed edge c*m+f is edge (c+1)%3 of face f
+  parallel_for(uE.rows(),[&](const int u)
+  {
+    const int nu = uEC(u+1)-uEC(u);
+    if(nu < 2)
+    {
+      return;
+    }
+    // Link faces sharing the edge consecutively in (face,edge) order
+    vector<pair<int,int> > fi(nu);
+    for(int j = 0;j<nu;j++)
+    {
+      const int e = uEE(uEC(u)+j);
+      fi[j] = make_pair(e%m,(e/m+1)%3);
+    }
+    sort(fi.begin(),fi.end());
+    for(int j = 1;j<nu;j++)
+    {
+      TT(fi[j-1].first,fi[j-1].second) = fi[j].first;
+      TT(fi[j].first,fi[j].second) = fi[j-1].first;
+      TTi(fi[j-1].first,fi[j-1].second) = fi[j].second;
+      TTi(fi[j].first,fi[j].second) = fi[j-1].second;
+    }
+  },1000);
 }
 
 template <
@@ -134,12 +170,41 @@ template <
   // number of faces
   typedef typename DerivedF::Index Index;
   typedef Matrix<typename DerivedF::Scalar,Dynamic,2> MatrixX2I;
-  typedef Matrix<typename DerivedF::Index,Dynamic,1> VectorXI;
   MatrixX2I E,uE;
-  VectorXI EMAP;
-  vector<vector<Index> > uE2E;
-  unique_edge_map(F,E,uE,EMAP,uE2E);
-  return triangle_triangle_adjacency(E,EMAP,uE2E,construct_TTi,TT,TTi);
+  VectorXi EMAP,uEC,uEE;
+  unique_edge_map(F,E,uE,EMAP,uEC,uEE);
+  const Index m = F.rows();
+  TT.resize(m,vector<vector<TTIndex> >(3));
+  if(construct_TTi)
+  {
+    TTi.resize(m,vector<vector<TTiIndex> >(3));
+  }
+  // Read coexisting edges straight from the compressed map (see overload
+  // below)
+  igl::parallel_for(
+    m,
+    [&](const Index & f)
+    {
+      for(Index c = 0;c<3;c++)
+      {
+        const Index u = EMAP(f + m*c);
+        for(Index j = uEC(u);j<uEC(u+1);j++)
+        {
+          const Index ne = uEE(j);
+          const Index nf = ne%m;
+          // don't add self
+          if(nf != f)
+          {
+            TT[f][c].push_back(nf);
+            if(construct_TTi)
+            {
+              TTi[f][c].push_back(ne/m);
+            }
+          }
+        }
+      }
+    },
+    1000ul);
 }
 
 template <
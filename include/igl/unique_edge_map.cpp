@@ -8,8 +8,12 @@
 #include "unique_edge_map.h"
 #include "oriented_facets.h"
 #include "unique_simplices.h"
+#include "parallel_for.h"
+#include <atomic>
 #include <cassert>
 #include <algorithm>
+#include <cstdint>
+
 template <
   typename DerivedF,
   typename DerivedE,
@@ -25,21 +29,127 @@ IGL_INLINE void igl::unique_edge_map(
 {
   using namespace Eigen;
   using namespace std;
-  // All occurrences of directed edges
-  oriented_facets(F,E);
-  const size_t ne = E.rows();
   // This is 2x faster to create than a map from pairs to lists of edges and 5x
   // faster to access (actually access is probably assympotically faster O(1)
   // vs. O(log m)
-  Matrix<typename DerivedEMAP::Scalar,Dynamic,1> IA;
-  unique_simplices(E,uE,IA,EMAP);
+  VectorXi uEC,uEE;
+  unique_edge_map(F,E,uE,EMAP,uEC,uEE);
+  uE2E.clear();
   uE2E.resize(uE.rows());
-  // This does help a little
-  for_each(uE2E.begin(),uE2E.end(),[](vector<uE2EType > & v){v.reserve(2);});
-  assert((size_t)EMAP.size() == ne);
-  for(uE2EType e = 0;e<(uE2EType)ne;e++)
+  parallel_for(uE.rows(),[&](const int u)
+  {
+    uE2E[u].assign(uEE.data()+uEC(u),uEE.data()+uEC(u+1));
+  },1000);
+}
+
+template <
+  typename DerivedF,
+  typename DerivedE,
+  typename DeriveduE,
+  typename DerivedEMAP,
+  typename DeriveduEC,
+  typename DeriveduEE>
+IGL_INLINE void igl::unique_edge_map(
+  const Eigen::MatrixBase<DerivedF> & F,
+  Eigen::PlainObjectBase<DerivedE> & E,
+  Eigen::PlainObjectBase<DeriveduE> & uE,
+  Eigen::PlainObjectBase<DerivedEMAP> & EMAP,
+  Eigen::PlainObjectBase<DeriveduEC> & uEC,
+  Eigen::PlainObjectBase<DeriveduEE> & uEE)
+{
+  using namespace Eigen;
+  using namespace std;
+  // All occurrences of directed edges
+  oriented_facets(F,E);
+  const int ne = E.rows();
+  if(E.cols() != 2)
+  {
+    // Higher dimensional facets (e.g. triangles of tets): sort rows
+    Matrix<typename DerivedEMAP::Scalar,Dynamic,1> IA;
+    unique_simplices(E,uE,IA,EMAP);
+    uEC.setZero(uE.rows()+1,1);
+    for(int e = 0;e<ne;e++)
+    {
+      uEC(EMAP(e)+1)++;
+    }
+    for(int u = 0;u<uE.rows();u++)
+    {
+      uEC(u+1) += uEC(u);
+    }
+    uEE.resize(ne,1);
+    VectorXi next = uEC.template cast<int>();
+    for(int e = 0;e<ne;e++)
+    {
+      uEE(next(EMAP(e))++) = e;
+    }
+    return;
+  }
+  const int n = ne == 0 ? 0 : int(E.maxCoeff())+1;
+  const auto lo = [&E](const int e)
   {
-    uE2E[EMAP(e)].push_back(e);
+    return int(std::min(E(e,0),E(e,1)));
+  };
+  const auto hi = [&E](const int e)
+  {
+    return int(std::max(E(e,0),E(e,1)));
+  };
+  // Bucket directed edges on their smaller vertex (counting sort)
+  vector<int> start(n+1,0);
+  {
+    vector<atomic<int> > count(n);
+    parallel_for(ne,[&](const int e)
+    {
+      count[lo(e)].fetch_add(1,memory_order_relaxed);
+    },10000);
+    for(int v = 0;v<n;v++)
+    {
+      start[v+1] = start[v] + count[v].load(memory_order_relaxed);
+      count[v].store(start[v],memory_order_relaxed);
+    }
+    // Keys pack the larger vertex and the directed edge index so that sorting
+    // a bucket groups coexisting edges and orders each group ascendingly
+    vector<uint64_t> key(ne);
+    parallel_for(ne,[&](const int e)
+    {
+      key[count[lo(e)].fetch_add(1,memory_order_relaxed)] =
+        (uint64_t(hi(e))<<32) | uint64_t(e);
+    },10000);
+    // Sort (tiny) buckets and count unique edges in each
+    vector<int> nu(n+1,0);
+    parallel_for(n,[&](const int v)
+    {
+      sort(key.begin()+start[v],key.begin()+start[v+1]);
+      for(int i = start[v];i<start[v+1];i++)
+      {
+        nu[v+1] += (i == start[v] || (key[i]>>32) != (key[i-1]>>32));
+      }
+    },1000);
+    for(int v = 0;v<n;v++)
+    {
+      nu[v+1] += nu[v];
+    }
+    const int nue = nu[n];
+    uE.resize(nue,2);
+    EMAP.resize(ne,1);
+    uEC.resize(nue+1,1);
+    uEE.resize(ne,1);
+    uEC(nue) = ne;
+    parallel_for(n,[&](const int v)
+    {
+      int u = nu[v]-1;
+      for(int i = start[v];i<start[v+1];i++)
+      {
+        const int e = int(key[i] & 0xffffffffu);
+        if(i == start[v] || (key[i]>>32) != (key[i-1]>>32))
+        {
+          // First occurrence gives the orientation
+          uE.row(++u) = E.row(e);
+          uEC(u) = i;
+        }
+        EMAP(e) = u;
+        uEE(i) = e;
+      }
+    },1000);
   }
 }
 
@@ -59,6 +169,10 @@ template void igl::unique_edge_map<Eigen::Matrix<double, -1, -1, 0, -1, -1>, Eig
 template void igl::unique_edge_map<Eigen::Matrix<int, -1, 3, 0, -1, 3>, Eigen::Matrix<int, -1, -1, 0, -1, -1>, Eigen::Matrix<int, -1, 2, 0, -1, 2>, Eigen::Matrix<int, -1, 1, 0, -1, 1>, int>(Eigen::MatrixBase<Eigen::Matrix<int, -1, 3, 0, -1, 3> > const&, Eigen::PlainObjectBase<Eigen::Matrix<int, -1, -1, 0, -1, -1> >&, Eigen::PlainObjectBase<Eigen::Matrix<int, -1, 2, 0, -1, 2> >&, Eigen::PlainObjectBase<Eigen::Matrix<int, -1, 1, 0, -1, 1> >&, std::vector<std::vector<int, std::allocator<int> >, std::allocator<std::vector<int, std::allocator<int> > > >&);
 template void igl::unique_edge_map<Eigen::Matrix<int, -1, -1, 0, -1, -1>, Eigen::Matrix<int, -1, -1, 0, -1, -1>, Eigen::Matrix<int, -1, -1, 0, -1, -1>, Eigen::Matrix<int, -1, 1, 0, -1, 1>, unsigned long>(Eigen::MatrixBase<Eigen::Matrix<int, -1, -1, 0, -1, -1> > const&, Eigen::PlainObjectBase<Eigen::Matrix<int, -1, -1, 0, -1, -1> >&, Eigen::PlainObjectBase<Eigen::Matrix<int, -1, -1, 0, -1, -1> >&, Eigen::PlainObjectBase<Eigen::Matrix<int, -1, 1, 0, -1, 1> >&, std::vector<std::vector<unsigned long, std::allocator<unsigned long> >, std::allocator<std::vector<unsigned long, std::allocator<unsigned long> > > >&);
 
+template void igl::unique_edge_map<Eigen::Matrix<int, -1, -1, 0, -1, -1>, Eigen::Matrix<int, -1, -1, 0, -1, -1>, Eigen::Matrix<int, -1, -1, 0, -1, -1>, Eigen::Matrix<int, -1, 1, 0, -1, 1>, Eigen::Matrix<int, -1, 1, 0, -1, 1>, Eigen::Matrix<int, -1, 1, 0, -1, 1> >(Eigen::MatrixBase<Eigen::Matrix<int, -1, -1, 0, -1, -1> > const&, Eigen::PlainObjectBase<Eigen::Matrix<int, -1, -1, 0, -1, -1> >&, Eigen::PlainObjectBase<Eigen::Matrix<int, -1, -1, 0, -1, -1> >&, Eigen::PlainObjectBase<Eigen::Matrix<int, -1, 1, 0, -1, 1> >&, Eigen::PlainObjectBase<Eigen::Matrix<int, -1, 1, 0, -1, 1> >&, Eigen::PlainObjectBase<Eigen::Matrix<int, -1, 1, 0, -1, 1> >&);
+template void igl::unique_edge_map<Eigen::Matrix<int, -1, -1, 0, -1, -1>, Eigen::Matrix<int, -1, 2, 0, -1, 2>, Eigen::Matrix<int, -1, 2, 0, -1, 2>, Eigen::Matrix<int, -1, 1, 0, -1, 1>, Eigen::Matrix<int, -1, 1, 0, -1, 1>, Eigen::Matrix<int, -1, 1, 0, -1, 1> >(Eigen::MatrixBase<Eigen::Matrix<int, -1, -1, 0, -1, -1> > const&, Eigen::PlainObjectBase<Eigen::Matrix<int, -1, 2, 0, -1, 2> >&, Eigen::PlainObjectBase<Eigen::Matrix<int, -1, 2, 0, -1, 2> >&, Eigen::PlainObjectBase<Eigen::Matrix<int, -1, 1, 0, -1, 1> >&, Eigen::PlainObjectBase<Eigen::Matrix<int, -1, 1, 0, -1, 1> >&, Eigen::PlainObjectBase<Eigen::Matrix<int, -1, 1, 0, -1, 1> >&);
+template void igl::unique_edge_map<Eigen::Matrix<int, -1, 3, 0, -1, 3>, Eigen::Matrix<int, -1, 2, 0, -1, 2>, Eigen::Matrix<int, -1, 2, 0, -1, 2>, Eigen::Matrix<int, -1, 1, 0, -1, 1>, Eigen::Matrix<int, -1, 1, 0, -1, 1>, Eigen::Matrix<int, -1, 1, 0, -1, 1> >(Eigen::MatrixBase<Eigen::Matrix<int, -1, 3, 0, -1, 3> > const&, Eigen::PlainObjectBase<Eigen::Matrix<int, -1, 2, 0, -1, 2> >&, Eigen::PlainObjectBase<Eigen::Matrix<int, -1, 2, 0, -1, 2> >&, Eigen::PlainObjectBase<Eigen::Matrix<int, -1, 1, 0, -1, 1> >&, Eigen::PlainObjectBase<Eigen::Matrix<int, -1, 1, 0, -1, 1> >&, Eigen::PlainObjectBase<Eigen::Matrix<int, -1, 1, 0, -1, 1> >&);
+
 #ifdef WIN32
 template void igl::unique_edge_map<class Eigen::Matrix<int, -1, 3, 0, -1, 3>, class Eigen::Matrix<int, -1, 2, 0, -1, 2>, class Eigen::Matrix<int, -1, 2, 0, -1, 2>, class Eigen::Matrix<__int64, -1, 1, 0, -1, 1>, __int64>(class Eigen::MatrixBase<class Eigen::Matrix<int, -1, 3, 0, -1, 3> > const &, class Eigen::PlainObjectBase<class Eigen::Matrix<int, -1, 2, 0, -1, 2> > &, class Eigen::PlainObjectBase<class Eigen::Matrix<int, -1, 2, 0, -1, 2> > &, class Eigen::PlainObjectBase<class Eigen::Matrix<__int64, -1, 1, 0, -1, 1> > &, class std::vector<class std::vector<__int64, class std::allocator<__int64> >, class std::allocator<class std::vector<__int64, class std::allocator<__int64> > > > &);
 template void igl::unique_edge_map<class Eigen::Matrix<int,-1,-1,0,-1,-1>,class Eigen::Matrix<int,-1,2,0,-1,2>,class Eigen::Matrix<int,-1,2,0,-1,2>,class Eigen::Matrix<__int64,-1,1,0,-1,1>,__int64>(class Eigen::MatrixBase<class Eigen::Matrix<int,-1,-1,0,-1,-1> > const &,class Eigen::PlainObjectBase<class Eigen::Matrix<int,-1,2,0,-1,2> > &,class Eigen::PlainObjectBase<class Eigen::Matrix<int,-1,2,0,-1,2> > &,class Eigen::PlainObjectBase<class Eigen::Matrix<__int64,-1,1,0,-1,1> > &,class std::vector<class std::vector<__int64,class std::allocator<__int64> >,class std::allocator<class std::vector<__int64,class std::allocator<__int64> > > > &);
@@ -35,7 +35,38 @@ namespace igl
     Eigen::PlainObjectBase<DeriveduE> & uE,
     Eigen::PlainObjectBase<DerivedEMAP> & EMAP,
     std::vector<std::vector<uE2EType> > & uE2E);
-
+  // Same as above but storing the coexisting edges of each unique edge in
+  // compressed (offsets + flat list) form, which avoids an allocation per
+  // unique edge. Directed edges of a triangle mesh are grouped by bucketing
+  // them on their smaller vertex and sorting each bucket by 64-bit keys
+  // packing the larger vertex and the directed edge index, in parallel and
+  // in time linear in #F.
+  //
+  // Inputs:
+  //   F  #F by 3  list of simplices
+  // Outputs:
+  //   E  #F*3 by 2 list of all of directed edges
+  //   uE  #uE by 2 list of unique undirected edges, sorted by their smaller
+  //     then larger vertex and oriented as their first occurrence in E
+  //   EMAP #F*3 list of indices into uE, mapping each directed edge to unique
+  //     undirected edge
+  //   uEC  #uE+1 list of cumulative counts of directed edges per unique edge
+  //   uEE  #F*3 list of indices into E, so that uEE(uEC(u):uEC(u+1)-1) are
+  //     the coexisting directed edges of unique edge u in ascending order
+  template <
+    typename DerivedF,
+    typename DerivedE,
+    typename DeriveduE,
+    typename DerivedEMAP,
+    typename DeriveduEC,
+    typename DeriveduEE>
+  IGL_INLINE void unique_edge_map(
+    const Eigen::MatrixBase<DerivedF> & F,
+    Eigen::PlainObjectBase<DerivedE> & E,
+    Eigen::PlainObjectBase<DeriveduE> & uE,
+    Eigen::PlainObjectBase<DerivedEMAP> & EMAP,
+    Eigen::PlainObjectBase<DeriveduEC> & uEC,
+    Eigen::PlainObjectBase<DeriveduEE> & uEE);
 }
 #ifndef IGL_STATIC_LIBRARY
 #  include "unique_edge_map.cpp"
@@ -0,0 +1,55 @@
+// This file is part of libigl, a simple c++ geometry processing library.
+//
+// Copyright (C) 2018 Floor Verhoeven
+//
+// This Source Code Form is subject to the terms of the Mozilla Public License
+// v. 2.0. If a copy of the MPL was not distributed with this file, You can
+// obtain one at http://mozilla.org/MPL/2.0/.
+#include "vertex_cache_efficiency.h"
+#include <vector>
+
+template <typename DerivedF>
+IGL_INLINE void igl::vertex_cache_efficiency(
+  const Eigen::MatrixBase<DerivedF> & F,
+  const int cache_size,
+  double & acmr,
+  double & atvr)
+{
+  using namespace std;
+  assert(F.cols() == 3 && "F should contain triangles");
+  assert(cache_size > 0);
+  acmr = 0;
+  atvr = 0;
+  if(F.rows() == 0)
+  {
+    return;
+  }
+  const int n = F.maxCoeff()+1;
+  // Time stamp (in number of misses) at which each vertex entered the cache
+  vector<long> entered(n,-1);
+  long misses = 0;
+  int referenced = 0;
+  for(int f = 0;f<F.rows();f++)
+  {
+    for(int c = 0;c<3;c++)
+    {
+      const int v = F(f,c);
+      if(entered[v] < 0)
+      {
+        referenced++;
+      }
+      // In a FIFO cache a vertex is evicted after cache_size further misses
+      if(entered[v] < 0 || misses-entered[v] >= cache_size)
+      {
+        entered[v] = misses++;
+      }
+    }
+  }
+  acmr = double(misses)/double(F.rows());
+  atvr = double(misses)/double(referenced);
+}
+
+#ifdef IGL_STATIC_LIBRARY
+// Explicit template instantiation
+template void igl::vertex_cache_efficiency<Eigen::Matrix<int, -1, -1, 0, -1, -1> >(Eigen::MatrixBase<Eigen::Matrix<int, -1, -1, 0, -1, -1> > const&, int, double&, double&);
+#endif
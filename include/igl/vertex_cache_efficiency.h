@@ -0,0 +1,40 @@
+// This file is part of libigl, a simple c++ geometry processing library.
+//
+// Copyright (C) 2018 Floor Verhoeven
+//
+// This Source Code Form is subject to the terms of the Mozilla Public License
+// v. 2.0. If a copy of the MPL was not distributed with this file, You can
+// obtain one at http://mozilla.org/MPL/2.0/.
+#ifndef IGL_VERTEX_CACHE_EFFICIENCY_H
+#define IGL_VERTEX_CACHE_EFFICIENCY_H
+#include "igl_inline.h"
+#include <Eigen/Core>
+namespace igl
+{
+  // VERTEX_CACHE_EFFICIENCY Measure how well the face order of a triangle mesh
+  // uses the post-transform vertex cache, by simulating a FIFO cache of the
+  // given size while drawing the faces in order.
+  //
+  // Inputs:
+  //   F  #F by 3 list of triangle indices
+  //   cache_size  size of the simulated FIFO cache (e.g. 16 or 32)
+  // Outputs:
+  //   acmr  average cache miss ratio: number of vertex shader invocations per
+  //     triangle (between 0.5 for ideal meshes and 3)
+  //   atvr  average transformed vertex ratio: number of vertex shader
+  //     invocations per referenced vertex (1 is optimal)
+  //
+  // See also: optimize_vertex_cache
+  template <typename DerivedF>
+  IGL_INLINE void vertex_cache_efficiency(
+    const Eigen::MatrixBase<DerivedF> & F,
+    const int cache_size,
+    double & acmr,
+    double & atvr);
+}
+
+#ifndef IGL_STATIC_LIBRARY
+#  include "vertex_cache_efficiency.cpp"
+#endif
+
+#endif
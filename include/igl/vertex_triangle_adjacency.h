@@ -43,6 +43,34 @@ namespace igl
     const Eigen::PlainObjectBase<DerivedF>& F,
     std::vector<std::vector<IndexType> >& VF,
     std::vector<std::vector<IndexType> >& VFi);
+  // Compressed variant avoiding a list per vertex, built in parallel with a
+  // counting sort
+  //
+  // Inputs:
+  //   F  #F by dim list of mesh faces
+  //   n  number of vertices #V (e.g. `F.maxCoeff()+1` or `V.rows()`)
+  // Outputs:
+  //   VF  #F*dim list of incident faces, so that VF(NI(i)):VF(NI(i+1)-1) are
+  //     the faces incident on vertex i in ascending order
+  //   VFi  #F*dim list of index of incidence within the faces listed in VF
+  //   NI  #V+1 list of cumulative vertex-face degrees with a preceding zero
+  template <
+    typename DerivedF,
+    typename DerivedVF,
+    typename DerivedVFi,
+    typename DerivedNI>
+  IGL_INLINE void vertex_triangle_adjacency(
+    const Eigen::MatrixBase<DerivedF> & F,
+    const int n,
+    Eigen::PlainObjectBase<DerivedVF> & VF,
+    Eigen::PlainObjectBase<DerivedVFi> & VFi,
+    Eigen::PlainObjectBase<DerivedNI> & NI);
+  template <typename DerivedF, typename DerivedVF, typename DerivedNI>
+  IGL_INLINE void vertex_triangle_adjacency(
+    const Eigen::MatrixBase<DerivedF> & F,
+    const int n,
+    Eigen::PlainObjectBase<DerivedVF> & VF,
+    Eigen::PlainObjectBase<DerivedNI> & NI);
 }
 
 #ifndef IGL_STATIC_LIBRARY
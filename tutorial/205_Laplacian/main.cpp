@@ -4,6 +4,7 @@
 #include <igl/grad.h>
 #include <igl/jet.h>
 #include <igl/massmatrix.h>
+#include <igl/massmatrix_cached.h>
 #include <igl/per_vertex_normals.h>
 #include <igl/readDMAT.h>
 #include <igl/readOFF.h>
@@ -15,7 +16,9 @@
 
 Eigen::MatrixXd V,U;
 Eigen::MatrixXi F;
-Eigen::SparseMatrix<double> L;
+Eigen::SparseMatrix<double> L,M;
+// Sparsity pattern of M, fixed by F
+igl::sparse_cached_data M_data;
 igl::opengl::glfw::Viewer viewer;
 
 int main(int argc, char *argv[])
@@ -53,9 +56,15 @@ int main(int argc, char *argv[])
         break;
       case ' ':
       {
-        // Recompute just mass matrix on each step
-        SparseMatrix<double> M;
-        igl::massmatrix(U,F,igl::MASSMATRIX_TYPE_BARYCENTRIC,M);
+        // Recompute just mass matrix on each step, reusing its pattern
+        if(M.rows() == 0)
+        {
+          igl::massmatrix_cached_precompute(
+            U,F,igl::MASSMATRIX_TYPE_BARYCENTRIC,M_data,M);
+        }else
+        {
+          igl::massmatrix_cached(U,F,igl::MASSMATRIX_TYPE_BARYCENTRIC,M_data,M);
+        }
         // Solve (M-delta*L) U = M*U
         const auto & S = (M - 0.001*L);
         Eigen::SimplicialLLT<Eigen::SparseMatrix<double > > solver(S);
@@ -1,6 +1,8 @@
 #include <igl/readOBJ.h>
 #include <igl/opengl/glfw/Viewer.h>
 #include <igl/exact_geodesic.h>
+#include <igl/heat_geodesics.h>
+#include <igl/get_seconds.h>
 #include <igl/colormap.h>
 #include <igl/unproject_onto_mesh.h>
 #include <iostream>
@@ -16,18 +18,38 @@ int main(int argc, char *argv[])
   igl::opengl::glfw::Viewer viewer;
   // Load a mesh in OFF format
   igl::readOBJ(TUTORIAL_SHARED_PATH "/armadillo.obj", V, F);
+  // Precompute the heat method's factorizations once; each query is then a
+  // few back-substitutions
+  igl::heat_geodesics_data<double> heat_data;
+  if(!igl::heat_geodesics_precompute(V,F,heat_data))
+  {
+    std::cerr<<"Error: heat_geodesics_precompute failed."<<std::endl;
+    return EXIT_FAILURE;
+  }
+  bool use_exact = false;
+  int last_vid = 0;
 
   const auto update_distance = [&](const int vid)
   {
+    last_vid = vid;
     Eigen::VectorXi VS,FS,VT,FT;
     // The selected vertex is the source
     VS.resize(1);
     VS << vid;
-    // All vertices are the targets
-    VT.setLinSpaced(V.rows(),0,V.rows()-1);
     Eigen::VectorXd d;
-    std::cout<<"Computing geodesic distance to vertex "<<vid<<"..."<<std::endl;
-    igl::exact_geodesic(V,F,VS,FS,VT,FT,d);
+    std::cout<<"Computing "<<(use_exact?"exact":"heat method")<<
+      " geodesic distance to vertex "<<vid<<"..."<<std::endl;
+    const double t = igl::get_seconds();
+    if(use_exact)
+    {
+      // All vertices are the targets
+      VT.setLinSpaced(V.rows(),0,V.rows()-1);
+      igl::exact_geodesic(V,F,VS,FS,VT,FT,d);
+    }else
+    {
+      igl::heat_geodesics_solve(heat_data,VS,d);
+    }
+    std::cout<<"  "<<igl::get_seconds()-t<<" seconds"<<std::endl;
     const double strip_size = 0.05;
     // The function should be 1 on each integer coordinate
     d = (d/strip_size*M_PI).array().sin().abs().eval();
@@ -66,9 +88,22 @@ int main(int argc, char *argv[])
     }
     return false;
   };
+  viewer.callback_key_pressed =
+    [&](igl::opengl::glfw::Viewer& /*viewer*/, unsigned int key, int)->bool
+  {
+    if(key == ' ')
+    {
+      use_exact = !use_exact;
+      update_distance(last_vid);
+      return true;
+    }
+    return false;
+  };
   viewer.data().set_mesh(V,F);
 
-  cout << "Click on mesh to define new source.\n" << std::endl;
+  cout << "Click on mesh to define new source.\n" <<
+    "Press [space] to toggle between the heat method and exact geodesics.\n" <<
+    std::endl;
   update_distance(0);
   return viewer.launch();
 }